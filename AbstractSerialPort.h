@@ -0,0 +1,36 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef ABSTRACTSERIALPORT_H
+#define ABSTRACTSERIALPORT_H
+
+#include <QtCore/QByteArray>
+
+// Minimal byte-stream interface of an open serial port, so that protocol
+// code does not depend on how the bytes reach the device.
+class AbstractSerialPort {
+public:
+    virtual ~AbstractSerialPort() = default;
+
+    virtual bool isOpen() const = 0;
+
+    // Returns an empty array on timeout or error
+    virtual QByteArray readData(int maxLength = 1024, int timeoutMs = 1000) = 0;
+
+    virtual bool writeData(const QByteArray &data, int timeoutMs = 1000) = 0;
+
+    virtual int baudRate() const = 0;
+
+    // Changes the line rate of the open port, keeping 8N1 framing
+    virtual bool setBaudRate(int baudRate) = 0;
+
+    // Discards data held in the adapter's receive and/or transmit buffers.
+    // Returns false if the port cannot do that.
+    virtual bool purgeBuffers(bool purgeReadBuffers = true, bool purgeWriteBuffers = true)
+    {
+        Q_UNUSED(purgeReadBuffers);
+        Q_UNUSED(purgeWriteBuffers);
+        return false;
+    }
+};
+
+#endif // ABSTRACTSERIALPORT_H
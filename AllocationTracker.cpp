@@ -0,0 +1,241 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#include "AllocationTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+struct StageCounters {
+    std::atomic<qint64> scopes { 0 };
+    std::atomic<qint64> allocations { 0 };
+    std::atomic<qint64> allocatedBytes { 0 };
+    std::atomic<qint64> deallocations { 0 };
+    std::atomic<qint64> maxAllocationsPerScope { 0 };
+};
+
+StageCounters stageCounters[int(AllocationTracker::Stage::Count)];
+
+} // namespace
+
+AllocationTracker::Stats AllocationTracker::stats(Stage stage)
+{
+    const StageCounters &counters = stageCounters[int(stage)];
+
+    Stats stats;
+    stats.scopes = counters.scopes.load(std::memory_order_relaxed);
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+    stats.allocatedBytes = counters.allocatedBytes.load(std::memory_order_relaxed);
+    stats.deallocations = counters.deallocations.load(std::memory_order_relaxed);
+    stats.maxAllocationsPerScope = counters.maxAllocationsPerScope.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void AllocationTracker::reset()
+{
+    for (StageCounters &counters : stageCounters) {
+        counters.scopes.store(0, std::memory_order_relaxed);
+        counters.allocations.store(0, std::memory_order_relaxed);
+        counters.allocatedBytes.store(0, std::memory_order_relaxed);
+        counters.deallocations.store(0, std::memory_order_relaxed);
+        counters.maxAllocationsPerScope.store(0, std::memory_order_relaxed);
+    }
+}
+
+#ifdef QTJENNY_ALLOCATION_TRACKER
+
+namespace {
+
+// Trivially initialized, so that the allocation functions can use it on any
+// thread without running a constructor first
+thread_local AllocationTracker::Scope *currentScope = nullptr;
+
+} // namespace
+
+AllocationTracker::Scope::Scope(Stage stage) : m_stage(stage), m_outer(currentScope)
+{
+    currentScope = this;
+}
+
+AllocationTracker::Scope::~Scope()
+{
+    currentScope = m_outer;
+
+    // Only this scope's own allocations go to its stage; the outer scope
+    // learns the total for its allocations()
+    if (m_outer)
+        m_outer->m_nestedAllocations += allocations();
+
+    StageCounters &counters = stageCounters[int(m_stage)];
+    counters.scopes.fetch_add(1, std::memory_order_relaxed);
+    counters.allocations.fetch_add(m_allocations, std::memory_order_relaxed);
+    counters.allocatedBytes.fetch_add(m_allocatedBytes, std::memory_order_relaxed);
+    counters.deallocations.fetch_add(m_deallocations, std::memory_order_relaxed);
+
+    qint64 max = counters.maxAllocationsPerScope.load(std::memory_order_relaxed);
+    while (m_allocations > max
+           && !counters.maxAllocationsPerScope.compare_exchange_weak(
+                   max, m_allocations, std::memory_order_relaxed)) {
+    }
+}
+
+void AllocationTracker::recordAllocation(std::size_t size)
+{
+    if (Scope *scope = currentScope) {
+        scope->m_allocations++;
+        scope->m_allocatedBytes += qint64(size);
+    }
+}
+
+void AllocationTracker::recordDeallocation()
+{
+    if (Scope *scope = currentScope)
+        scope->m_deallocations++;
+}
+
+#if defined(__GLIBC__)
+
+// glibc's own allocator, which the replacements below forward to
+extern "C" {
+void *__libc_malloc(std::size_t size) noexcept;
+void *__libc_calloc(std::size_t count, std::size_t size) noexcept;
+void *__libc_realloc(void *p, std::size_t size) noexcept;
+void __libc_free(void *p) noexcept;
+}
+
+// The app's definitions take precedence over the C library's for every
+// shared library, QtCore included. operator new allocates through malloc()
+// and needs no replacement. The aligned variants, memalign() and
+// posix_memalign(), are not counted; nothing in the I/O paths over-aligns.
+extern "C" void *malloc(std::size_t size) noexcept
+{
+    void *p = __libc_malloc(size);
+    if (p)
+        AllocationTracker::recordAllocation(size);
+    return p;
+}
+
+extern "C" void *calloc(std::size_t count, std::size_t size) noexcept
+{
+    void *p = __libc_calloc(count, size);
+    if (p)
+        AllocationTracker::recordAllocation(count * size);
+    return p;
+}
+
+// Growing or moving a block counts as freeing it and allocating a new one
+extern "C" void *realloc(void *p, std::size_t size) noexcept
+{
+    void *q = __libc_realloc(p, size);
+    if (p && (q || size == 0))
+        AllocationTracker::recordDeallocation();
+    if (q && size != 0)
+        AllocationTracker::recordAllocation(size);
+    return q;
+}
+
+extern "C" void free(void *p) noexcept
+{
+    if (p)
+        AllocationTracker::recordDeallocation();
+    __libc_free(p);
+}
+
+#else
+
+namespace {
+
+void *allocate(std::size_t size)
+{
+    if (size == 0)
+        size = 1;
+
+    for (;;) {
+        if (void *p = std::malloc(size)) {
+            AllocationTracker::recordAllocation(size);
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void *allocate(std::size_t size, const std::nothrow_t &) noexcept
+{
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void deallocate(void *p) noexcept
+{
+    if (!p)
+        return;
+    AllocationTracker::recordDeallocation();
+    std::free(p);
+}
+
+} // namespace
+
+// The replaceable global allocation functions. The aligned variants are
+// left alone; nothing in the I/O paths over-aligns. Allocations with
+// malloc(), such as those of Qt's containers, are not seen.
+void *operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &tag) noexcept
+{
+    return allocate(size, tag);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept
+{
+    return allocate(size, tag);
+}
+
+void operator delete(void *p) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+    deallocate(p);
+}
+
+#endif // __GLIBC__
+
+#endif // QTJENNY_ALLOCATION_TRACKER
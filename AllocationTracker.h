@@ -0,0 +1,101 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <QtCore/QtGlobal>
+
+#include <cstddef>
+
+// Counts heap allocations of the serial I/O stages. Built with
+// QTJENNY_ALLOCATION_TRACKER, every allocation a thread makes while a Scope
+// is alive is charged to the innermost Scope's stage. Without it, Scope
+// compiles to nothing and all stats stay zero.
+//
+// With glibc, the tracker replaces malloc(), calloc(), realloc() and free(),
+// so it also sees the QByteArray, QString and QList growth inside QtCore.
+// Elsewhere, Android included, it can only replace the global operator new
+// and delete, and isComplete() is false: the counts are then a lower bound
+// and do not show that a stage does not allocate.
+class AllocationTracker
+{
+public:
+    enum class Stage {
+        Read = 0,
+        Write,
+        Parse,
+        Publish,
+        Count
+    };
+
+    struct Stats {
+        qint64 scopes = 0;
+        qint64 allocations = 0;
+        qint64 allocatedBytes = 0;
+        qint64 deallocations = 0;
+        qint64 maxAllocationsPerScope = 0;
+    };
+
+    static constexpr bool isEnabled()
+    {
+#ifdef QTJENNY_ALLOCATION_TRACKER
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Whether malloc() is counted too, and with it Qt's containers
+    static constexpr bool isComplete()
+    {
+#if defined(QTJENNY_ALLOCATION_TRACKER) && defined(__GLIBC__)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static Stats stats(Stage stage);
+    static void reset();
+
+#ifdef QTJENNY_ALLOCATION_TRACKER
+    class Scope
+    {
+    public:
+        explicit Scope(Stage stage);
+        ~Scope();
+
+        // Allocations of this thread since the scope was entered, nested
+        // scopes included
+        qint64 allocations() const { return m_allocations + m_nestedAllocations; }
+
+    private:
+        Q_DISABLE_COPY_MOVE(Scope)
+        friend class AllocationTracker;
+
+        const Stage m_stage;
+        Scope *const m_outer;
+        qint64 m_allocations = 0;
+        qint64 m_allocatedBytes = 0;
+        qint64 m_deallocations = 0;
+        qint64 m_nestedAllocations = 0;
+    };
+
+    // Called by the replaced allocation functions
+    static void recordAllocation(std::size_t size);
+    static void recordDeallocation();
+#else
+    class Scope
+    {
+    public:
+        explicit Scope(Stage) {}
+
+        qint64 allocations() const { return 0; }
+
+    private:
+        Q_DISABLE_COPY_MOVE(Scope)
+    };
+#endif
+};
+
+#endif // ALLOCATIONTRACKER_H
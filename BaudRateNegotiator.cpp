@@ -0,0 +1,106 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "BaudRateNegotiator.h"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QDebug>
+
+BaudRateNegotiator::BaudRateNegotiator(AbstractSerialPort *port)
+    : m_port(port)
+{
+}
+
+void BaudRateNegotiator::setDrainTime(int timeoutMs)
+{
+    m_drainTimeMs = qMax(1, timeoutMs);
+}
+
+void BaudRateNegotiator::setProbeTimeout(int timeoutMs)
+{
+    m_probeTimeoutMs = qMax(1, timeoutMs);
+}
+
+void BaudRateNegotiator::setProbeAttempts(int attempts)
+{
+    m_probeAttempts = qMax(1, attempts);
+}
+
+bool BaudRateNegotiator::negotiate(const Request &request)
+{
+    const int previousBaudRate = m_port->baudRate();
+    if (request.baudRate == previousBaudRate)
+        return true;
+
+    // Any reply contains an empty one, so the switch could never fail
+    if (request.expectedReply.isEmpty()) {
+        qWarning() << "No expected reply to verify" << request.baudRate << "baud";
+        return false;
+    }
+
+    if (!m_port->writeData(request.switchCommand, m_probeTimeoutMs)) {
+        qWarning() << "Failed to send baud rate switch command";
+        return false;
+    }
+
+    // Whatever is still on its way, including the device's acknowledgement
+    // at the old rate, would be garbage once the rate changes. A device
+    // that keeps talking, like an NMEA source, never lets that settle.
+    // Either way the device may already have taken the switch command.
+    if (!drain()) {
+        qWarning() << "Line does not go quiet, not switching to" << request.baudRate << "baud";
+    } else if (m_port->setBaudRate(request.baudRate)
+               && probe(request.probe, request.expectedReply)) {
+        qDebug() << "Switched from" << previousBaudRate << "to" << request.baudRate << "baud";
+        return true;
+    } else {
+        qWarning() << "Could not verify" << request.baudRate << "baud, falling back to"
+                   << previousBaudRate;
+    }
+
+    if (!request.revertCommand.isEmpty() && m_port->setBaudRate(request.baudRate)) {
+        m_port->writeData(request.revertCommand, m_probeTimeoutMs);
+        drain();
+    }
+
+    if (!m_port->setBaudRate(previousBaudRate))
+        return false;
+    drain();
+
+    if (!probe(request.probe, request.expectedReply))
+        qWarning() << "Device does not answer at" << previousBaudRate << "baud either";
+    return false;
+}
+
+// Returns false if the line is still busy after maxDrainMs or maxDrainBytes
+bool BaudRateNegotiator::drain()
+{
+    const QDeadlineTimer deadline(maxDrainMs);
+    qsizetype drained = 0;
+    for (;;) {
+        const QByteArray data = m_port->readData(drainChunkSize, m_drainTimeMs);
+        if (data.isEmpty())
+            return true;
+        drained += data.size();
+        if (drained > maxDrainBytes || deadline.hasExpired())
+            return false;
+    }
+}
+
+bool BaudRateNegotiator::probe(const QByteArray &probe, const QByteArray &expectedReply)
+{
+    for (int attempt = 0; attempt < m_probeAttempts; attempt++) {
+        if (!m_port->writeData(probe, m_probeTimeoutMs))
+            return false;
+
+        QByteArray reply;
+        const QDeadlineTimer deadline(m_probeTimeoutMs);
+        while (!deadline.hasExpired()) {
+            reply.append(m_port->readData(drainChunkSize,
+                                          int(qMax<qint64>(1, deadline.remainingTime()))));
+            if (reply.contains(expectedReply))
+                return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,62 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef BAUDRATENEGOTIATOR_H
+#define BAUDRATENEGOTIATOR_H
+
+#include <QtCore/QByteArray>
+
+#include "AbstractSerialPort.h"
+
+// Switches an open port and the device behind it to a different line rate
+// in the middle of a session, e.g. to run a bulk download at a multiple of
+// the default rate and drop back afterwards.
+class BaudRateNegotiator {
+public:
+    struct Request {
+        int baudRate = 0;
+        // Device command that selects the new rate, sent at the current rate
+        QByteArray switchCommand;
+        // Exchange that proves the link works at the new rate. The switch
+        // counts as verified once expectedReply, which must not be empty,
+        // shows up in the answer.
+        QByteArray probe;
+        QByteArray expectedReply;
+        // Optional command, sent at the new rate, that returns the device
+        // to the previous rate if verification fails
+        QByteArray revertCommand;
+    };
+
+    explicit BaudRateNegotiator(AbstractSerialPort *port);
+
+    // Quiet time on the line after which in-flight data counts as drained.
+    // A line that does not go quiet within maxDrainMs, or keeps sending more
+    // than maxDrainBytes, fails the negotiation.
+    int drainTime() const { return m_drainTimeMs; }
+    void setDrainTime(int timeoutMs);
+
+    int probeTimeout() const { return m_probeTimeoutMs; }
+    void setProbeTimeout(int timeoutMs);
+
+    int probeAttempts() const { return m_probeAttempts; }
+    void setProbeAttempts(int attempts);
+
+    // Returns true if both sides now run at request.baudRate. On failure
+    // the port is back at the rate it had before, and revertCommand, if
+    // set, has been sent at the new rate.
+    bool negotiate(const Request &request);
+
+private:
+    static constexpr int drainChunkSize = 1024;
+    static constexpr int maxDrainMs = 1000;
+    static constexpr qsizetype maxDrainBytes = 16 * 1024;
+
+    bool drain();
+    bool probe(const QByteArray &probe, const QByteArray &expectedReply);
+
+    AbstractSerialPort *m_port;
+    int m_drainTimeMs = 50;
+    int m_probeTimeoutMs = 300;
+    int m_probeAttempts = 3;
+};
+
+#endif // BAUDRATENEGOTIATOR_H
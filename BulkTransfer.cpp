@@ -0,0 +1,157 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "BulkTransfer.h"
+
+#include <QtCore/QDebug>
+
+BulkTransfer::BulkTransfer(const BlockProtocol *protocol, QObject *parent)
+    : QObject{ parent }, m_protocol(protocol)
+{
+}
+
+void BulkTransfer::setWindowSize(int blocks)
+{
+    m_windowSize = qMax(1, blocks);
+}
+
+void BulkTransfer::setBlockTimeout(int timeoutMs)
+{
+    m_blockTimeoutMs = qMax(1, timeoutMs);
+}
+
+void BulkTransfer::setMaxRetries(int retries)
+{
+    m_maxRetries = qMax(0, retries);
+}
+
+void BulkTransfer::setNextBlock(quint32 block)
+{
+    m_nextBlock = block;
+    while (!m_received.isEmpty() && m_received.firstKey() < block)
+        m_received.erase(m_received.begin());
+}
+
+void BulkTransfer::cancel()
+{
+    m_cancelled.store(true, std::memory_order_relaxed);
+}
+
+BulkTransfer::Result BulkTransfer::run(AbstractSerialPort *port, QIODevice *output,
+                                       quint32 blockCount)
+{
+    m_cancelled.store(false, std::memory_order_relaxed);
+    m_stats = Stats();
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    // Without any reply for this long, the device or the cable is gone.
+    // It is twice the time a block takes to run out of retries, so that a
+    // device that drops one block is reported as Failed, not Disconnected.
+    const int silenceTimeoutMs = 2 * m_blockTimeoutMs * (m_maxRetries + 1);
+    QElapsedTimer lastReply;
+    lastReply.start();
+
+    QHash<quint32, Request> outstanding;
+    QByteArray buffer;
+    quint32 nextRequest = m_nextBlock;
+
+    const auto finish = [&](Result result) {
+        m_stats.elapsedMs = elapsed.elapsed();
+        return result;
+    };
+
+    if (!flush(output, blockCount))
+        return finish(Result::Failed);
+
+    while (m_nextBlock < blockCount) {
+        if (m_cancelled.load(std::memory_order_relaxed))
+            return finish(Result::Cancelled);
+
+        if (!port->isOpen() || lastReply.hasExpired(silenceTimeoutMs)) {
+            qWarning() << "Bulk transfer interrupted at block" << m_nextBlock;
+            return finish(Result::Disconnected);
+        }
+
+        // Keep the window full. Requests never run further ahead of the
+        // output than the window, which also bounds the reassembly buffer.
+        nextRequest = qMax(nextRequest, m_nextBlock);
+        while (nextRequest < blockCount
+               && nextRequest - m_nextBlock < quint32(m_windowSize)) {
+            if (!m_received.contains(nextRequest) && !outstanding.contains(nextRequest)) {
+                if (!sendRequest(port, nextRequest, outstanding[nextRequest]))
+                    return finish(Result::Disconnected);
+            }
+            nextRequest++;
+        }
+
+        // Ask again for blocks whose reply got lost or was corrupt
+        for (auto it = outstanding.begin(); it != outstanding.end(); ++it) {
+            if (!it->sent.hasExpired(m_blockTimeoutMs))
+                continue;
+            if (it->attempts > m_maxRetries) {
+                qWarning() << "Block" << it.key() << "not received after"
+                           << it->attempts << "attempts";
+                return finish(Result::Failed);
+            }
+            m_stats.retransmits++;
+            if (!sendRequest(port, it.key(), *it))
+                return finish(Result::Disconnected);
+        }
+
+        const QByteArray data = port->readData(readChunkSize, readPollMs);
+        if (data.isEmpty())
+            continue;
+        buffer.append(data);
+
+        BlockProtocol::Block block;
+        for (;;) {
+            const BlockProtocol::ParseStatus status = m_protocol->parse(buffer, block);
+            if (status == BlockProtocol::ParseStatus::NeedMoreData)
+                break;
+            if (status == BlockProtocol::ParseStatus::Corrupt) {
+                m_stats.corruptReplies++;
+                continue;
+            }
+
+            lastReply.start();
+            outstanding.remove(block.index);
+            if (block.index >= m_nextBlock && block.index < blockCount)
+                m_received.insert(block.index, std::move(block.payload));
+        }
+
+        if (!flush(output, blockCount))
+            return finish(Result::Failed);
+    }
+
+    return finish(Result::Completed);
+}
+
+bool BulkTransfer::sendRequest(AbstractSerialPort *port, quint32 index, Request &request)
+{
+    request.sent.start();
+    request.attempts++;
+    m_stats.requests++;
+    return port->writeData(m_protocol->blockRequest(index), m_blockTimeoutMs);
+}
+
+// Writes the contiguous run of received blocks that starts at m_nextBlock
+bool BulkTransfer::flush(QIODevice *output, quint32 blockCount)
+{
+    bool advanced = false;
+    for (auto it = m_received.begin(); it != m_received.end() && it.key() == m_nextBlock;
+         it = m_received.erase(it)) {
+        if (output->write(it.value()) != it.value().size()) {
+            qWarning() << "Failed to write block" << m_nextBlock << ":" << output->errorString();
+            return false;
+        }
+        m_stats.bytesWritten += it.value().size();
+        m_nextBlock++;
+        advanced = true;
+    }
+
+    if (advanced)
+        emit progress(m_nextBlock, blockCount);
+    return true;
+}
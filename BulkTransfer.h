@@ -0,0 +1,121 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef BULKTRANSFER_H
+#define BULKTRANSFER_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QIODevice>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+
+#include <atomic>
+
+#include "AbstractSerialPort.h"
+
+// Device specific part of a block-oriented download, e.g. the IGC log
+// transfer of a flight recorder.
+class BlockProtocol {
+public:
+    enum class ParseStatus {
+        NeedMoreData,
+        Block,
+        Corrupt
+    };
+
+    struct Block {
+        quint32 index = 0;
+        QByteArray payload;
+    };
+
+    virtual ~BlockProtocol() = default;
+
+    // Command that asks the device for block \a index
+    virtual QByteArray blockRequest(quint32 index) const = 0;
+
+    // Removes at most one reply from the front of \a buffer. Returns Block
+    // and fills \a block if a valid reply was found, Corrupt if bytes were
+    // discarded, and NeedMoreData if the buffer holds no complete reply.
+    virtual ParseStatus parse(QByteArray &buffer, Block &block) const = 0;
+};
+
+// Downloads blocks over an open port with a sliding window of outstanding
+// requests instead of stop-and-wait round trips. Replies may arrive out of
+// order; they are reassembled and streamed to the output in block order.
+// If the port goes away, run() returns Disconnected and a later run() on
+// the reopened port resumes from nextBlock().
+class BulkTransfer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Result {
+        Completed,
+        Disconnected,
+        Failed,
+        Cancelled
+    };
+
+    struct Stats {
+        qint64 bytesWritten = 0;
+        qint64 elapsedMs = 0;
+        int requests = 0;
+        int retransmits = 0;
+        int corruptReplies = 0;
+    };
+
+    explicit BulkTransfer(const BlockProtocol *protocol, QObject *parent = nullptr);
+
+    int windowSize() const { return m_windowSize; }
+    void setWindowSize(int blocks);
+
+    int blockTimeout() const { return m_blockTimeoutMs; }
+    void setBlockTimeout(int timeoutMs);
+
+    int maxRetries() const { return m_maxRetries; }
+    void setMaxRetries(int retries);
+
+    // First block that has not been written to the output yet. Set it
+    // before run() to continue a download from a partially written file.
+    quint32 nextBlock() const { return m_nextBlock; }
+    void setNextBlock(quint32 block);
+
+    // Blocking; call it from a worker thread. Appends blocks nextBlock()
+    // up to \a blockCount - 1 to \a output.
+    Result run(AbstractSerialPort *port, QIODevice *output, quint32 blockCount);
+
+    // Thread-safe; makes a running run() return Cancelled
+    void cancel();
+
+    Stats stats() const { return m_stats; }
+
+signals:
+    void progress(quint32 blocksWritten, quint32 blockCount);
+
+private:
+    struct Request {
+        QElapsedTimer sent;
+        int attempts = 0;
+    };
+
+    static constexpr int readChunkSize = 4096;
+    static constexpr int readPollMs = 10;
+
+    bool sendRequest(AbstractSerialPort *port, quint32 index, Request &request);
+    bool flush(QIODevice *output, quint32 blockCount);
+
+    const BlockProtocol *m_protocol;
+    int m_windowSize = 8;
+    int m_blockTimeoutMs = 500;
+    int m_maxRetries = 5;
+
+    quint32 m_nextBlock = 0;
+    // Blocks received ahead of m_nextBlock; kept across a disconnect so
+    // that they need not be fetched again.
+    QMap<quint32, QByteArray> m_received;
+    std::atomic<bool> m_cancelled { false };
+    Stats m_stats;
+};
+
+#endif // BULKTRANSFER_H
@@ -0,0 +1,54 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "ChunkPool.h"
+
+ChunkPool::ChunkPool(int preallocated, int maxChunks)
+    : m_maxChunks(qMax(preallocated, maxChunks))
+{
+    m_chunks.reserve(std::size_t(preallocated));
+    m_free.reserve(std::size_t(preallocated));
+    for (int i = 0; i < preallocated; i++)
+        m_free.push_back(allocate());
+}
+
+ChunkPool::Chunk *ChunkPool::acquire()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_free.empty())
+        return int(m_chunks.size()) < m_maxChunks ? allocate() : nullptr;
+
+    Chunk *chunk = m_free.back();
+    m_free.pop_back();
+    chunk->size = 0;
+    return chunk;
+}
+
+void ChunkPool::release(Chunk *chunk)
+{
+    QMutexLocker locker(&m_mutex);
+    m_free.push_back(chunk);
+}
+
+int ChunkPool::allocatedChunks() const
+{
+    QMutexLocker locker(&m_mutex);
+    return int(m_chunks.size());
+}
+
+std::vector<ChunkPool::Chunk *> ChunkPool::chunks() const
+{
+    QMutexLocker locker(&m_mutex);
+    std::vector<Chunk *> result;
+    result.reserve(m_chunks.size());
+    for (const auto &chunk : m_chunks)
+        result.push_back(chunk.get());
+    return result;
+}
+
+ChunkPool::Chunk *ChunkPool::allocate()
+{
+    m_chunks.push_back(std::make_unique<Chunk>());
+    m_chunks.back()->index = int(m_chunks.size()) - 1;
+    return m_chunks.back().get();
+}
@@ -0,0 +1,49 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef CHUNKPOOL_H
+#define CHUNKPOOL_H
+
+#include <QtCore/QMutex>
+
+#include <memory>
+#include <vector>
+
+// Fixed-size receive buffers that are recycled instead of allocated per
+// read. The pool grows on demand up to maxChunks and never shrinks.
+class ChunkPool {
+public:
+    static constexpr qsizetype chunkCapacity = 4096;
+
+    struct Chunk {
+        // Position in allocation order, stable for the pool's lifetime
+        int index = 0;
+        qsizetype size = 0;
+        char data[chunkCapacity];
+    };
+
+    explicit ChunkPool(int preallocated = 64, int maxChunks = 1024);
+
+    ChunkPool(const ChunkPool &) = delete;
+    ChunkPool &operator=(const ChunkPool &) = delete;
+
+    // Returns nullptr once maxChunks are allocated and none is free
+    Chunk *acquire();
+    void release(Chunk *chunk);
+
+    int allocatedChunks() const;
+
+    // Allocated chunks in allocation order, e.g. for registering them with
+    // the kernel. Chunks allocated later are not part of the result.
+    std::vector<Chunk *> chunks() const;
+
+private:
+    Chunk *allocate();
+
+    const int m_maxChunks;
+
+    mutable QMutex m_mutex;
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    std::vector<Chunk *> m_free;
+};
+
+#endif // CHUNKPOOL_H
@@ -0,0 +1,166 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "EpollReactor.h"
+
+#include <QtCore/QDebug>
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+EpollReactor::EpollReactor(bool edgeTriggered)
+    : IoReactor("EpollReactor")
+    , m_edgeTriggered(edgeTriggered)
+{
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (!isValid()) {
+        qWarning() << "Failed to set up epoll:" << strerror(errno);
+        return;
+    }
+
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = m_wakeFd;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &event);
+}
+
+EpollReactor::~EpollReactor()
+{
+    stop();
+    if (m_wakeFd >= 0)
+        ::close(m_wakeFd);
+    if (m_epollFd >= 0)
+        ::close(m_epollFd);
+}
+
+bool EpollReactor::add(int fd, ReadHandler onRead, ErrorHandler onError)
+{
+    if (!isValid())
+        return false;
+
+    auto registration = std::make_shared<Registration>(
+        Registration { fd, std::move(onRead), std::move(onError) });
+    {
+        QMutexLocker locker(&m_mutex);
+        m_registrations.insert(fd, registration);
+    }
+
+    epoll_event event {};
+    event.events = EPOLLIN | EPOLLRDHUP | (m_edgeTriggered ? EPOLLET : 0);
+    event.data.fd = fd;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        qWarning() << "Failed to watch fd" << fd << ":" << strerror(errno);
+        QMutexLocker locker(&m_mutex);
+        m_registrations.remove(fd);
+        return false;
+    }
+    return true;
+}
+
+void EpollReactor::remove(int fd)
+{
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_registrations.remove(fd);
+    }
+
+    // Wait for a dispatch that may already hold the registration
+    if (isRunning() && !isReactorThread()) {
+        m_dispatchMutex.lock();
+        m_dispatchMutex.unlock();
+    }
+}
+
+void EpollReactor::wake()
+{
+    const quint64 one = 1;
+    [[maybe_unused]] const ssize_t written = ::write(m_wakeFd, &one, sizeof(one));
+}
+
+void EpollReactor::run()
+{
+    epoll_event events[maxEvents];
+
+    while (!stopping()) {
+        const int count = epoll_wait(m_epollFd, events, maxEvents, -1);
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            qWarning() << "epoll_wait failed:" << strerror(errno);
+            return;
+        }
+
+        int syscalls = 1;
+        for (int i = 0; i < count; i++) {
+            if (events[i].data.fd == m_wakeFd) {
+                quint64 value;
+                [[maybe_unused]] const ssize_t bytes = ::read(m_wakeFd, &value, sizeof(value));
+                syscalls++;
+                continue;
+            }
+
+            QMutexLocker dispatchLocker(&m_dispatchMutex);
+            std::shared_ptr<Registration> registration;
+            {
+                QMutexLocker locker(&m_mutex);
+                registration = m_registrations.value(events[i].data.fd);
+            }
+            if (registration)
+                syscalls += dispatch(registration, events[i].events);
+        }
+        countWakeup(count, syscalls);
+    }
+}
+
+int EpollReactor::dispatch(const std::shared_ptr<Registration> &registration, quint32 events)
+{
+    int reads = 0;
+    if (events & EPOLLIN) {
+        for (;;) {
+            ChunkPool::Chunk *chunk = acquireChunk();
+            const ssize_t bytes = ::read(registration->fd, chunk->data, ChunkPool::chunkCapacity);
+            countRead(bytes);
+            reads++;
+
+            if (bytes > 0) {
+                if (isDiscardChunk(chunk)) {
+                    countDropped(bytes);
+                } else {
+                    chunk->size = bytes;
+                    registration->onRead(chunk);
+                }
+                if (!m_edgeTriggered)
+                    break;
+                continue;
+            }
+
+            releaseChunk(chunk);
+            if (bytes < 0 && errno == EINTR)
+                continue;
+            if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+
+            // 0 is end of file: the tty has gone away
+            return reads + fail(registration, bytes == 0 ? 0 : errno);
+        }
+    }
+
+    if (events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP))
+        return reads + fail(registration, 0);
+    return reads;
+}
+
+int EpollReactor::fail(const std::shared_ptr<Registration> &registration, int error)
+{
+    // A hangup stays signalled until the fd is closed, and level-triggered
+    // epoll would report it on every wait until the owner calls remove()
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, registration->fd, nullptr);
+    registration->onError(error);
+    return 1;
+}
@@ -0,0 +1,52 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef EPOLLREACTOR_H
+#define EPOLLREACTOR_H
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+
+#include "IoReactor.h"
+
+// Reactor on epoll. In edge-triggered mode (the default) a ready fd is
+// read until it would block, so everything that arrived since the last
+// wakeup is handled in one batch. Level-triggered mode reads one chunk
+// per wakeup.
+class EpollReactor : public IoReactor {
+public:
+    explicit EpollReactor(bool edgeTriggered = true);
+    ~EpollReactor() override;
+
+    bool isValid() const override { return m_epollFd >= 0 && m_wakeFd >= 0; }
+
+    bool add(int fd, ReadHandler onRead, ErrorHandler onError) override;
+    void remove(int fd) override;
+
+protected:
+    void run() override;
+    void wake() override;
+
+private:
+    struct Registration {
+        int fd;
+        ReadHandler onRead;
+        ErrorHandler onError;
+    };
+
+    static constexpr int maxEvents = 64;
+
+    // Both return the number of syscalls made
+    int dispatch(const std::shared_ptr<Registration> &registration, quint32 events);
+    // Stops watching the fd before reporting the error to its owner
+    int fail(const std::shared_ptr<Registration> &registration, int error);
+
+    const bool m_edgeTriggered;
+    int m_epollFd = -1;
+    int m_wakeFd = -1;
+
+    QMutex m_mutex;
+    QMutex m_dispatchMutex;
+    QHash<int, std::shared_ptr<Registration>> m_registrations;
+};
+
+#endif // EPOLLREACTOR_H
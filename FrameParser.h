@@ -0,0 +1,28 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef FRAMEPARSER_H
+#define FRAMEPARSER_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QList>
+
+struct SerialFrame {
+    QByteArray data;
+    // Steady clock time in nanoseconds at which the chunk holding the
+    // start of the frame was read from the port
+    qint64 receivedNs = 0;
+};
+
+// Splits a byte stream into frames. A parser keeps the state of partial
+// frames between calls, so one instance must only be fed one stream.
+class FrameParser {
+public:
+    virtual ~FrameParser() = default;
+
+    // Appends the frames completed by \a data to \a frames and returns the
+    // number of frames dropped because of a bad checksum
+    virtual int parse(QByteArrayView data, qint64 receivedNs, QList<SerialFrame> &frames) = 0;
+};
+
+#endif // FRAMEPARSER_H
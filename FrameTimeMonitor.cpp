@@ -0,0 +1,66 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#include "FrameTimeMonitor.h"
+
+#include <QtCore/QDebug>
+#include <QtQuick/QQuickWindow>
+
+FrameTimeMonitor::FrameTimeMonitor(QObject *parent) : QObject(parent)
+{
+    m_clock.start();
+}
+
+void FrameTimeMonitor::attach(QQuickWindow *window)
+{
+    detach();
+    if (!window)
+        return;
+
+    // frameSwapped is emitted on the render thread with the threaded render
+    // loop, so the slot runs there and the statistics are guarded
+    m_connection = connect(window, &QQuickWindow::frameSwapped, this,
+                           &FrameTimeMonitor::frameSwapped, Qt::DirectConnection);
+}
+
+void FrameTimeMonitor::detach()
+{
+    if (m_connection)
+        disconnect(m_connection);
+
+    QMutexLocker locker(&m_mutex);
+    m_lastFrameUs = -1;
+    m_stats = Stats();
+}
+
+FrameTimeMonitor::Stats FrameTimeMonitor::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+void FrameTimeMonitor::frameSwapped()
+{
+    const qint64 nowUs = m_clock.nsecsElapsed() / 1000;
+
+    QMutexLocker locker(&m_mutex);
+    const qint64 intervalUs = m_lastFrameUs < 0 ? -1 : nowUs - m_lastFrameUs;
+    m_lastFrameUs = nowUs;
+    if (intervalUs < 0 || intervalUs > idleGapUs)
+        return;
+
+    m_stats.frames++;
+    m_stats.totalUs += intervalUs;
+    m_stats.maxUs = qMax(m_stats.maxUs, intervalUs);
+    if (intervalUs > m_slowFrameUs)
+        m_stats.slowFrames++;
+
+    if (nowUs - m_lastReportUs < reportIntervalMs * 1000)
+        return;
+
+    qInfo().nospace() << "Frames: " << m_stats.frames << ", average "
+                      << m_stats.totalUs / 1000.0 / m_stats.frames << " ms, max "
+                      << m_stats.maxUs / 1000.0 << " ms, " << m_stats.slowFrames
+                      << " over " << m_slowFrameUs / 1000 << " ms";
+    m_lastReportUs = nowUs;
+    m_stats = Stats();
+}
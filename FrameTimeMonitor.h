@@ -0,0 +1,57 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef FRAMETIMEMONITOR_H
+#define FRAMETIMEMONITOR_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+
+class QQuickWindow;
+
+// Measures the interval between presented frames of a window and logs a
+// summary every few seconds. A GUI thread that blocks while something
+// animates delays the next frame, so the maximum and the number of slow
+// frames show how much synchronous work on that thread costs.
+class FrameTimeMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Stats {
+        quint64 frames = 0;
+        quint64 slowFrames = 0;
+        qint64 totalUs = 0;
+        qint64 maxUs = 0;
+    };
+
+    explicit FrameTimeMonitor(QObject *parent = nullptr);
+
+    void attach(QQuickWindow *window);
+    void detach();
+
+    // Frames taking longer than this count as slow, in milliseconds
+    void setSlowFrameThreshold(int thresholdMs) { m_slowFrameUs = thresholdMs * 1000; }
+
+    // Statistics since the last report
+    Stats stats() const;
+
+private:
+    static constexpr int reportIntervalMs = 5000;
+    // Longer gaps mean nothing was animating and are not counted as frames
+    static constexpr qint64 idleGapUs = 500000;
+
+    // Called on the render thread
+    void frameSwapped();
+
+    QMetaObject::Connection m_connection;
+
+    mutable QMutex m_mutex;
+    QElapsedTimer m_clock;
+    qint64 m_lastFrameUs = -1;
+    qint64 m_lastReportUs = 0;
+    qint64 m_slowFrameUs = 33000;
+    Stats m_stats;
+};
+
+#endif // FRAMETIMEMONITOR_H
@@ -0,0 +1,120 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "FtdiPackets.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// Line status bits
+constexpr quint8 overrunError = 0x02;
+constexpr quint8 parityError = 0x04;
+constexpr quint8 framingError = 0x08;
+constexpr quint8 breakInterrupt = 0x10;
+
+constexpr qsizetype fullSpeedPacketSize = 64;
+
+// Line status errors are counted in locals: data may alias the caller's
+// LineStatus, which would otherwise be written back and reloaded for
+// every packet
+struct Counters {
+    int packets = 0;
+    int overruns = 0;
+    int parityErrors = 0;
+    int framingErrors = 0;
+    int breaks = 0;
+    quint8 modemStatus = 0;
+
+    void count(const char *header)
+    {
+        const quint8 lineStatus = quint8(header[1]);
+        modemStatus = quint8(header[0]);
+        packets++;
+        overruns += (lineStatus & overrunError) ? 1 : 0;
+        parityErrors += (lineStatus & parityError) ? 1 : 0;
+        framingErrors += (lineStatus & framingError) ? 1 : 0;
+        breaks += (lineStatus & breakInterrupt) ? 1 : 0;
+    }
+};
+
+// The 62 byte payload of a full speed packet as four overlapping 16 byte
+// blocks. All are loaded before the first store, so the move is safe for
+// any overlap, and there is no call into memmove() per packet.
+inline void moveFullSpeedPayload(char *to, const char *from)
+{
+    constexpr qsizetype payload = fullSpeedPacketSize - FtdiPackets::statusSize;
+#if defined(__SSE2__)
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(from));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(from + 16));
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(from + 32));
+    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(from + payload - 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(to), a);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(to + 16), b);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(to + 32), c);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(to + payload - 16), d);
+#elif defined(__ARM_NEON)
+    const uint8x16_t a = vld1q_u8(reinterpret_cast<const uint8_t *>(from));
+    const uint8x16_t b = vld1q_u8(reinterpret_cast<const uint8_t *>(from + 16));
+    const uint8x16_t c = vld1q_u8(reinterpret_cast<const uint8_t *>(from + 32));
+    const uint8x16_t d = vld1q_u8(reinterpret_cast<const uint8_t *>(from + payload - 16));
+    vst1q_u8(reinterpret_cast<uint8_t *>(to), a);
+    vst1q_u8(reinterpret_cast<uint8_t *>(to + 16), b);
+    vst1q_u8(reinterpret_cast<uint8_t *>(to + 32), c);
+    vst1q_u8(reinterpret_cast<uint8_t *>(to + payload - 16), d);
+#else
+    std::memmove(to, from, payload);
+#endif
+}
+
+} // namespace
+
+// High speed payloads of 510 bytes and the short last packet go through
+// memmove(), which is already vectorized and wins at that size.
+qsizetype FtdiPackets::stripStatus(char *data, qsizetype length, int packetSize, LineStatus &status)
+{
+    if (packetSize <= statusSize)
+        return 0;
+
+    Counters counters;
+    counters.modemStatus = status.modemStatus;
+
+    const qsizetype payload = packetSize - statusSize;
+    qsizetype payloadLength = 0;
+    qsizetype packet = 0;
+    if (packetSize == fullSpeedPacketSize) {
+        for (; packet + fullSpeedPacketSize <= length; packet += fullSpeedPacketSize) {
+            counters.count(data + packet);
+            moveFullSpeedPayload(data + payloadLength, data + packet + statusSize);
+            payloadLength += payload;
+        }
+    } else {
+        for (; packet + packetSize <= length; packet += packetSize) {
+            counters.count(data + packet);
+            std::memmove(data + payloadLength, data + packet + statusSize, size_t(payload));
+            payloadLength += payload;
+        }
+    }
+
+    // A short packet ends the transfer
+    if (length - packet >= statusSize) {
+        const qsizetype tail = length - packet - statusSize;
+        counters.count(data + packet);
+        std::memmove(data + payloadLength, data + packet + statusSize, size_t(tail));
+        payloadLength += tail;
+    }
+
+    status.packets += counters.packets;
+    status.overruns += counters.overruns;
+    status.parityErrors += counters.parityErrors;
+    status.framingErrors += counters.framingErrors;
+    status.breaks += counters.breaks;
+    status.modemStatus = counters.modemStatus;
+    return payloadLength;
+}
@@ -0,0 +1,32 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef FTDIPACKETS_H
+#define FTDIPACKETS_H
+
+#include <QtCore/QtGlobal>
+
+// FTDI adapters start every packet on the bulk IN endpoint with a modem
+// status and a line status byte, also when there is no data at all.
+class FtdiPackets {
+public:
+    static constexpr int statusSize = 2;
+
+    // Line errors reported by the packets, and the last modem status
+    // (CTS 0x10, DSR 0x20, RI 0x40, DCD 0x80). modemStatus is only valid
+    // if packets, the number of status headers seen, is not 0.
+    struct LineStatus {
+        int packets = 0;
+        int overruns = 0;
+        int parityErrors = 0;
+        int framingErrors = 0;
+        int breaks = 0;
+        quint8 modemStatus = 0;
+    };
+
+    // Removes the status bytes from the consecutive packets in data, in
+    // place, and returns the remaining payload length. Only the last
+    // packet may be shorter than packetSize.
+    static qsizetype stripStatus(char *data, qsizetype length, int packetSize, LineStatus &status);
+};
+
+#endif // FTDIPACKETS_H
@@ -0,0 +1,122 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "IoReactor.h"
+
+#include <QtCore/QDebug>
+
+#include <ctime>
+
+#include "EpollReactor.h"
+#include "UringReactor.h"
+
+namespace {
+
+// Reading the thread CPU clock is a syscall, so it is not done per wakeup
+constexpr qint64 cpuSampleInterval = 256;
+
+} // namespace
+
+IoReactor::IoReactor(const char *name)
+    : m_name(name)
+{
+    m_discardChunk.index = -1;
+}
+
+IoReactor::~IoReactor() = default;
+
+std::unique_ptr<IoReactor> IoReactor::create(bool preferUring)
+{
+#if !defined(Q_OS_ANDROID)
+    // The app seccomp policy of Android kills the process on io_uring
+    // syscalls instead of failing them, so it is never probed there
+    if (preferUring) {
+        auto uring = std::make_unique<UringReactor>();
+        if (uring->isValid())
+            return uring;
+        qDebug() << "io_uring unavailable, falling back to epoll";
+    }
+#else
+    Q_UNUSED(preferUring);
+#endif
+    return std::make_unique<EpollReactor>();
+}
+
+void IoReactor::start()
+{
+    if (!isValid() || m_thread)
+        return;
+
+    m_stopping.store(false, std::memory_order_relaxed);
+    m_thread.reset(QThread::create([this]() {
+        run();
+        sampleCpuTime();
+    }));
+    m_thread->setObjectName(QString::fromLatin1(m_name));
+    m_thread->start(QThread::TimeCriticalPriority);
+}
+
+void IoReactor::stop()
+{
+    if (!m_thread)
+        return;
+
+    m_stopping.store(true, std::memory_order_relaxed);
+    wake();
+    m_thread->wait();
+    m_thread.reset();
+}
+
+IoReactor::Stats IoReactor::stats() const
+{
+    Stats stats;
+    stats.wakeups = m_wakeups.load(std::memory_order_relaxed);
+    stats.events = m_events.load(std::memory_order_relaxed);
+    stats.reads = m_reads.load(std::memory_order_relaxed);
+    stats.bytes = m_bytes.load(std::memory_order_relaxed);
+    stats.bytesDropped = m_bytesDropped.load(std::memory_order_relaxed);
+    stats.syscalls = m_syscalls.load(std::memory_order_relaxed);
+    stats.cpuTimeNs = m_cpuTimeNs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void IoReactor::countWakeup(int events, int syscalls)
+{
+    const qint64 wakeups = m_wakeups.fetch_add(1, std::memory_order_relaxed) + 1;
+    m_events.fetch_add(events, std::memory_order_relaxed);
+    m_syscalls.fetch_add(syscalls, std::memory_order_relaxed);
+    if (wakeups % cpuSampleInterval == 0)
+        sampleCpuTime();
+}
+
+void IoReactor::countRead(qint64 bytes)
+{
+    m_reads.fetch_add(1, std::memory_order_relaxed);
+    if (bytes > 0)
+        m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void IoReactor::countDropped(qint64 bytes)
+{
+    if (m_bytesDropped.fetch_add(bytes, std::memory_order_relaxed) == 0)
+        qWarning() << m_name << "chunk pool exhausted, dropping data";
+}
+
+ChunkPool::Chunk *IoReactor::acquireChunk()
+{
+    ChunkPool::Chunk *chunk = m_chunkPool.acquire();
+    return chunk ? chunk : &m_discardChunk;
+}
+
+void IoReactor::releaseChunk(ChunkPool::Chunk *chunk)
+{
+    if (!isDiscardChunk(chunk))
+        m_chunkPool.release(chunk);
+}
+
+void IoReactor::sampleCpuTime()
+{
+    timespec ts {};
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+        m_cpuTimeNs.store(qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec, std::memory_order_relaxed);
+}
@@ -0,0 +1,102 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef IOREACTOR_H
+#define IOREACTOR_H
+
+#include <QtCore/QThread>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "ChunkPool.h"
+
+// One thread serving the reads of many non-blocking file descriptors,
+// e.g. all ttys of a test rig, instead of one blocking thread per port.
+// Data is read into chunks from the reactor's pool and handed to the
+// fd's handler, which must give each chunk back to chunkPool(). When
+// consumers hold on to every chunk the pool may allocate, the fds are
+// still drained, but into a discard chunk, and the data is counted as
+// dropped instead of being handed out.
+class IoReactor {
+public:
+    using ReadHandler = std::function<void(ChunkPool::Chunk *chunk)>;
+    // errno of the failed read, or 0 if the other side hung up
+    using ErrorHandler = std::function<void(int error)>;
+
+    // syscalls and cpuTimeNs allow comparing the cost per megabyte of the
+    // implementations; cpuTimeNs is the reactor thread's CPU time
+    struct Stats {
+        qint64 wakeups = 0;
+        qint64 events = 0;
+        qint64 reads = 0;
+        qint64 bytes = 0;
+        qint64 bytesDropped = 0;
+        qint64 syscalls = 0;
+        qint64 cpuTimeNs = 0;
+    };
+
+    virtual ~IoReactor();
+
+    IoReactor(const IoReactor &) = delete;
+    IoReactor &operator=(const IoReactor &) = delete;
+
+    // Returns an io_uring reactor if preferred and supported by the
+    // kernel, an epoll reactor otherwise
+    static std::unique_ptr<IoReactor> create(bool preferUring = true);
+
+    virtual bool isValid() const = 0;
+
+    // The fd must be non-blocking and stay open until remove() returned.
+    // Handlers run on the reactor thread; once remove() returned, none of
+    // them is running or will be called again for this fd.
+    virtual bool add(int fd, ReadHandler onRead, ErrorHandler onError) = 0;
+    virtual void remove(int fd) = 0;
+
+    void start();
+    void stop();
+
+    ChunkPool &chunkPool() { return m_chunkPool; }
+    Stats stats() const;
+
+protected:
+    explicit IoReactor(const char *name);
+
+    virtual void run() = 0;
+    // Makes run() return from its wait, so that it sees stopping()
+    virtual void wake() = 0;
+
+    bool stopping() const { return m_stopping.load(std::memory_order_relaxed); }
+    bool isRunning() const { return m_thread != nullptr; }
+    bool isReactorThread() const { return QThread::currentThread() == m_thread.get(); }
+
+    // Called by run() once per wakeup
+    void countWakeup(int events, int syscalls);
+    void countRead(qint64 bytes);
+    void countDropped(qint64 bytes);
+
+    // A chunk from the pool, or the discard chunk if the pool is exhausted
+    ChunkPool::Chunk *acquireChunk();
+    void releaseChunk(ChunkPool::Chunk *chunk);
+    bool isDiscardChunk(const ChunkPool::Chunk *chunk) const { return chunk == &m_discardChunk; }
+
+    ChunkPool m_chunkPool;
+
+private:
+    void sampleCpuTime();
+
+    const char *const m_name;
+    std::unique_ptr<QThread> m_thread;
+    std::atomic<bool> m_stopping { false };
+    ChunkPool::Chunk m_discardChunk;
+
+    std::atomic<qint64> m_wakeups { 0 };
+    std::atomic<qint64> m_events { 0 };
+    std::atomic<qint64> m_reads { 0 };
+    std::atomic<qint64> m_bytes { 0 };
+    std::atomic<qint64> m_bytesDropped { 0 };
+    std::atomic<qint64> m_syscalls { 0 };
+    std::atomic<qint64> m_cpuTimeNs { 0 };
+};
+
+#endif // IOREACTOR_H
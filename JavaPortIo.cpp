@@ -0,0 +1,45 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#include "JavaPortIo.h"
+
+QByteArray JavaPortIo::read(JNIEnv *env, jobject port, jmethodID readMethod, int maxLength,
+                            int timeoutMs, bool &failed)
+{
+    jbyteArray buffer = env->NewByteArray(maxLength);
+    const int bytesRead = env->CallIntMethod(port, readMethod, buffer, timeoutMs);
+
+    failed = clearException(env);
+    if (failed || bytesRead <= 0) {
+        env->DeleteLocalRef(buffer);
+        return QByteArray();
+    }
+
+    // Copy straight into the QByteArray; pinning the array with
+    // GetByteArrayElements() would take two calls and possibly a copy more
+    QByteArray data(bytesRead, Qt::Uninitialized);
+    env->GetByteArrayRegion(buffer, 0, bytesRead, reinterpret_cast<jbyte *>(data.data()));
+    env->DeleteLocalRef(buffer);
+    return data;
+}
+
+bool JavaPortIo::write(JNIEnv *env, jobject port, jmethodID writeMethod, const QByteArray &data,
+                       int timeoutMs)
+{
+    jbyteArray buffer = env->NewByteArray(data.size());
+    env->SetByteArrayRegion(buffer, 0, data.size(),
+                            reinterpret_cast<const jbyte *>(data.constData()));
+    env->CallVoidMethod(port, writeMethod, buffer, timeoutMs);
+
+    // Deleting a local reference is allowed with an exception pending
+    env->DeleteLocalRef(buffer);
+    return !clearException(env);
+}
+
+bool JavaPortIo::clearException(JNIEnv *env)
+{
+    if (!env->ExceptionCheck())
+        return false;
+    env->ExceptionDescribe();
+    env->ExceptionClear();
+    return true;
+}
@@ -0,0 +1,32 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef JAVAPORTIO_H
+#define JAVAPORTIO_H
+
+#include <QtCore/QByteArray>
+
+#include <jni.h>
+
+// Reads and writes through the Java driver's UsbSerialPort on the raw
+// JNIEnv. QJniObject clears pending exceptions itself, and an IOException
+// from a dead connection would then look like an ordinary timeout. Only
+// jni.h is needed, so the transfers also run against a fake JNIEnv.
+class JavaPortIo {
+public:
+    // UsbSerialPort.read(byte[], int). Returns the data read, which is
+    // empty on a timeout and when the call threw; failed tells them apart.
+    static QByteArray read(JNIEnv *env, jobject port, jmethodID readMethod, int maxLength,
+                           int timeoutMs, bool &failed);
+
+    // UsbSerialPort.write(byte[], int), which reports short writes and
+    // errors as IOException. Returns false if it threw.
+    static bool write(JNIEnv *env, jobject port, jmethodID writeMethod, const QByteArray &data,
+                      int timeoutMs);
+
+private:
+    // Logs and clears a pending exception, like
+    // QJniEnvironment::checkAndClearExceptions()
+    static bool clearException(JNIEnv *env);
+};
+
+#endif // JAVAPORTIO_H
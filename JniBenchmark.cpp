@@ -0,0 +1,250 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#include "JniBenchmark.h"
+#include "JavaPortIo.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJniEnvironment>
+#include <QtCore/QJniObject>
+#include <QtGui/QGuiApplication>
+
+#include <type_traits>
+
+#include <qtjenny_output/jenny/proxy/android_app_ActivityProxy.h>
+#include <qtjenny_output/jenny/proxy/android_media_AudioManagerProxy.h>
+#include <qtjenny_output/jenny/proxy/android_os_ContextProxy.h>
+
+namespace {
+
+const char *variantName(JniBenchmark::Variant variant)
+{
+    switch (variant) {
+    case JniBenchmark::Variant::StringLookup:
+        return "string lookup";
+    case JniBenchmark::Variant::CachedId:
+        return "cached id";
+    case JniBenchmark::Variant::JavaPortIo:
+        return "JavaPortIo";
+    case JniBenchmark::Variant::Proxy:
+        return "proxy";
+    case JniBenchmark::Variant::ProxyView:
+        break;
+    }
+    return "proxy view";
+}
+
+// Checked after every call, as the app does. A call failed if it left an
+// exception pending or, for the ones that clear it themselves like
+// JavaPortIo, returned false.
+template <typename Function>
+bool succeeded(JNIEnv *env, Function &function)
+{
+    if constexpr (std::is_same_v<std::invoke_result_t<Function &>, bool>) {
+        if (!function())
+            return false;
+    } else {
+        function();
+    }
+    return !env->ExceptionCheck();
+}
+
+// Calls the function until measureNs have passed and returns ns per call,
+// or -1 as soon as a call failed
+template <typename Function>
+double measure(qint64 measureNs, qint64 &calls, Function function)
+{
+    JNIEnv *env = QJniEnvironment::getJniEnv();
+
+    // Warm up, so that the JIT compiled the Java side
+    for (int i = 0; i < 100; ++i) {
+        if (!succeeded(env, function))
+            return -1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    calls = 0;
+    do {
+        for (int i = 0; i < 64; ++i) {
+            if (!succeeded(env, function))
+                return -1;
+        }
+        calls += 64;
+    } while (timer.nsecsElapsed() < measureNs);
+    return double(timer.nsecsElapsed()) / calls;
+}
+
+} // namespace
+
+template <typename Function>
+void JniBenchmark::record(QList<Result> &results, const char *operation, Variant variant,
+                          int payloadBytes, Function function)
+{
+    Result result;
+    result.operation = QString::fromLatin1(operation);
+    result.variant = variant;
+    result.payloadBytes = payloadBytes;
+    result.nsPerCall = measure(measureNs, result.calls, function);
+    if (QJniEnvironment().checkAndClearExceptions() || result.nsPerCall < 0) {
+        qWarning() << operation << variantName(variant) << "threw, not recorded";
+        return;
+    }
+    results.append(result);
+}
+
+QList<JniBenchmark::Result> JniBenchmark::run(const QList<int> &payloadSizes)
+{
+    QList<Result> results;
+
+    QJniObject port("org/qtproject/example/appqtjenny_consumer/JniBenchmarkPort");
+    if (!port.isValid()) {
+        qWarning() << "JniBenchmarkPort is not available";
+        return results;
+    }
+
+    QJniEnvironment env;
+    jclass portClass = env->GetObjectClass(port.object());
+    const jmethodID read = env->GetMethodID(portClass, "read", "([BI)I");
+    const jmethodID write = env->GetMethodID(portClass, "write", "([BI)V");
+    const jmethodID getDeviceName = env->GetMethodID(portClass, "getDeviceName",
+                                                     "()Ljava/lang/String;");
+    env->DeleteLocalRef(portClass);
+    if (!read || !write || !getDeviceName) {
+        env.checkAndClearExceptions();
+        qWarning() << "JniBenchmarkPort lacks the expected methods";
+        return results;
+    }
+
+    const auto record = [&](const char *operation, Variant variant, int size, auto function) {
+        JniBenchmark::record(results, operation, variant, size, function);
+    };
+
+    // The string return of the enumeration calls, as an example of an
+    // object result that is converted to QString
+    record("getDeviceName", Variant::StringLookup, 0, [&]() {
+        port.callObjectMethod<jstring>("getDeviceName").toString();
+    });
+    record("getDeviceName", Variant::CachedId, 0, [&]() {
+        auto name = static_cast<jstring>(env->CallObjectMethod(port.object(), getDeviceName));
+        const jsize length = env->GetStringLength(name);
+        QString string(length, Qt::Uninitialized);
+        env->GetStringRegion(name, 0, length, reinterpret_cast<jchar *>(string.data()));
+        env->DeleteLocalRef(name);
+    });
+
+    for (const int size : payloadSizes) {
+        QByteArray data(size, Qt::Uninitialized);
+
+        record("read", Variant::StringLookup, size, [&]() {
+            jbyteArray buffer = env->NewByteArray(size);
+            const int length = port.callMethod<jint>("read", "([BI)I", buffer, 0);
+            env->GetByteArrayRegion(buffer, 0, length, reinterpret_cast<jbyte *>(data.data()));
+            env->DeleteLocalRef(buffer);
+        });
+        record("read", Variant::JavaPortIo, size, [&]() {
+            bool failed = false;
+            data = JavaPortIo::read(env.jniEnv(), port.object(), read, size, 0, failed);
+            return !failed;
+        });
+
+        record("write", Variant::StringLookup, size, [&]() {
+            jbyteArray buffer = env->NewByteArray(size);
+            env->SetByteArrayRegion(buffer, 0, size,
+                                    reinterpret_cast<const jbyte *>(data.constData()));
+            port.callMethod<void>("write", "([BI)V", buffer, 0);
+            env->DeleteLocalRef(buffer);
+        });
+        record("write", Variant::JavaPortIo, size, [&]() {
+            return JavaPortIo::write(env.jniEnv(), port.object(), write, data, 0);
+        });
+    }
+
+    measureSystemServices(results);
+
+    for (const Result &result : std::as_const(results)) {
+        const double mbPerSecond = result.payloadBytes
+            ? result.payloadBytes * 1000.0 / result.nsPerCall
+            : 0;
+        qInfo().nospace().noquote()
+            << result.operation << " " << variantName(result.variant) << " "
+            << result.payloadBytes << " B: " << result.nsPerCall << " ns/call, "
+            << mbPerSecond << " MB/s (" << result.calls << " calls)";
+    }
+    return results;
+}
+
+// The calls the app makes outside the serial data path: a generated proxy,
+// as BackEnd uses it, and the UsbManager behind the device enumeration
+void JniBenchmark::measureSystemServices(QList<Result> &results)
+{
+    using namespace android::app;
+    using namespace android::media;
+    using namespace android::os;
+
+    auto *nativeInterface = QCoreApplication::instance()
+                                ->nativeInterface<QNativeInterface::QAndroidApplication>();
+    if (!nativeInterface)
+        return;
+
+    const QJniObject context = nativeInterface->context();
+    const ContextProxy contextProxy(context);
+    const ActivityProxy activity(context);
+    const AudioManagerProxy audioManager =
+        activity.view().getSystemService(contextProxy.AUDIO_SERVICE);
+    const QJniObject audioObject(audioManager->object<jobject>());
+    if (audioObject.isValid()) {
+        record(results, "getRingerMode", Variant::StringLookup, 0, [&]() {
+            audioObject.callMethod<jint>("getRingerMode", "()I");
+        });
+        record(results, "getRingerMode", Variant::Proxy, 0, [&]() {
+            audioManager.getRingerMode();
+        });
+        // Views are local references, so each call creates and deletes one
+        record(results, "getRingerMode", Variant::ProxyView, 0, [&]() {
+            audioManager.view().getRingerMode();
+        });
+    } else {
+        qWarning() << "AudioManager is not available";
+    }
+
+    const QJniObject usbManager = context.callObjectMethod(
+        "getSystemService", "(Ljava/lang/String;)Ljava/lang/Object;",
+        QJniObject::fromString("usb").object());
+    if (!usbManager.isValid()) {
+        qWarning() << "UsbManager is not available";
+        return;
+    }
+
+    QJniEnvironment env;
+    jclass managerClass = env->GetObjectClass(usbManager.object());
+    const jmethodID getDeviceList = env->GetMethodID(managerClass, "getDeviceList",
+                                                     "()Ljava/util/HashMap;");
+    env->DeleteLocalRef(managerClass);
+    if (!getDeviceList) {
+        env.checkAndClearExceptions();
+        qWarning() << "UsbManager lacks getDeviceList()";
+        return;
+    }
+
+    record(results, "getDeviceList", Variant::StringLookup, 0, [&]() {
+        usbManager.callObjectMethod("getDeviceList", "()Ljava/util/HashMap;");
+    });
+    record(results, "getDeviceList", Variant::CachedId, 0, [&]() {
+        env->DeleteLocalRef(env->CallObjectMethod(usbManager.object(), getDeviceList));
+    });
+
+    // What UsbSerialHelper::getAvailableDevices() calls before it walks
+    // the list
+    const QJniObject prober = QJniObject::callStaticObjectMethod(
+        "com/hoho/android/usbserial/driver/UsbSerialProber", "getDefaultProber",
+        "()Lcom/hoho/android/usbserial/driver/UsbSerialProber;");
+    if (prober.isValid()) {
+        record(results, "findAllDrivers", Variant::StringLookup, 0, [&]() {
+            prober.callObjectMethod("findAllDrivers",
+                                    "(Landroid/hardware/usb/UsbManager;)Ljava/util/List;",
+                                    usbManager.object());
+        });
+    }
+}
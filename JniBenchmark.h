@@ -0,0 +1,55 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef JNIBENCHMARK_H
+#define JNIBENCHMARK_H
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+// Measures what the ways of calling Java cost on the device, against
+// JniBenchmarkPort.java, which mimics UsbSerialPort without doing I/O:
+//  - StringLookup: QJniObject::callMethod with name and signature, a new
+//    byte[] per call
+//  - CachedId: a cached jmethodID on the raw JNIEnv
+//  - JavaPortIo: what UsbSerialHelper::readData() and writeData() do
+//  - Proxy: a generated proxy over QJniObject, as BackEnd keeps them
+//  - ProxyView: a generated proxy over a local reference, with the method
+//    ID it resolved on the first call
+// Besides the port, it times AudioManager through the generated proxies and
+// the UsbManager calls of the device enumeration. The variants of moving
+// the data on the raw JNIEnv are compared on a host JVM by
+// tests/benchmarks/jni instead.
+// Started from main() when QTJENNY_JNI_BENCHMARK is set; runs for a few
+// seconds and logs the results.
+class JniBenchmark
+{
+public:
+    enum class Variant {
+        StringLookup,
+        CachedId,
+        JavaPortIo,
+        Proxy,
+        ProxyView
+    };
+
+    struct Result {
+        QString operation;
+        Variant variant;
+        int payloadBytes = 0;
+        qint64 calls = 0;
+        double nsPerCall = 0;
+    };
+
+    static QList<Result> run(const QList<int> &payloadSizes = { 64, 512, 4096, 16384 });
+
+private:
+    // Every measurement runs for about this long
+    static constexpr qint64 measureNs = 100 * 1000 * 1000;
+
+    template <typename Function>
+    static void record(QList<Result> &results, const char *operation, Variant variant,
+                       int payloadBytes, Function function);
+    static void measureSystemServices(QList<Result> &results);
+};
+
+#endif // JNIBENCHMARK_H
@@ -0,0 +1,71 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "NmeaParser.h"
+
+int NmeaParser::parse(QByteArrayView data, qint64 receivedNs, QList<SerialFrame> &frames)
+{
+    int checksumErrors = 0;
+
+    for (const char c : data) {
+        if (c == '$' || c == '!') {
+            // A start character always begins a new sentence; whatever came
+            // before was cut off. resize(0) rather than clear() keeps the
+            // allocation for the next sentence.
+            m_sentence.resize(0);
+            m_sentence.append(c);
+            m_sentenceReceivedNs = receivedNs;
+            continue;
+        }
+
+        if (m_sentence.isEmpty())
+            continue;
+
+        if (c == '\r' || c == '\n') {
+            if (checksumValid(m_sentence))
+                frames.append(SerialFrame { m_sentence, m_sentenceReceivedNs });
+            else
+                checksumErrors++;
+            m_sentence.resize(0);
+            continue;
+        }
+
+        if (m_sentence.size() >= maxSentenceLength) {
+            m_sentence.resize(0);
+            checksumErrors++;
+            continue;
+        }
+        m_sentence.append(c);
+    }
+
+    return checksumErrors;
+}
+
+// Sentences without a checksum field are accepted, as the standard allows
+bool NmeaParser::checksumValid(QByteArrayView sentence)
+{
+    const qsizetype star = sentence.lastIndexOf('*');
+    if (star < 0)
+        return true;
+    if (sentence.size() - star != 3)
+        return false;
+
+    quint8 checksum = 0;
+    for (qsizetype i = 1; i < star; i++)
+        checksum ^= quint8(sentence[i]);
+
+    const int high = hexValue(sentence[star + 1]);
+    const int low = hexValue(sentence[star + 2]);
+    return high >= 0 && low >= 0 && (high << 4 | low) == checksum;
+}
+
+int NmeaParser::hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
@@ -0,0 +1,25 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef NMEAPARSER_H
+#define NMEAPARSER_H
+
+#include "FrameParser.h"
+
+// NMEA 0183 sentences as sent by GNSS receivers and FLARM ($GPRMC,
+// $PFLAA, ...). Frames are complete sentences without the line ending.
+class NmeaParser : public FrameParser {
+public:
+    int parse(QByteArrayView data, qint64 receivedNs, QList<SerialFrame> &frames) override;
+
+private:
+    // The standard allows 82 characters; proprietary sentences are longer
+    static constexpr qsizetype maxSentenceLength = 200;
+
+    static bool checksumValid(QByteArrayView sentence);
+    static int hexValue(char c);
+
+    QByteArray m_sentence;
+    qint64 m_sentenceReceivedNs = 0;
+};
+
+#endif // NMEAPARSER_H
@@ -0,0 +1,83 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#include "NotificationDispatcher.h"
+
+NotificationDispatcher::NotificationDispatcher(Poster poster, QObject *parent)
+    : QObject(parent), m_poster(std::move(poster))
+{
+}
+
+void NotificationDispatcher::setRateLimit(const QString &name, int minIntervalMs)
+{
+    channel(name).minIntervalMs = minIntervalMs;
+}
+
+void NotificationDispatcher::post(const QString &name, const QString &title,
+                                  const QString &text)
+{
+    Channel &target = channel(name);
+    target.pending.title = title;
+    target.pending.text = text;
+    target.pending.count++;
+    m_stats.alerts++;
+
+    if (target.timer.isActive())
+        return;
+
+    const qint64 waitMs = target.lastPost.isValid()
+        ? target.minIntervalMs - target.lastPost.elapsed()
+        : 0;
+    if (waitMs <= 0)
+        flush(target);
+    else
+        target.timer.start(int(waitMs));
+}
+
+void NotificationDispatcher::reset(const QString &name)
+{
+    Channel &target = channel(name);
+    target.pending.count -= target.shown.count;
+    target.shown = Notification();
+    if (target.pending.count == 0)
+        target.timer.stop();
+}
+
+void NotificationDispatcher::dismissed(int notificationId)
+{
+    for (auto it = m_channels.cbegin(); it != m_channels.cend(); ++it) {
+        if (it.value()->pending.id == notificationId) {
+            reset(it.key());
+            return;
+        }
+    }
+}
+
+NotificationDispatcher::Channel &NotificationDispatcher::channel(const QString &name)
+{
+    std::shared_ptr<Channel> &entry = m_channels[name];
+    if (!entry) {
+        entry = std::make_shared<Channel>();
+        entry->pending.id = m_nextId++;
+        entry->minIntervalMs = m_defaultIntervalMs;
+        entry->timer.setSingleShot(true);
+        Channel *target = entry.get();
+        connect(&entry->timer, &QTimer::timeout, this, [this, target]() { flush(*target); });
+    }
+    return *entry;
+}
+
+void NotificationDispatcher::flush(Channel &channel)
+{
+    const Notification &pending = channel.pending;
+    const Notification &shown = channel.shown;
+    if (pending.count == shown.count && pending.title == shown.title
+        && pending.text == shown.text) {
+        m_stats.unchanged++;
+        return;
+    }
+
+    channel.shown = pending;
+    channel.lastPost.start();
+    m_stats.posted++;
+    m_poster(channel.shown);
+}
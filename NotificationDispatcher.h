@@ -0,0 +1,78 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef NOTIFICATIONDISPATCHER_H
+#define NOTIFICATIONDISPATCHER_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+
+#include <functional>
+#include <memory>
+
+// Turns bursts of alerts into rate-limited notification updates. Every
+// alert channel is shown as one notification carrying the number of alerts
+// and the latest text; alerts arriving faster than the channel's rate limit
+// are coalesced into the next update. The poster is only called when the
+// content to show differs from what was last posted. Must be used from the
+// thread it lives in.
+class NotificationDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Notification {
+        int id = 0;
+        QString title;
+        QString text;
+        int count = 0;
+    };
+
+    struct Stats {
+        quint64 alerts = 0;
+        quint64 posted = 0;
+        quint64 unchanged = 0;
+    };
+
+    using Poster = std::function<void(const Notification &notification)>;
+
+    explicit NotificationDispatcher(Poster poster, QObject *parent = nullptr);
+
+    // Minimum time between two updates of the channel's notification
+    void setRateLimit(const QString &channel, int minIntervalMs);
+    void setDefaultRateLimit(int minIntervalMs) { m_defaultIntervalMs = minIntervalMs; }
+
+    void post(const QString &channel, const QString &title, const QString &text);
+
+    // Starts counting the channel's alerts from zero again, e.g. when the
+    // user dismissed its notification. Alerts still held back by the rate
+    // limit stay pending, and the next update is posted even if it looks
+    // like the dismissed one.
+    void reset(const QString &channel);
+    // The same for the channel shown under the notification id
+    void dismissed(int notificationId);
+
+    Stats stats() const { return m_stats; }
+
+private:
+    struct Channel {
+        Notification pending;
+        Notification shown;
+        int minIntervalMs = 0;
+        QElapsedTimer lastPost;
+        QTimer timer;
+    };
+
+    Channel &channel(const QString &name);
+    void flush(Channel &channel);
+
+    Poster m_poster;
+    QHash<QString, std::shared_ptr<Channel>> m_channels;
+    int m_defaultIntervalMs = 1000;
+    int m_nextId = 1;
+    Stats m_stats;
+};
+
+#endif // NOTIFICATIONDISPATCHER_H
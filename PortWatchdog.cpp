@@ -0,0 +1,139 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "PortWatchdog.h"
+
+#include <cmath>
+
+PortWatchdog::PortWatchdog(SerialSession *session, QObject *parent)
+    : QObject{ parent }, m_session(session)
+{
+    m_clock.start();
+    m_sampleClock.start();
+    m_lastData.start();
+    m_lastBytesReceived = m_session->bytesReceived();
+
+    // A fresh connection gets a fresh stall timeout
+    connect(m_session, &SerialSession::reconnected, this, [this]() {
+        m_lastData.start();
+    });
+
+    connect(&m_sampleTimer, &QTimer::timeout, this, &PortWatchdog::sample);
+    m_sampleTimer.start(m_sampleIntervalMs);
+}
+
+void PortWatchdog::setExpectedRate(double bytesPerSecond)
+{
+    m_expectedRate = qMax(0.0, bytesPerSecond);
+}
+
+void PortWatchdog::setSampleInterval(int intervalMs)
+{
+    m_sampleIntervalMs = qMax(1, intervalMs);
+    m_stallTimeoutMs = qMax(m_sampleIntervalMs, m_stallTimeoutMs);
+    m_sampleTimer.start(m_sampleIntervalMs);
+}
+
+void PortWatchdog::setStallTimeout(int timeoutMs)
+{
+    m_stallTimeoutMs = qMax(m_sampleIntervalMs, timeoutMs);
+}
+
+void PortWatchdog::setErrorBurst(int errors, int windowMs)
+{
+    m_burstErrors = qMax(1, errors);
+    m_burstWindowMs = qMax(1, windowMs);
+}
+
+void PortWatchdog::reportFrames(int validFrames, int checksumErrors)
+{
+    m_frames += validFrames + checksumErrors;
+    if (checksumErrors <= 0)
+        return;
+
+    m_checksumErrors += checksumErrors;
+
+    const qint64 now = m_clock.elapsed();
+    for (int i = 0; i < checksumErrors; i++)
+        m_errorTimes.enqueue(now);
+    while (now - m_errorTimes.head() > m_burstWindowMs)
+        m_errorTimes.dequeue();
+
+    if (m_errorTimes.size() >= m_burstErrors) {
+        const int errors = m_errorTimes.size();
+        m_errorTimes.clear();
+        qWarning() << errors << "checksum errors within" << m_burstWindowMs << "ms";
+        emit errorBurstDetected(errors);
+
+        // Stale, half-overwritten data in the adapter is the usual cause
+        m_session->purgeBuffers(true, false);
+    }
+}
+
+void PortWatchdog::sample()
+{
+    const qint64 intervalMs = qMax<qint64>(1, m_sampleClock.restart());
+
+    qint64 bytesReceived = m_session->bytesReceived();
+    if (bytesReceived < m_lastBytesReceived)
+        m_lastBytesReceived = 0; // session was reopened
+    const qint64 bytes = bytesReceived - m_lastBytesReceived;
+    m_lastBytesReceived = bytesReceived;
+
+    double rateScore = 0;
+    if (m_session->state() == SerialSession::State::Connected) {
+        if (bytes > 0) {
+            m_lastData.start();
+            m_recoveryStep = 0;
+            setStalled(false);
+        } else if (m_lastData.hasExpired(m_stallTimeoutMs)) {
+            setStalled(true);
+            recover();
+        }
+
+        if (m_expectedRate > 0)
+            rateScore = qMin(1.0, bytes * 1000.0 / intervalMs / m_expectedRate);
+        else
+            rateScore = m_stalled ? 0.0 : 1.0;
+    }
+
+    const double errorRatio = m_frames > 0 ? double(m_checksumErrors) / m_frames : 0.0;
+    m_frames = 0;
+    m_checksumErrors = 0;
+
+    m_score += scoreSmoothing * (100.0 * rateScore * (1.0 - errorRatio) - m_score);
+
+    const int healthScore = int(std::lround(m_score));
+    if (healthScore != m_healthScore) {
+        m_healthScore = healthScore;
+        emit healthScoreChanged(healthScore);
+    }
+}
+
+void PortWatchdog::recover()
+{
+    // Each step gets a full stall timeout to show an effect
+    m_lastData.start();
+
+    if (m_recoveryStep == 0) {
+        qWarning() << "No data for" << m_stallTimeoutMs << "ms, purging buffers";
+        m_recoveryStep = 1;
+        if (m_session->purgeBuffers())
+            return;
+    }
+
+    qWarning() << "Port still stalled, reopening";
+    m_recoveryStep = 2;
+    m_session->reopen();
+}
+
+void PortWatchdog::setStalled(bool stalled)
+{
+    if (m_stalled == stalled)
+        return;
+
+    m_stalled = stalled;
+    emit stalledChanged(stalled);
+    if (stalled)
+        emit stallDetected();
+}
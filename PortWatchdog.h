@@ -0,0 +1,91 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef PORTWATCHDOG_H
+#define PORTWATCHDOG_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QQueue>
+#include <QtCore/QTimer>
+
+#include "SerialSession.h"
+
+// Watches a session for ports that stay open but stop delivering data, as
+// some CH34x adapters do after suspend, and for bursts of checksum errors.
+// A stall first purges the adapter's buffers and, if that does not help,
+// reopens the port. The rolling health score (0-100) combines the data
+// rate relative to the expected one with the frame error ratio, so that
+// the app can switch to a backup receiver early.
+class PortWatchdog : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int healthScore READ healthScore NOTIFY healthScoreChanged)
+    Q_PROPERTY(bool stalled READ isStalled NOTIFY stalledChanged)
+
+public:
+    explicit PortWatchdog(SerialSession *session, QObject *parent = nullptr);
+
+    // Data rate the device normally delivers, in bytes per second. With 0,
+    // any data counts as a full rate.
+    double expectedRate() const { return m_expectedRate; }
+    void setExpectedRate(double bytesPerSecond);
+
+    // How often the data rate is sampled; the stall timeout is at least
+    // one interval
+    int sampleInterval() const { return m_sampleIntervalMs; }
+    void setSampleInterval(int intervalMs);
+
+    int stallTimeout() const { return m_stallTimeoutMs; }
+    void setStallTimeout(int timeoutMs);
+
+    // Number of checksum errors within the window that counts as a burst
+    void setErrorBurst(int errors, int windowMs);
+
+    // Called with what the parser has checked since the last call, e.g.
+    // from SerialPipeline::framesReady(): the valid frames and the ones it
+    // dropped because of a bad checksum
+    void reportFrames(int validFrames, int checksumErrors);
+
+    int healthScore() const { return m_healthScore; }
+    bool isStalled() const { return m_stalled; }
+
+signals:
+    void healthScoreChanged(int healthScore);
+    void stalledChanged(bool stalled);
+    void stallDetected();
+    void errorBurstDetected(int errors);
+
+private:
+    // Weight of the newest sample in the rolling score
+    static constexpr double scoreSmoothing = 0.2;
+
+    void sample();
+    void recover();
+    void setStalled(bool stalled);
+
+    SerialSession *m_session;
+    QTimer m_sampleTimer;
+    QElapsedTimer m_sampleClock;
+    QElapsedTimer m_lastData;
+
+    double m_expectedRate = 0;
+    int m_sampleIntervalMs = 1000;
+    int m_stallTimeoutMs = 5000;
+    int m_burstErrors = 5;
+    int m_burstWindowMs = 2000;
+
+    qint64 m_lastBytesReceived = 0;
+    int m_frames = 0;
+    int m_checksumErrors = 0;
+    QQueue<qint64> m_errorTimes;
+    QElapsedTimer m_clock;
+
+    // 0: nothing tried yet, 1: buffers purged, 2: port reopened
+    int m_recoveryStep = 0;
+    bool m_stalled = false;
+    double m_score = 100;
+    int m_healthScore = 100;
+};
+
+#endif // PORTWATCHDOG_H
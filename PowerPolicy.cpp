@@ -0,0 +1,106 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#include "PowerPolicy.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtQml/QJSEngine>
+
+#include <qtjenny_output/jenny/proxy/android_os_BatteryManagerProxy.h>
+#include <qtjenny_output/jenny/proxy/android_os_ContextProxy.h>
+
+PowerPolicy::PowerPolicy()
+{
+    using namespace android::os;
+
+    const QJniObject context = QNativeInterface::QAndroidApplication::context();
+    m_batteryManager = ContextProxyView(context).getSystemService(ContextProxy::BATTERY_SERVICE);
+
+    // The battery broadcast is sticky, so the receiver gets the current
+    // state right after registering
+    QJniObject::callStaticMethod<void>(
+        "org/qtproject/example/appqtjenny_consumer/BatteryReceiver",
+        "register",
+        "(Landroid/content/Context;)V",
+        context.object());
+}
+
+PowerPolicy *PowerPolicy::instance()
+{
+    static PowerPolicy policy;
+    return &policy;
+}
+
+PowerPolicy *PowerPolicy::create(QQmlEngine *, QJSEngine *)
+{
+    PowerPolicy *policy = instance();
+    QJSEngine::setObjectOwnership(policy, QJSEngine::CppOwnership);
+    return policy;
+}
+
+PowerPolicy::Budget PowerPolicy::budget(Mode mode)
+{
+    switch (mode) {
+    case Mode::Performance:
+        return { 1000, 16, 9, true, true };
+    case Mode::Balanced:
+        return { 1000, 33, 6, true, true };
+    case Mode::Saver:
+        return { 2000, 100, 3, true, false };
+    case Mode::Critical:
+        break;
+    }
+    return { 5000, 250, 1, false, false };
+}
+
+void PowerPolicy::onBatteryChanged()
+{
+    using namespace android::os;
+
+    BatteryManagerProxyView batteryManager(m_batteryManager);
+    const int level = batteryManager.getIntProperty(BatteryManagerProxy::BATTERY_PROPERTY_CAPACITY);
+    const bool charging = batteryManager.isCharging();
+
+    QMetaObject::invokeMethod(this, [this, level, charging]() { update(level, charging); },
+                              Qt::QueuedConnection);
+}
+
+void PowerPolicy::update(int level, bool charging)
+{
+    // getIntProperty() answers with Integer.MIN_VALUE when it has no value
+    if (level < 0 || level > 100)
+        level = m_batteryLevel;
+
+    if (level != m_batteryLevel || charging != m_charging) {
+        m_batteryLevel = level;
+        m_charging = charging;
+        emit batteryChanged();
+    }
+
+    Mode mode = Mode::Balanced;
+    if (charging)
+        mode = Mode::Performance;
+    else if (level < criticalBelow)
+        mode = Mode::Critical;
+    else if (level < saverBelow)
+        mode = Mode::Saver;
+
+    if (mode == m_mode)
+        return;
+
+    qInfo() << "Power policy" << mode << "at" << level << "%"
+            << (charging ? "while charging" : "on battery");
+    m_mode = mode;
+    emit modeChanged(mode);
+}
+
+extern "C" {
+
+JNIEXPORT void JNICALL
+Java_org_qtproject_example_appqtjenny_1consumer_BatteryReceiver_nativeBatteryChanged(
+    JNIEnv *, jclass)
+{
+    PowerPolicy::instance()->onBatteryChanged();
+}
+
+} // extern "C"
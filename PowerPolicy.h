@@ -0,0 +1,85 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef POWERPOLICY_H
+#define POWERPOLICY_H
+
+#include <QtCore/QJniObject>
+#include <QtCore/QObject>
+#include <QtQml/qqml.h>
+
+class QJSEngine;
+class QQmlEngine;
+
+// Picks how much work the app may do from the battery state, so that long
+// flights on battery degrade gracefully instead of running flat. The level
+// and charging state are read through BatteryManagerProxy whenever the
+// system broadcasts a battery change (BatteryReceiver.java). Components
+// read the budget of the active mode and follow modeChanged().
+class PowerPolicy : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_SINGLETON
+
+    Q_PROPERTY(Mode mode READ mode NOTIFY modeChanged)
+    Q_PROPERTY(int batteryLevel READ batteryLevel NOTIFY batteryChanged)
+    Q_PROPERTY(bool charging READ isCharging NOTIFY batteryChanged)
+    Q_PROPERTY(int readPollInterval READ readPollInterval NOTIFY modeChanged)
+    Q_PROPERTY(int uiUpdateInterval READ uiUpdateInterval NOTIFY modeChanged)
+    Q_PROPERTY(int compressionLevel READ compressionLevel NOTIFY modeChanged)
+
+public:
+    enum class Mode {
+        Performance, // charging
+        Balanced,
+        Saver,
+        Critical
+    };
+    Q_ENUM(Mode)
+
+    struct Budget {
+        int readPollIntervalMs;
+        int uiUpdateIntervalMs;
+        // zlib style, 1 is the cheapest; lower levels save CPU time on battery
+        int compressionLevel;
+        bool allowPartialWakeLock;
+        bool allowFullWakeLock;
+    };
+
+    static PowerPolicy *instance();
+    static PowerPolicy *create(QQmlEngine *, QJSEngine *);
+
+    Mode mode() const { return m_mode; }
+    Budget budget() const { return budget(m_mode); }
+    static Budget budget(Mode mode);
+
+    int batteryLevel() const { return m_batteryLevel; }
+    bool isCharging() const { return m_charging; }
+
+    int readPollInterval() const { return budget().readPollIntervalMs; }
+    int uiUpdateInterval() const { return budget().uiUpdateIntervalMs; }
+    int compressionLevel() const { return budget().compressionLevel; }
+
+    // Called by BatteryReceiver on the Android main thread
+    void onBatteryChanged();
+
+signals:
+    void modeChanged(PowerPolicy::Mode mode);
+    void batteryChanged();
+
+private:
+    // Battery levels in percent below which the next mode applies
+    static constexpr int saverBelow = 40;
+    static constexpr int criticalBelow = 15;
+
+    PowerPolicy();
+
+    void update(int level, bool charging);
+
+    QJniObject m_batteryManager;
+    Mode m_mode = Mode::Performance;
+    int m_batteryLevel = 100;
+    bool m_charging = true;
+};
+
+#endif // POWERPOLICY_H
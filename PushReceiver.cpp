@@ -0,0 +1,201 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "PushReceiver.h"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QDebug>
+#include <QtCore/QHash>
+#include <QtCore/QJniEnvironment>
+
+#include <utility>
+
+namespace {
+
+// Receivers by handle. Handles are never reused, and a callback holds the
+// lock while it appends, so unregistering waits for a running delivery.
+struct Registry {
+    QMutex mutex;
+    QHash<jlong, PushReceiver *> receivers;
+    jlong nextHandle = 1;
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+jlong registerReceiver(PushReceiver *receiver)
+{
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    const jlong handle = r.nextHandle++;
+    r.receivers.insert(handle, receiver);
+    return handle;
+}
+
+} // namespace
+
+PushReceiver::PushReceiver(qsizetype capacity)
+    : m_handle(registerReceiver(this))
+    , m_buffer(capacity)
+{
+}
+
+PushReceiver::~PushReceiver()
+{
+    stop();
+
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    r.receivers.remove(m_handle);
+}
+
+bool PushReceiver::start(const QJniObject &port)
+{
+    return start(port, Batching());
+}
+
+bool PushReceiver::start(const QJniObject &port, const Batching &batching)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_running = true;
+    }
+
+    QJniEnvironment env;
+    QJniObject reader = QJniObject::callStaticObjectMethod(
+        "org/qtproject/example/appqtjenny_consumer/SerialPortInterface",
+        "start",
+        "(Lcom/hoho/android/usbserial/driver/UsbSerialPort;JIII)"
+        "Lorg/qtproject/example/appqtjenny_consumer/SerialPortInterface;",
+        port.object(),
+        m_handle,
+        batching.readSize,
+        batching.batchBytes,
+        batching.batchMs
+        );
+
+    if (env.checkAndClearExceptions() || !reader.isValid()) {
+        qWarning() << "Failed to start the serial reader thread";
+        QMutexLocker locker(&m_mutex);
+        m_running = false;
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_reader = reader;
+    return true;
+}
+
+void PushReceiver::stop()
+{
+    QJniObject reader;
+    {
+        QMutexLocker locker(&m_mutex);
+        reader = std::exchange(m_reader, QJniObject());
+        m_running = false;
+        m_dataAvailable.wakeAll();
+    }
+
+    // Not under m_mutex: the reader thread may be about to deliver
+    if (reader.isValid()) {
+        QJniEnvironment env;
+        reader.callMethod<void>("stop", "()V");
+        env.checkAndClearExceptions();
+    }
+}
+
+bool PushReceiver::isRunning() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_running;
+}
+
+QByteArray PushReceiver::read(int maxLength, int timeoutMs)
+{
+    const QDeadlineTimer deadline = timeoutMs > 0 ? QDeadlineTimer(timeoutMs)
+                                                  : QDeadlineTimer(QDeadlineTimer::Forever);
+    QMutexLocker locker(&m_mutex);
+    while (m_buffer.isEmpty() && m_running) {
+        if (!m_dataAvailable.wait(&m_mutex, deadline))
+            break;
+    }
+
+    QByteArray data(qMin<qsizetype>(maxLength, m_buffer.size()), Qt::Uninitialized);
+    m_buffer.read(data.data(), data.size());
+    return data;
+}
+
+void PushReceiver::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_buffer.clear();
+}
+
+PushReceiver::Stats PushReceiver::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+void PushReceiver::deliver(jlong handle, const char *data, qsizetype length)
+{
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    if (PushReceiver *receiver = r.receivers.value(handle))
+        receiver->append(data, length);
+}
+
+void PushReceiver::fail(jlong handle, const QString &message)
+{
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    if (PushReceiver *receiver = r.receivers.value(handle))
+        receiver->setFailed(message);
+}
+
+// Bytes that do not fit are dropped rather than blocking the reader
+// thread, which would only move the overrun into the adapter
+void PushReceiver::append(const char *data, qsizetype length)
+{
+    QMutexLocker locker(&m_mutex);
+    const qsizetype written = m_buffer.write(data, length);
+    m_stats.batches++;
+    m_stats.bytes += written;
+    m_stats.droppedBytes += length - written;
+    m_stats.maxBatch = qMax(m_stats.maxBatch, length);
+    if (written > 0)
+        m_dataAvailable.wakeAll();
+}
+
+void PushReceiver::setFailed(const QString &message)
+{
+    qWarning() << "Serial reader thread failed:" << message;
+    QMutexLocker locker(&m_mutex);
+    m_running = false;
+    m_dataAvailable.wakeAll();
+}
+
+extern "C" {
+
+JNIEXPORT void JNICALL
+Java_org_qtproject_example_appqtjenny_1consumer_SerialPortInterface_nativeDeviceNewData(
+    JNIEnv *env, jclass, jlong handle, jobject buffer, jint length)
+{
+    const auto *data = static_cast<const char *>(env->GetDirectBufferAddress(buffer));
+    if (data && length > 0)
+        PushReceiver::deliver(handle, data, length);
+}
+
+JNIEXPORT void JNICALL
+Java_org_qtproject_example_appqtjenny_1consumer_SerialPortInterface_nativeDeviceException(
+    JNIEnv *env, jclass, jlong handle, jstring jMessage)
+{
+    const char *message = env->GetStringUTFChars(jMessage, nullptr);
+    PushReceiver::fail(handle, QString::fromUtf8(message));
+    env->ReleaseStringUTFChars(jMessage, message);
+}
+
+} // extern "C"
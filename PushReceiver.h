@@ -0,0 +1,82 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef PUSHRECEIVER_H
+#define PUSHRECEIVER_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QJniObject>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QWaitCondition>
+
+#include "RingBuffer.h"
+
+// Receive side of a UsbSerialPort that is read by a Java thread
+// (SerialPortInterface.java) instead of being polled over JNI. The Java
+// side collects several reads into one batch and delivers it with a
+// single native call, which appends it to the ring buffer here; read()
+// only waits on that buffer and never calls into Java.
+//
+// The Java side knows the receiver by an opaque handle, never by its
+// address, so a late callback after the receiver is gone finds nothing.
+class PushReceiver {
+public:
+    // A batch is delivered once it holds batchBytes, or batchMs after its
+    // first byte arrived, whichever comes first
+    struct Batching {
+        int readSize = 4096;
+        int batchBytes = 16384;
+        int batchMs = 5;
+    };
+
+    struct Stats {
+        qint64 batches = 0;
+        qint64 bytes = 0;
+        // Lost because the buffer was full
+        qint64 droppedBytes = 0;
+        qsizetype maxBatch = 0;
+    };
+
+    explicit PushReceiver(qsizetype capacity = 256 * 1024);
+    ~PushReceiver();
+
+    PushReceiver(const PushReceiver &) = delete;
+    PushReceiver &operator=(const PushReceiver &) = delete;
+
+    // Starts the Java reader thread on the open port
+    bool start(const QJniObject &port);
+    bool start(const QJniObject &port, const Batching &batching);
+
+    // Waits until the reader thread has delivered its last batch
+    void stop();
+
+    // False after stop() or once the reader thread failed
+    bool isRunning() const;
+
+    // Waits for data up to timeoutMs; 0 waits forever
+    QByteArray read(int maxLength, int timeoutMs);
+
+    // Drops data that has been received but not read yet
+    void clear();
+
+    Stats stats() const;
+
+    // Entry points for the native methods of SerialPortInterface
+    static void deliver(jlong handle, const char *data, qsizetype length);
+    static void fail(jlong handle, const QString &message);
+
+private:
+    void append(const char *data, qsizetype length);
+    void setFailed(const QString &message);
+
+    const jlong m_handle;
+    QJniObject m_reader;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_dataAvailable;
+    RingBuffer m_buffer;
+    bool m_running = false;
+    Stats m_stats;
+};
+
+#endif // PUSHRECEIVER_H
@@ -0,0 +1,40 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "RingBuffer.h"
+
+#include <cstring>
+
+RingBuffer::RingBuffer(qsizetype capacity)
+{
+    while (m_capacity < capacity)
+        m_capacity <<= 1;
+    m_data = std::make_unique<char[]>(size_t(m_capacity));
+}
+
+qsizetype RingBuffer::write(const char *data, qsizetype length)
+{
+    length = qMin(length, freeSpace());
+    const qsizetype offset = m_tail & (m_capacity - 1);
+    const qsizetype first = qMin(length, m_capacity - offset);
+    memcpy(m_data.get() + offset, data, size_t(first));
+    memcpy(m_data.get(), data + first, size_t(length - first));
+    m_tail += length;
+    return length;
+}
+
+qsizetype RingBuffer::read(char *data, qsizetype maxLength)
+{
+    const qsizetype length = qMin(maxLength, size());
+    const qsizetype offset = m_head & (m_capacity - 1);
+    const qsizetype first = qMin(length, m_capacity - offset);
+    memcpy(data, m_data.get() + offset, size_t(first));
+    memcpy(data + first, m_data.get(), size_t(length - first));
+    m_head += length;
+    return length;
+}
+
+void RingBuffer::clear()
+{
+    m_head = m_tail = 0;
+}
@@ -0,0 +1,38 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <QtCore/QtGlobal>
+
+#include <memory>
+
+// Fixed-capacity byte FIFO; capacity is rounded up to a power of two.
+// Not thread-safe.
+class RingBuffer {
+public:
+    explicit RingBuffer(qsizetype capacity);
+
+    RingBuffer(const RingBuffer &) = delete;
+    RingBuffer &operator=(const RingBuffer &) = delete;
+
+    qsizetype capacity() const { return m_capacity; }
+    qsizetype size() const { return m_tail - m_head; }
+    qsizetype freeSpace() const { return m_capacity - size(); }
+    bool isEmpty() const { return m_tail == m_head; }
+
+    // Both return the number of bytes actually copied
+    qsizetype write(const char *data, qsizetype length);
+    qsizetype read(char *data, qsizetype maxLength);
+
+    void clear();
+
+private:
+    qsizetype m_capacity = 1;
+    std::unique_ptr<char[]> m_data;
+    // Positions only ever grow; masked on access
+    qsizetype m_head = 0;
+    qsizetype m_tail = 0;
+};
+
+#endif // RINGBUFFER_H
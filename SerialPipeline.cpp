@@ -0,0 +1,302 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "SerialPipeline.h"
+
+#include "AllocationTracker.h"
+
+#include <chrono>
+
+namespace {
+
+void updateMax(std::atomic<qint64> &max, qint64 value)
+{
+    qint64 current = max.load(std::memory_order_relaxed);
+    while (value > current
+           && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+void SerialPipeline::StageCounters::record(qint64 depth, qint64 latencyUs)
+{
+    batches.fetch_add(1, std::memory_order_relaxed);
+    totalLatencyUs.fetch_add(latencyUs, std::memory_order_relaxed);
+    updateMax(maxDepth, depth);
+    updateMax(maxLatencyUs, latencyUs);
+}
+
+SerialPipeline::Port::Port(int id, AbstractSerialPort *port, std::unique_ptr<FrameParser> parser,
+                           const Config &config)
+    : id(id), port(port), parser(std::move(parser)),
+      chunks(std::size_t(config.queueCapacity)), frames(std::size_t(config.queueCapacity))
+{
+}
+
+SerialPipeline::SerialPipeline(QObject *parent) : QObject{ parent }
+{
+    connect(&m_deliveryTimer, &QTimer::timeout, this, &SerialPipeline::deliver);
+}
+
+SerialPipeline::~SerialPipeline()
+{
+    stop();
+}
+
+void SerialPipeline::setConfig(const Config &config)
+{
+    m_config = config;
+}
+
+int SerialPipeline::addPort(AbstractSerialPort *port, std::unique_ptr<FrameParser> parser)
+{
+    Q_ASSERT(!m_running);
+
+    const int id = int(m_ports.size());
+    m_ports.push_back(std::make_unique<Port>(id, port, std::move(parser), m_config));
+    return id;
+}
+
+void SerialPipeline::start()
+{
+    if (m_running)
+        return;
+
+    m_stopping.store(false, std::memory_order_relaxed);
+
+    if (m_config.parserThreads > 0) {
+        m_parserPool = std::make_unique<WorkStealingPool>(
+            m_config.parserThreads, int(m_ports.size()),
+            [this](int key) { return parseBatches(*m_ports[key], m_config.parserBatchesPerTurn); },
+            [this](int key) {
+                const Port &port = *m_ports[key];
+                return !port.parked.load() && (port.blocked.load() || port.chunks.size() > 0);
+            });
+        m_parserPool->start();
+    }
+
+    for (const auto &port : m_ports) {
+        Port *p = port.get();
+        p->readerThread.reset(QThread::create([this, p]() { readLoop(*p); }));
+        p->readerThread->setObjectName(QStringLiteral("SerialReader%1").arg(p->id));
+
+        // The reader sits on the USB transfer; give it the edge over the
+        // parser, which can always catch up from the queue
+        p->readerThread->start(QThread::TimeCriticalPriority);
+
+        if (!m_parserPool) {
+            p->parserThread.reset(QThread::create([this, p]() { parseLoop(*p); }));
+            p->parserThread->setObjectName(QStringLiteral("SerialParser%1").arg(p->id));
+            p->parserThread->start();
+        }
+    }
+
+    m_deliveryTimer.start(m_config.deliveryIntervalMs);
+    m_running = true;
+}
+
+void SerialPipeline::stop()
+{
+    if (!m_running)
+        return;
+
+    m_stopping.store(true, std::memory_order_relaxed);
+    for (const auto &port : m_ports) {
+        port->chunksAvailable.release();
+        port->readerThread->wait();
+        port->readerThread.reset();
+        if (port->parserThread) {
+            port->parserThread->wait();
+            port->parserThread.reset();
+        }
+    }
+    m_parserPool.reset();
+
+    m_deliveryTimer.stop();
+    deliver();
+    m_running = false;
+}
+
+SerialPipeline::StageStats SerialPipeline::stageStats(int port, Stage stage) const
+{
+    const Port &p = *m_ports.at(port);
+    const StageCounters &counters = p.stages[int(stage)];
+
+    StageStats stats;
+    stats.batches = counters.batches.load(std::memory_order_relaxed);
+    stats.depth = qint64(stage == Stage::Parse ? p.chunks.size() : p.frames.size());
+    stats.maxDepth = counters.maxDepth.load(std::memory_order_relaxed);
+    stats.totalLatencyUs = counters.totalLatencyUs.load(std::memory_order_relaxed);
+    stats.maxLatencyUs = counters.maxLatencyUs.load(std::memory_order_relaxed);
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+    return stats;
+}
+
+SerialPipeline::ReaderStats SerialPipeline::readerStats(int port) const
+{
+    const Port &p = *m_ports.at(port);
+
+    ReaderStats stats;
+    stats.bytesRead = p.bytesRead.load(std::memory_order_relaxed);
+    stats.bytesDropped = p.bytesDropped.load(std::memory_order_relaxed);
+    stats.fullQueueRetries = p.fullQueueRetries.load(std::memory_order_relaxed);
+    stats.allocations = p.readAllocations.load(std::memory_order_relaxed);
+    return stats;
+}
+
+qint64 SerialPipeline::nowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void SerialPipeline::readLoop(Port &port)
+{
+    ChunkBatch pending;
+
+    while (!m_stopping.load(std::memory_order_relaxed)) {
+        if (!port.port->isOpen()) {
+            QThread::msleep(m_config.readTimeoutMs);
+            continue;
+        }
+
+        {
+            AllocationTracker::Scope allocations(AllocationTracker::Stage::Read);
+            const QByteArray data = port.port->readData(m_config.readChunkSize,
+                                                        m_config.readTimeoutMs);
+            if (!data.isEmpty()) {
+                port.bytesRead.fetch_add(data.size(), std::memory_order_relaxed);
+
+                if (pending.data.size() + data.size() > m_config.maxBatchBytes) {
+                    port.bytesDropped.fetch_add(pending.data.size(), std::memory_order_relaxed);
+                    pending.data.clear();
+                }
+                if (pending.data.isEmpty())
+                    pending.readNs = nowNs();
+                pending.data.append(data);
+            }
+            port.readAllocations.fetch_add(allocations.allocations(), std::memory_order_relaxed);
+        }
+
+        if (pending.data.isEmpty())
+            continue;
+
+        if (port.chunks.tryPush(std::move(pending))) {
+            pending = ChunkBatch();
+            // A parked port is scheduled by deliver() once it has room
+            if (!m_parserPool)
+                port.chunksAvailable.release();
+            else if (!port.parked.load())
+                m_parserPool->schedule(port.id);
+        } else {
+            port.fullQueueRetries.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void SerialPipeline::parseLoop(Port &port)
+{
+    static constexpr int idleWaitMs = 100;
+
+    // Parked by backpressure from the GUI thread, the parser waits like an
+    // idle one; deliver() releases the semaphore when it has made room
+    while (!m_stopping.load(std::memory_order_relaxed)) {
+        if (!parseBatches(port, m_config.parserBatchesPerTurn))
+            port.chunksAvailable.tryAcquire(1, idleWaitMs);
+    }
+}
+
+// Parses up to maxBatches chunk batches of the port, in order. Must not
+// run for the same port on two threads at once. Returns true if more
+// chunks are waiting, false if there are none or the port got parked
+// because the delivery queue is full.
+bool SerialPipeline::parseBatches(Port &port, int maxBatches)
+{
+    if (port.blockedBatch && !pushBlockedBatch(port))
+        return false;
+
+    for (int i = 0; i < maxBatches; i++) {
+        ChunkBatch chunk;
+        if (!port.chunks.tryPop(chunk))
+            return false;
+
+        AllocationTracker::Scope allocations(AllocationTracker::Stage::Parse);
+        FrameBatch batch;
+        batch.readNs = chunk.readNs;
+        batch.checksumErrors = port.parser->parse(chunk.data, chunk.readNs, batch.frames);
+        port.stages[int(Stage::Parse)].record(qint64(port.chunks.size()),
+                                              (nowNs() - chunk.readNs) / 1000);
+        port.stages[int(Stage::Parse)].allocations.fetch_add(allocations.allocations(),
+                                                             std::memory_order_relaxed);
+
+        if (batch.frames.isEmpty() && batch.checksumErrors == 0)
+            continue;
+
+        if (!port.frames.tryPush(std::move(batch))) {
+            port.blockedBatch = std::move(batch);
+            port.blocked.store(true);
+            if (!pushBlockedBatch(port))
+                return false;
+        }
+    }
+
+    return port.chunks.size() > 0;
+}
+
+// Returns true once the blocked batch is in the delivery queue. Otherwise
+// parks the port and returns false.
+bool SerialPipeline::pushBlockedBatch(Port &port)
+{
+    // deliver() pops, then checks the flag; retrying after setting it
+    // means that one of the two sides always sees the other
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (port.frames.tryPush(std::move(*port.blockedBatch))) {
+            port.blockedBatch.reset();
+            port.blocked.store(false);
+            port.parked.store(false);
+            return true;
+        }
+        port.parked.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    return false;
+}
+
+void SerialPipeline::wakeParser(Port &port)
+{
+    if (m_parserPool)
+        m_parserPool->schedule(port.id);
+    else
+        port.chunksAvailable.release();
+}
+
+void SerialPipeline::deliver()
+{
+    for (const auto &port : m_ports) {
+        AllocationTracker::Scope allocations(AllocationTracker::Stage::Publish);
+        QList<SerialFrame> frames;
+        int checksumErrors = 0;
+
+        FrameBatch batch;
+        bool popped = false;
+        while (port->frames.tryPop(batch)) {
+            port->stages[int(Stage::Deliver)].record(qint64(port->frames.size()),
+                                                     (nowNs() - batch.readNs) / 1000);
+            frames.append(std::move(batch.frames));
+            checksumErrors += batch.checksumErrors;
+            popped = true;
+        }
+
+        if (popped) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (port->parked.exchange(false))
+                wakeParser(*port);
+        }
+
+        if (!frames.isEmpty() || checksumErrors > 0)
+            emit framesReady(port->id, frames, checksumErrors);
+        port->stages[int(Stage::Deliver)].allocations.fetch_add(allocations.allocations(),
+                                                                std::memory_order_relaxed);
+    }
+}
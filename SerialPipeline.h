@@ -0,0 +1,176 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef SERIALPIPELINE_H
+#define SERIALPIPELINE_H
+
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "AbstractSerialPort.h"
+#include "FrameParser.h"
+#include "SpscQueue.h"
+#include "WorkStealingPool.h"
+
+// Moves serial data through three stages so that parsing never adds
+// jitter to the USB read loop:
+//
+//   reader thread (per port) -> parser (per port) -> GUI thread
+//
+// The parse stage runs either on one thread per port or, with
+// Config::parserThreads set, on a shared work-stealing pool, which suits
+// many receivers on a hub better.
+//
+// The stages are linked by bounded lock-free queues that carry batches:
+// coalesced chunks from reader to parser, frame lists from parser to
+// delivery. When the parser falls behind, the reader keeps coalescing
+// into its pending batch; once that exceeds maxBatchBytes the oldest
+// data is dropped and counted, never the read loop blocked. When the GUI
+// thread falls behind, the port's parser is parked until delivery has
+// made room in the queue.
+class SerialPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Config {
+        int queueCapacity = 64;
+        int readChunkSize = 4096;
+        int readTimeoutMs = 100;
+        int maxBatchBytes = 64 * 1024;
+        int deliveryIntervalMs = 16;
+        // 0: one parser thread per port
+        int parserThreads = 0;
+        // Chunk batches a pool worker parses before it moves on to the
+        // next port
+        int parserBatchesPerTurn = 4;
+    };
+
+    // Parse consumes the reader->parser queue, Deliver the parser->GUI one
+    enum class Stage {
+        Parse = 0,
+        Deliver,
+        Count
+    };
+
+    // Depth is the number of batches waiting in the stage's input queue.
+    // Latency is measured from the time the data was read to the time the
+    // stage is done with it. Times are in microseconds. Allocations are
+    // only counted with the AllocationTracker built in, and only include
+    // Qt's containers if AllocationTracker::isComplete().
+    struct StageStats {
+        qint64 batches = 0;
+        qint64 depth = 0;
+        qint64 maxDepth = 0;
+        qint64 totalLatencyUs = 0;
+        qint64 maxLatencyUs = 0;
+        qint64 allocations = 0;
+    };
+
+    struct ReaderStats {
+        qint64 bytesRead = 0;
+        qint64 bytesDropped = 0;
+        qint64 fullQueueRetries = 0;
+        qint64 allocations = 0;
+    };
+
+    explicit SerialPipeline(QObject *parent = nullptr);
+    ~SerialPipeline() override;
+
+    Config config() const { return m_config; }
+    // Takes effect for ports added afterwards and on the next start()
+    void setConfig(const Config &config);
+
+    // The pipeline does not own the port; it must stay alive until stop().
+    // Returns the id used in framesReady() and the stats calls.
+    int addPort(AbstractSerialPort *port, std::unique_ptr<FrameParser> parser);
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    StageStats stageStats(int port, Stage stage) const;
+    ReaderStats readerStats(int port) const;
+
+    // Only while running with a parser pool
+    const WorkStealingPool *parserPool() const { return m_parserPool.get(); }
+
+    static qint64 nowNs();
+
+signals:
+    void framesReady(int port, const QList<SerialFrame> &frames, int checksumErrors);
+
+private:
+    struct ChunkBatch {
+        QByteArray data;
+        qint64 readNs = 0;
+    };
+
+    struct FrameBatch {
+        QList<SerialFrame> frames;
+        int checksumErrors = 0;
+        qint64 readNs = 0;
+    };
+
+    struct StageCounters {
+        std::atomic<qint64> batches { 0 };
+        std::atomic<qint64> maxDepth { 0 };
+        std::atomic<qint64> totalLatencyUs { 0 };
+        std::atomic<qint64> maxLatencyUs { 0 };
+        std::atomic<qint64> allocations { 0 };
+
+        void record(qint64 depth, qint64 latencyUs);
+    };
+
+    struct Port {
+        Port(int id, AbstractSerialPort *port, std::unique_ptr<FrameParser> parser,
+             const Config &config);
+
+        const int id;
+        AbstractSerialPort *const port;
+        const std::unique_ptr<FrameParser> parser;
+
+        SpscQueue<ChunkBatch> chunks;
+        SpscQueue<FrameBatch> frames;
+        QSemaphore chunksAvailable;
+        // Parsed, but the delivery queue was full
+        std::optional<FrameBatch> blockedBatch;
+        // blocked mirrors blockedBatch for other threads. parked is set
+        // while the parser waits for deliver() to make room; deliver()
+        // clears it and wakes the parser.
+        std::atomic<bool> blocked { false };
+        std::atomic<bool> parked { false };
+
+        std::unique_ptr<QThread> readerThread;
+        std::unique_ptr<QThread> parserThread;
+
+        StageCounters stages[int(Stage::Count)];
+        std::atomic<qint64> bytesRead { 0 };
+        std::atomic<qint64> bytesDropped { 0 };
+        std::atomic<qint64> fullQueueRetries { 0 };
+        std::atomic<qint64> readAllocations { 0 };
+    };
+
+    void readLoop(Port &port);
+    void parseLoop(Port &port);
+    bool parseBatches(Port &port, int maxBatches);
+    bool pushBlockedBatch(Port &port);
+    void wakeParser(Port &port);
+    void deliver();
+
+    Config m_config;
+    std::vector<std::unique_ptr<Port>> m_ports;
+    std::unique_ptr<WorkStealingPool> m_parserPool;
+    std::atomic<bool> m_stopping { false };
+    bool m_running = false;
+    QTimer m_deliveryTimer;
+};
+
+#endif // SERIALPIPELINE_H
@@ -0,0 +1,250 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "SerialSession.h"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QDebug>
+#include <QtCore/QPromise>
+
+#include <memory>
+#include <utility>
+
+SerialSession::SerialSession(Device *device, QObject *parent)
+    : QObject{ parent }, m_device(device)
+{
+    // A read that waits for data must not hold up a write
+    m_ioPool.setMaxThreadCount(2);
+
+    m_reconnectTimer.setSingleShot(true);
+    connect(&m_reconnectTimer, &QTimer::timeout, this, &SerialSession::tryReconnect);
+}
+
+SerialSession::~SerialSession()
+{
+    close();
+    m_ioPool.waitForDone();
+}
+
+bool SerialSession::open()
+{
+    close();
+
+    if (!m_device->open())
+        return false;
+
+    m_bytesReceived = 0;
+    setState(State::Connected);
+    scheduleRead();
+    return true;
+}
+
+void SerialSession::close()
+{
+    m_generation++;
+    m_reconnectTimer.stop();
+    if (m_state == State::Closed)
+        return;
+
+    setState(State::Closed);
+    m_device->close();
+}
+
+void SerialSession::reopen()
+{
+    handleConnectionLost();
+}
+
+void SerialSession::retryNow()
+{
+    if (m_state == State::Reconnecting && m_reconnectTimer.isActive())
+        m_reconnectTimer.start(0);
+}
+
+qsizetype SerialSession::bytesAvailable() const
+{
+    QMutexLocker locker(&m_bufferMutex);
+    return m_buffer.size();
+}
+
+QByteArray SerialSession::readAll()
+{
+    QMutexLocker locker(&m_bufferMutex);
+    return std::exchange(m_buffer, QByteArray());
+}
+
+QFuture<bool> SerialSession::write(const QByteArray &data, int timeoutMs)
+{
+    return runAsync<bool>([this, data, timeoutMs]() {
+        return m_device->port()->writeData(data, timeoutMs);
+    });
+}
+
+bool SerialSession::isOpen() const
+{
+    return m_open.load(std::memory_order_acquire);
+}
+
+QByteArray SerialSession::readData(int maxLength, int timeoutMs)
+{
+    const QDeadlineTimer deadline(timeoutMs);
+    QMutexLocker locker(&m_bufferMutex);
+    while (m_buffer.isEmpty() && isOpen()) {
+        if (!m_bufferChanged.wait(&m_bufferMutex, deadline))
+            break;
+    }
+
+    if (m_buffer.size() <= maxLength)
+        return std::exchange(m_buffer, QByteArray());
+
+    QByteArray data = m_buffer.left(maxLength);
+    m_buffer.remove(0, maxLength);
+    return data;
+}
+
+bool SerialSession::writeData(const QByteArray &data, int timeoutMs)
+{
+    return m_device->port()->writeData(data, timeoutMs);
+}
+
+int SerialSession::baudRate() const
+{
+    return m_device->port()->baudRate();
+}
+
+bool SerialSession::setBaudRate(int baudRate)
+{
+    return m_device->port()->setBaudRate(baudRate);
+}
+
+bool SerialSession::purgeBuffers(bool purgeReadBuffers, bool purgeWriteBuffers)
+{
+    if (purgeReadBuffers) {
+        QMutexLocker locker(&m_bufferMutex);
+        m_buffer.clear();
+    }
+    return m_device->port()->purgeBuffers(purgeReadBuffers, purgeWriteBuffers);
+}
+
+void SerialSession::setInitialBackoff(int delayMs)
+{
+    m_initialBackoffMs = qMax(1, delayMs);
+}
+
+void SerialSession::setMaxBackoff(int delayMs)
+{
+    m_maxBackoffMs = qMax(1, delayMs);
+}
+
+template <typename T, typename Function>
+QFuture<T> SerialSession::runAsync(Function function)
+{
+    auto promise = std::make_shared<QPromise<T>>();
+    QFuture<T> future = promise->future();
+    promise->start();
+
+    m_ioPool.start([promise, function = std::move(function)]() mutable {
+        promise->addResult(function());
+        promise->finish();
+    });
+    return future;
+}
+
+void SerialSession::setState(State state)
+{
+    if (m_state == state)
+        return;
+    m_state = state;
+
+    {
+        // Under the lock, so that a reader cannot miss the wakeup
+        QMutexLocker locker(&m_bufferMutex);
+        m_open.store(state != State::Closed, std::memory_order_release);
+        m_bufferChanged.wakeAll();
+    }
+    emit stateChanged(state);
+}
+
+void SerialSession::scheduleRead()
+{
+    // A read that was still pending when the connection dropped must not
+    // start a second read loop next to the one of the new connection
+    const quint64 generation = m_generation;
+    runAsync<QByteArray>([this]() {
+        return m_device->port()->readData(readChunkSize, readTimeoutMs);
+    }).then(this, [this, generation](const QByteArray &data) {
+        if (generation != m_generation || m_state != State::Connected)
+            return;
+
+        if (!data.isEmpty()) {
+            m_bytesReceived += data.size();
+            {
+                QMutexLocker locker(&m_bufferMutex);
+                m_buffer.append(data);
+                m_bufferChanged.wakeAll();
+            }
+            emit readyRead();
+        }
+
+        if (m_device->port()->isOpen())
+            scheduleRead();
+        else
+            handleConnectionLost();
+    });
+}
+
+void SerialSession::handleConnectionLost()
+{
+    if (m_state != State::Connected)
+        return;
+
+    qWarning() << "Lost connection to" << m_device->name() << "- reconnecting";
+    m_generation++;
+    m_lostTimer.start();
+    m_attempt = 0;
+    setState(State::Reconnecting);
+    m_device->close();
+    emit connectionLost();
+    scheduleReconnect();
+}
+
+void SerialSession::scheduleReconnect()
+{
+    const int shift = qMin(m_attempt, 16);
+    m_reconnectTimer.start(int(qMin<qint64>(qint64(m_initialBackoffMs) << shift, m_maxBackoffMs)));
+}
+
+void SerialSession::tryReconnect()
+{
+    if (m_state != State::Reconnecting)
+        return;
+
+    m_attempt++;
+
+    const quint64 generation = m_generation;
+    runAsync<bool>([this]() {
+        return m_device->open();
+    }).then(this, [this, generation](bool opened) {
+        // close() or open() since; a connection that came up regardless
+        // must not stay open behind the session's back
+        if (generation != m_generation || m_state != State::Reconnecting) {
+            if (opened && m_state == State::Closed)
+                m_device->close();
+            return;
+        }
+
+        if (!opened) {
+            scheduleReconnect();
+            return;
+        }
+
+        m_lastReconnectTimeMs = m_lostTimer.elapsed();
+        m_reconnectCount++;
+        qDebug() << "Reconnected to" << m_device->name() << "after"
+                 << m_lastReconnectTimeMs << "ms";
+
+        setState(State::Connected);
+        emit reconnected(m_lastReconnectTimeMs);
+        scheduleRead();
+    });
+}
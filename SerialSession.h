@@ -0,0 +1,156 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef SERIALSESSION_H
+#define SERIALSESSION_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFuture>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+#include <QtCore/QWaitCondition>
+
+#include <atomic>
+
+#include "AbstractSerialPort.h"
+
+// Supervised connection to one serial device. Reads run continuously
+// into a buffer owned by the session. When the port goes away (isOpen()
+// turns false, or reopen() is called on a detach broadcast), the session
+// opens the device again with exponential backoff. The buffer and
+// anything consumers keep about the session survive the reconnect; only
+// the time without a connection is lost.
+//
+// Consumers on other threads, like SerialPipeline, can read the session
+// as a port. readData() takes from the same buffer as readAll(), and the
+// port stays open through reconnects until close().
+class SerialSession : public QObject, public AbstractSerialPort
+{
+    Q_OBJECT
+
+    Q_PROPERTY(State state READ state NOTIFY stateChanged)
+    Q_PROPERTY(int reconnectCount READ reconnectCount NOTIFY reconnected)
+    Q_PROPERTY(qint64 lastReconnectTime READ lastReconnectTime NOTIFY reconnected)
+
+public:
+    enum class State {
+        Closed,
+        Connected,
+        Reconnecting
+    };
+
+    Q_ENUM(State)
+
+    // Finds and opens the device behind the session's port, e.g. a USB
+    // adapter matched by VID, PID and serial number. open() is called
+    // again after every connection loss, on the session's I/O thread.
+    // A read or write of the lost connection may still be running then,
+    // so the port has to cope with being reopened underneath it.
+    class Device {
+    public:
+        virtual ~Device() = default;
+
+        // Returns false while the device is missing or cannot be opened yet
+        virtual bool open() = 0;
+        virtual void close() = 0;
+
+        // The same port across reconnects
+        virtual AbstractSerialPort *port() = 0;
+
+        // For log messages
+        virtual QString name() const = 0;
+    };
+
+    // The session does not own \a device; it must outlive the session
+    explicit SerialSession(Device *device, QObject *parent = nullptr);
+    ~SerialSession() override;
+
+    bool open();
+    void close();
+
+    // Drops the current connection and goes through the reconnect logic,
+    // e.g. when the port is open but has stopped delivering data
+    void reopen();
+
+    // Tries to reconnect now instead of after the remaining backoff, e.g.
+    // when the device has just been plugged in again
+    void retryNow();
+
+    State state() const { return m_state; }
+
+    qsizetype bytesAvailable() const;
+
+    // Total number of bytes received since open(), across reconnects
+    qint64 bytesReceived() const { return m_bytesReceived; }
+    QByteArray readAll();
+
+    QFuture<bool> write(const QByteArray &data, int timeoutMs = 1000);
+
+    // AbstractSerialPort; thread-safe. Writes and line settings go to the
+    // device's port directly and fail while it is reconnecting.
+    bool isOpen() const override;
+    QByteArray readData(int maxLength = 1024, int timeoutMs = 1000) override;
+    bool writeData(const QByteArray &data, int timeoutMs = 1000) override;
+    int baudRate() const override;
+    bool setBaudRate(int baudRate) override;
+    bool purgeBuffers(bool purgeReadBuffers = true, bool purgeWriteBuffers = true) override;
+
+    AbstractSerialPort *port() { return m_device->port(); }
+
+    int reconnectCount() const { return m_reconnectCount; }
+
+    // Time in milliseconds between losing and regaining the connection
+    // the last time; an upper bound for the gap in the received data
+    qint64 lastReconnectTime() const { return m_lastReconnectTimeMs; }
+
+    int initialBackoff() const { return m_initialBackoffMs; }
+    void setInitialBackoff(int delayMs);
+
+    int maxBackoff() const { return m_maxBackoffMs; }
+    void setMaxBackoff(int delayMs);
+
+signals:
+    void stateChanged(SerialSession::State state);
+    void readyRead();
+    void connectionLost();
+    void reconnected(qint64 gapMs);
+
+private:
+    static constexpr int readChunkSize = 1024;
+    static constexpr int readTimeoutMs = 200;
+
+    template <typename T, typename Function>
+    QFuture<T> runAsync(Function function);
+
+    void setState(State state);
+    void scheduleRead();
+    void handleConnectionLost();
+    void scheduleReconnect();
+    void tryReconnect();
+
+    Device *m_device;
+    // Reads, writes and reconnect attempts, so that none of them blocks
+    // the thread the session lives in
+    QThreadPool m_ioPool;
+    State m_state = State::Closed;
+    std::atomic<bool> m_open { false };
+    qint64 m_bytesReceived = 0;
+
+    mutable QMutex m_bufferMutex;
+    QWaitCondition m_bufferChanged;
+    QByteArray m_buffer;
+
+    QTimer m_reconnectTimer;
+    QElapsedTimer m_lostTimer;
+    int m_initialBackoffMs = 250;
+    int m_maxBackoffMs = 8000;
+    int m_attempt = 0;
+    quint64 m_generation = 0;
+    int m_reconnectCount = 0;
+    qint64 m_lastReconnectTimeMs = 0;
+};
+
+#endif // SERIALSESSION_H
@@ -0,0 +1,595 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "SimulatedSerialPort.h"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QDebug>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+// CRC-16-CCITT as specified for GDL 90, transmitted LSB first
+quint16 gdl90Crc(const QByteArray &data)
+{
+    static const std::array<quint16, 256> table = []() {
+        std::array<quint16, 256> table {};
+        for (int i = 0; i < 256; i++) {
+            quint16 crc = quint16(i << 8);
+            for (int bit = 0; bit < 8; bit++)
+                crc = quint16((crc << 1) ^ ((crc & 0x8000) ? 0x1021 : 0));
+            table[i] = crc;
+        }
+        return table;
+    }();
+
+    quint16 crc = 0;
+    for (const char c : data)
+        crc = quint16(table[crc >> 8] ^ (crc << 8) ^ quint8(c));
+    return crc;
+}
+
+void appendInt(QByteArray &data, quint32 value, int bytes)
+{
+    for (int i = bytes - 1; i >= 0; i--)
+        data.append(char((value >> (8 * i)) & 0xff));
+}
+
+// Degrees as 24 bit signed semicircles
+quint32 semicircles(double degrees)
+{
+    return quint32(qint32(degrees * (1 << 23) / 180.0)) & 0xffffff;
+}
+
+} // namespace
+
+SimulatedSerialPort::SimulatedSerialPort(quint32 seed)
+    : m_random(seed)
+{
+    applyProfile(nowNs());
+}
+
+void SimulatedSerialPort::setProfile(const Profile &profile)
+{
+    QMutexLocker locker(&m_mutex);
+    const qint64 now = nowNs();
+    advance(now);
+    m_profile = profile;
+    applyProfile(now);
+}
+
+bool SimulatedSerialPort::loadScript(const QString &script)
+{
+    QList<Step> steps;
+    const QStringList lines = script.split(u'\n');
+    for (int i = 0; i < lines.size(); i++) {
+        QString line = lines[i];
+        const qsizetype comment = line.indexOf(u'#');
+        if (comment >= 0)
+            line.truncate(comment);
+        line = line.trimmed();
+        if (line.isEmpty())
+            continue;
+
+        Step step;
+        if (!parseStep(line, i + 1, step))
+            return false;
+        steps.append(step);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    const qint64 now = nowNs();
+    advance(now);
+    m_script = steps;
+    m_scriptPosition = 0;
+    m_scriptWaitUntilNs = now;
+    advance(now);
+    return true;
+}
+
+void SimulatedSerialPort::setReceiveBufferSize(qsizetype bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_receiveBufferSize = bytes;
+}
+
+void SimulatedSerialPort::setResponder(const Responder &responder, int latencyMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_responder = responder;
+    m_responseLatencyNs = qint64(qMax(0, latencyMs)) * 1000000;
+}
+
+void SimulatedSerialPort::dropout(int durationMs)
+{
+    QMutexLocker locker(&m_mutex);
+    const qint64 now = nowNs();
+    advance(now);
+    m_dropoutUntilNs = now + qint64(durationMs) * 1000000;
+    m_stats.dropouts++;
+}
+
+void SimulatedSerialPort::disconnect(int durationMs)
+{
+    QMutexLocker locker(&m_mutex);
+    const qint64 now = nowNs();
+    advance(now);
+    m_disconnectedUntilNs = durationMs > 0 ? now + qint64(durationMs) * 1000000 : never;
+    m_buffer.clear();
+    m_bufferOffset = 0;
+    m_replies.clear();
+    m_stats.disconnects++;
+    m_stateChanged.wakeAll();
+}
+
+void SimulatedSerialPort::reconnect()
+{
+    QMutexLocker locker(&m_mutex);
+    const qint64 now = nowNs();
+    advance(now);
+    if (m_scriptWaitUntilNs == m_disconnectedUntilNs && disconnectedAt(now))
+        m_scriptWaitUntilNs = now;
+    m_disconnectedUntilNs = 0;
+    advance(now);
+    m_stateChanged.wakeAll();
+}
+
+bool SimulatedSerialPort::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return !disconnectedAt(nowNs());
+}
+
+QByteArray SimulatedSerialPort::readData(int maxLength, int timeoutMs)
+{
+    QDeadlineTimer deadline(timeoutMs);
+
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        const qint64 now = nowNs();
+        advance(now);
+        if (disconnectedAt(now))
+            return {};
+
+        const qsizetype available = m_buffer.size() - m_bufferOffset;
+        if (available > 0) {
+            const qsizetype length = qMin<qsizetype>(available, maxLength);
+            const QByteArray data = m_buffer.mid(m_bufferOffset, length);
+            m_bufferOffset += length;
+            if (m_bufferOffset == m_buffer.size()) {
+                m_buffer.clear();
+                m_bufferOffset = 0;
+            } else if (m_bufferOffset > m_receiveBufferSize) {
+                m_buffer.remove(0, m_bufferOffset);
+                m_bufferOffset = 0;
+            }
+            m_stats.bytesRead += length;
+            return data;
+        }
+
+        if (deadline.hasExpired())
+            return {};
+
+        // Sleep until the next message, reply or script step is due
+        QDeadlineTimer wakeUp = deadline;
+        qint64 next = qMin(m_nextMessageNs, m_scriptWaitUntilNs);
+        if (!m_replies.isEmpty())
+            next = qMin(next, m_replies.first().dueNs);
+        if (next != never)
+            wakeUp = qMin(wakeUp, QDeadlineTimer(std::chrono::nanoseconds(next - now)));
+        m_stateChanged.wait(&m_mutex, wakeUp);
+    }
+}
+
+bool SimulatedSerialPort::writeData(const QByteArray &data, int timeoutMs)
+{
+    Q_UNUSED(timeoutMs);
+
+    QMutexLocker locker(&m_mutex);
+    const qint64 now = nowNs();
+    advance(now);
+    if (disconnectedAt(now))
+        return false;
+
+    m_written.append(data);
+    if (m_written.size() > maxWrittenData)
+        m_written.remove(0, m_written.size() - maxWrittenData);
+
+    if (m_responder) {
+        Reply reply;
+        reply.data = m_responder(data);
+        if (!reply.data.isEmpty()) {
+            const qint64 startNs = qMax(now + wireNs(data.size()) + m_responseLatencyNs,
+                                        m_replyLineFreeNs);
+            reply.dueNs = startNs + wireNs(reply.data.size());
+            m_replyLineFreeNs = reply.dueNs;
+            m_replies.append(std::move(reply));
+        }
+    }
+    return true;
+}
+
+int SimulatedSerialPort::baudRate() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_baudRate;
+}
+
+bool SimulatedSerialPort::setBaudRate(int baudRate)
+{
+    if (baudRate <= 0)
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+    advance(nowNs());
+    m_baudRate = baudRate;
+    return true;
+}
+
+QByteArray SimulatedSerialPort::takeWrittenData()
+{
+    QMutexLocker locker(&m_mutex);
+    return std::exchange(m_written, QByteArray());
+}
+
+SimulatedSerialPort::Stats SimulatedSerialPort::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+qint64 SimulatedSerialPort::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// At 8N1 a byte takes ten bit times
+qint64 SimulatedSerialPort::wireNs(qsizetype bytes) const
+{
+    return qint64(bytes) * 10 * 1000000000 / m_baudRate;
+}
+
+bool SimulatedSerialPort::parseStep(const QString &line, int lineNumber, Step &step)
+{
+    const QStringList words = line.split(u' ', Qt::SkipEmptyParts);
+    const QString &command = words.first();
+    step.line = lineNumber;
+
+    auto number = [&](int index, double &value) {
+        bool ok = false;
+        if (index < words.size())
+            value = words[index].toDouble(&ok);
+        if (!ok || value < 0)
+            qWarning() << "Script line" << lineNumber << ": expected a number after" << command;
+        return ok && value >= 0;
+    };
+
+    if (command == u"profile") {
+        static const QList<std::pair<QString, Traffic>> kinds {
+            { QStringLiteral("none"), Traffic::None },
+            { QStringLiteral("nmea"), Traffic::Nmea },
+            { QStringLiteral("flarm"), Traffic::Flarm },
+            { QStringLiteral("gdl90"), Traffic::Gdl90 },
+            { QStringLiteral("burst"), Traffic::RandomBursts },
+        };
+        step.op = Step::SetProfile;
+        const QString kind = words.value(1);
+        const auto it = std::find_if(kinds.cbegin(), kinds.cend(),
+                                     [&](const auto &entry) { return entry.first == kind; });
+        if (it == kinds.cend()) {
+            qWarning() << "Script line" << lineNumber << ": unknown traffic" << kind;
+            return false;
+        }
+        step.traffic = it->second;
+        if (step.traffic == Traffic::None)
+            return true;
+        if (!number(2, step.value))
+            return false;
+        if (step.traffic == Traffic::RandomBursts) {
+            double burstBytes = 512;
+            if (words.size() > 3 && !number(3, burstBytes))
+                return false;
+            step.burstBytes = qMax(1, int(burstBytes));
+        }
+        return true;
+    }
+
+    static const QList<std::pair<QString, Step::Op>> ops {
+        { QStringLiteral("checksum-errors"), Step::ChecksumErrors },
+        { QStringLiteral("baud"), Step::Baud },
+        { QStringLiteral("wait"), Step::Wait },
+        { QStringLiteral("dropout"), Step::Dropout },
+        { QStringLiteral("disconnect"), Step::Disconnect },
+    };
+    for (const auto &[name, op] : ops) {
+        if (command == name) {
+            step.op = op;
+            return number(1, step.value);
+        }
+    }
+
+    if (command == u"repeat") {
+        step.op = Step::Repeat;
+        return true;
+    }
+
+    qWarning() << "Script line" << lineNumber << ": unknown command" << command;
+    return false;
+}
+
+void SimulatedSerialPort::advance(qint64 nowNs)
+{
+    // Script steps and messages are processed in time order, so that a
+    // reader polling rarely sees the same stream as one polling often
+    for (;;) {
+        const qint64 replyNs = m_replies.isEmpty() ? never : m_replies.first().dueNs;
+        const qint64 next = qMin(qMin(m_scriptWaitUntilNs, m_nextMessageNs), replyNs);
+        if (next > nowNs)
+            break;
+        if (m_scriptWaitUntilNs == next)
+            runScript(m_scriptWaitUntilNs);
+        else if (m_nextMessageNs == next)
+            emitMessage(m_nextMessageNs);
+        else
+            deliverReply();
+    }
+}
+
+void SimulatedSerialPort::runScript(qint64 atNs)
+{
+    m_scriptWaitUntilNs = never;
+    bool repeated = false;
+
+    while (m_scriptPosition < m_script.size()) {
+        const Step &step = m_script[m_scriptPosition++];
+        const qint64 durationNs = qint64(step.value * 1000000);
+
+        switch (step.op) {
+        case Step::SetProfile:
+            m_profile.traffic = step.traffic;
+            m_profile.rateHz = step.value;
+            if (step.traffic == Traffic::RandomBursts)
+                m_profile.burstBytes = step.burstBytes;
+            applyProfile(atNs);
+            break;
+        case Step::ChecksumErrors:
+            m_profile.checksumErrorRate = step.value;
+            break;
+        case Step::Baud:
+            if (step.value > 0)
+                m_baudRate = int(step.value);
+            break;
+        case Step::Wait:
+            m_scriptWaitUntilNs = atNs + durationNs;
+            return;
+        case Step::Dropout:
+            m_dropoutUntilNs = atNs + durationNs;
+            m_stats.dropouts++;
+            m_scriptWaitUntilNs = m_dropoutUntilNs;
+            return;
+        case Step::Disconnect:
+            m_disconnectedUntilNs = durationNs > 0 ? atNs + durationNs : never;
+            m_buffer.clear();
+            m_bufferOffset = 0;
+            m_replies.clear();
+            m_stats.disconnects++;
+            m_scriptWaitUntilNs = m_disconnectedUntilNs;
+            m_stateChanged.wakeAll();
+            return;
+        case Step::Repeat:
+            // A loop without any waiting step would never end
+            if (repeated) {
+                qWarning() << "Script repeats without waiting, stopped at line" << step.line;
+                return;
+            }
+            repeated = true;
+            m_scriptPosition = 0;
+            break;
+        }
+    }
+}
+
+void SimulatedSerialPort::applyProfile(qint64 atNs)
+{
+    const bool silent = m_profile.traffic == Traffic::None || m_profile.rateHz <= 0;
+    m_nextMessageNs = silent ? never : atNs;
+}
+
+void SimulatedSerialPort::emitMessage(qint64 atNs)
+{
+    const qint64 intervalNs = qint64(1e9 / m_profile.rateHz);
+
+    // Nothing is received while the line is down
+    if (disconnectedAt(atNs) || atNs < m_dropoutUntilNs) {
+        m_nextMessageNs = atNs + intervalNs;
+        return;
+    }
+
+    QByteArray message;
+    switch (m_profile.traffic) {
+    case Traffic::Nmea:
+        message = nmeaMessage();
+        break;
+    case Traffic::Flarm:
+        message = flarmMessage();
+        break;
+    case Traffic::Gdl90:
+        message = gdl90Message();
+        break;
+    case Traffic::RandomBursts:
+        message = randomBurst();
+        break;
+    case Traffic::None:
+        m_nextMessageNs = never;
+        return;
+    }
+    m_sequence++;
+    m_stats.messages++;
+    m_stats.bytesGenerated += message.size();
+
+    // A message cannot start before the previous one is on the wire
+    m_nextMessageNs = atNs + qMax(intervalNs, wireNs(message.size()));
+
+    receive(std::move(message));
+}
+
+void SimulatedSerialPort::deliverReply()
+{
+    Reply reply = m_replies.takeFirst();
+
+    // Replies are lost like any other traffic while the line is down
+    if (disconnectedAt(reply.dueNs) || reply.dueNs < m_dropoutUntilNs)
+        return;
+
+    m_stats.bytesGenerated += reply.data.size();
+    receive(std::move(reply.data));
+}
+
+// Appends to the receive buffer, losing what does not fit
+void SimulatedSerialPort::receive(QByteArray data)
+{
+    const qsizetype space = qMax<qsizetype>(0, m_receiveBufferSize - (m_buffer.size() - m_bufferOffset));
+    if (data.size() > space) {
+        m_stats.bytesOverflowed += data.size() - space;
+        data.truncate(space);
+    }
+    if (!data.isEmpty()) {
+        m_buffer.append(data);
+        m_stateChanged.wakeAll();
+    }
+}
+
+bool SimulatedSerialPort::disconnectedAt(qint64 atNs) const
+{
+    return atNs < m_disconnectedUntilNs;
+}
+
+QByteArray SimulatedSerialPort::nmeaMessage()
+{
+    const qint64 second = m_sequence / 2;
+    const int hours = int(second / 3600 % 24);
+    const int minutes = int(second / 60 % 60);
+    const int seconds = int(second % 60);
+    // Slow drift north-east, in ddmm.mmmm
+    const double latitude = 4807.0380 + double(second % 600) * 0.001;
+    const double longitude = 1131.0000 + double(second % 600) * 0.0015;
+
+    if (m_sequence % 2 == 0) {
+        return nmeaSentence(QString::asprintf("GPRMC,%02d%02d%02d.00,A,%09.4f,N,%010.4f,E,22.4,84.4,170926,,,A",
+                                              hours, minutes, seconds, latitude, longitude)
+                                .toLatin1());
+    }
+    return nmeaSentence(QString::asprintf("GPGGA,%02d%02d%02d.00,%09.4f,N,%010.4f,E,1,08,0.9,545.4,M,47.0,M,,",
+                                          hours, minutes, seconds, latitude, longitude)
+                            .toLatin1());
+}
+
+QByteArray SimulatedSerialPort::flarmMessage()
+{
+    if (m_sequence % 4 == 0)
+        return nmeaSentence(QByteArrayLiteral("PFLAU,3,1,2,1,0,,0,,,"));
+
+    // Three targets circling at different distances
+    const int target = int(m_sequence % 4);
+    const double angle = double(m_sequence) * 0.05 * target;
+    const int north = int(1000 * target * std::cos(angle));
+    const int east = int(1000 * target * std::sin(angle));
+    return nmeaSentence(QString::asprintf("PFLAA,0,%d,%d,%d,2,DD%04X,%d,,%d,%.1f,1",
+                                          north, east, 50 * target, 0x1000 + target,
+                                          int(angle * 57.3) % 360, 25 + 5 * target, 1.5)
+                            .toLatin1());
+}
+
+QByteArray SimulatedSerialPort::gdl90Message()
+{
+    QByteArray payload;
+    if (m_sequence % 2 == 0) {
+        // Heartbeat: GPS valid, UTC OK, seconds since midnight, no counts
+        const quint32 timestamp = quint32(m_sequence / 2 % 86400);
+        payload.append(char(0x00));
+        payload.append(char(0x81));
+        payload.append(char(0x01 | ((timestamp >> 16) & 1) << 7));
+        payload.append(char(timestamp & 0xff));
+        payload.append(char((timestamp >> 8) & 0xff));
+        appendInt(payload, 0, 2);
+    } else {
+        // Ownship report
+        const double drift = double(m_sequence % 600) * 0.00002;
+        payload.append(char(10));
+        payload.append(char(0x00));
+        appendInt(payload, 0xabcdef, 3);
+        appendInt(payload, semicircles(48.1173 + drift), 3);
+        appendInt(payload, semicircles(11.5167 + drift), 3);
+        // Altitude 1500 ft in 25 ft steps with offset 1000, airborne
+        appendInt(payload, ((1500 + 1000) / 25) << 4 | 0x9, 2);
+        payload.append(char(0x88));
+        // 90 kt, level, track 84 degrees
+        appendInt(payload, (90u << 12) & 0xfff000, 3);
+        payload.append(char(84 * 256 / 360));
+        payload.append(char(0x01));
+        payload.append("DSIM    ", 8);
+        payload.append(char(0x00));
+    }
+
+    quint16 crc = gdl90Crc(payload);
+    if (corruptNext())
+        crc ^= 0x5a5a;
+    payload.append(char(crc & 0xff));
+    payload.append(char(crc >> 8));
+
+    QByteArray frame;
+    frame.reserve(payload.size() + 8);
+    frame.append(char(0x7e));
+    for (const char c : std::as_const(payload)) {
+        if (c == char(0x7e) || c == char(0x7d)) {
+            frame.append(char(0x7d));
+            frame.append(char(c ^ 0x20));
+        } else {
+            frame.append(c);
+        }
+    }
+    frame.append(char(0x7e));
+    return frame;
+}
+
+QByteArray SimulatedSerialPort::randomBurst()
+{
+    const int size = 1 + int(m_random.bounded(quint32(m_profile.burstBytes)));
+    QByteArray burst(size, Qt::Uninitialized);
+    for (char &c : burst)
+        c = char(m_random.generate() & 0xff);
+    return burst;
+}
+
+QByteArray SimulatedSerialPort::nmeaSentence(const QByteArray &body)
+{
+    quint8 checksum = 0;
+    for (const char c : body)
+        checksum ^= quint8(c);
+    if (corruptNext())
+        checksum ^= 0x55;
+
+    QByteArray sentence;
+    sentence.reserve(body.size() + 6);
+    sentence.append('$');
+    sentence.append(body);
+    sentence.append('*');
+    sentence.append(QByteArray::number(checksum, 16).toUpper().rightJustified(2, '0'));
+    sentence.append("\r\n");
+    return sentence;
+}
+
+bool SimulatedSerialPort::corruptNext()
+{
+    if (m_profile.checksumErrorRate <= 0 || m_random.generateDouble() >= m_profile.checksumErrorRate)
+        return false;
+    m_stats.checksumErrors++;
+    return true;
+}
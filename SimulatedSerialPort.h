@@ -0,0 +1,181 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef SIMULATEDSERIALPORT_H
+#define SIMULATEDSERIALPORT_H
+
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QString>
+#include <QtCore/QWaitCondition>
+
+#include <functional>
+#include <limits>
+
+#include "AbstractSerialPort.h"
+
+// In-process serial device producing synthetic traffic, so that code on
+// AbstractSerialPort can be load and soak tested without an adapter.
+//
+// Traffic is generated from the elapsed time whenever the port is read,
+// like bytes arriving on a wire at the current baud rate. A reader that
+// falls behind loses data once the receive buffer is full, as with the
+// FIFO of a real adapter. With the same seed and script, runs produce the
+// same byte stream. A responder turns what is written into replies, so
+// the port can also stand in for a device answering commands.
+//
+// Scripts are line based; '#' starts a comment:
+//
+//     baud 115200
+//     profile nmea 10          # NMEA at 10 sentences per second
+//     checksum-errors 0.01     # fraction of corrupted messages
+//     wait 60000               # keep going for a minute
+//     profile flarm 20
+//     profile gdl90 5
+//     profile burst 50 4096    # 50 random bursts/s, up to 4096 bytes
+//     dropout 2000             # line silent, data lost
+//     disconnect 3000          # isOpen() false, buffered data lost
+//     disconnect 0             # the same until reconnect() is called
+//     repeat                   # start over from the first line
+class SimulatedSerialPort : public AbstractSerialPort {
+public:
+    enum class Traffic {
+        None,
+        Nmea,
+        Flarm,
+        Gdl90,
+        RandomBursts
+    };
+
+    struct Profile {
+        Traffic traffic = Traffic::Nmea;
+        // Messages per second, bursts per second for RandomBursts
+        double rateHz = 1.0;
+        int burstBytes = 512;
+        double checksumErrorRate = 0.0;
+    };
+
+    struct Stats {
+        qint64 messages = 0;
+        qint64 bytesGenerated = 0;
+        qint64 bytesRead = 0;
+        qint64 bytesOverflowed = 0;
+        qint64 checksumErrors = 0;
+        qint64 dropouts = 0;
+        qint64 disconnects = 0;
+    };
+
+    // Returns the device's reply to bytes written to the port, or nothing.
+    // Runs with the port locked and must not call back into it.
+    using Responder = std::function<QByteArray(const QByteArray &written)>;
+
+    explicit SimulatedSerialPort(quint32 seed = 1);
+
+    void setProfile(const Profile &profile);
+
+    // Replaces the running script; returns false and keeps the current
+    // one if the script does not parse
+    bool loadScript(const QString &script);
+
+    void setReceiveBufferSize(qsizetype bytes);
+
+    // Replies arrive \a latencyMs after the written bytes are on the wire,
+    // and take their own wire time at the current baud rate
+    void setResponder(const Responder &responder, int latencyMs = 0);
+
+    // Error injection, effective immediately
+    void dropout(int durationMs);
+    // A duration of 0 keeps the port disconnected until reconnect(). A
+    // script waiting on a disconnect step continues on reconnect().
+    void disconnect(int durationMs = 0);
+    void reconnect();
+
+    bool isOpen() const override;
+    QByteArray readData(int maxLength = 1024, int timeoutMs = 1000) override;
+    bool writeData(const QByteArray &data, int timeoutMs = 1000) override;
+    int baudRate() const override;
+    bool setBaudRate(int baudRate) override;
+
+    // Returns and clears what the code under test has written
+    QByteArray takeWrittenData();
+
+    Stats stats() const;
+
+private:
+    struct Step {
+        enum Op {
+            SetProfile,
+            ChecksumErrors,
+            Baud,
+            Wait,
+            Dropout,
+            Disconnect,
+            Repeat
+        };
+
+        Op op;
+        Traffic traffic = Traffic::None;
+        double value = 0;
+        int burstBytes = 0;
+        int line = 0;
+    };
+
+    struct Reply {
+        qint64 dueNs = 0;
+        QByteArray data;
+    };
+
+    static constexpr qsizetype maxWrittenData = 1024 * 1024;
+    static constexpr qint64 never = std::numeric_limits<qint64>::max();
+
+    static qint64 nowNs();
+    qint64 wireNs(qsizetype bytes) const;
+    static bool parseStep(const QString &line, int lineNumber, Step &step);
+
+    // Generates everything due up to nowNs; all of these expect m_mutex
+    void advance(qint64 nowNs);
+    void runScript(qint64 atNs);
+    void applyProfile(qint64 atNs);
+    void emitMessage(qint64 atNs);
+    void deliverReply();
+    void receive(QByteArray data);
+    bool disconnectedAt(qint64 atNs) const;
+
+    QByteArray nmeaMessage();
+    QByteArray flarmMessage();
+    QByteArray gdl90Message();
+    QByteArray randomBurst();
+    QByteArray nmeaSentence(const QByteArray &body);
+    bool corruptNext();
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_stateChanged;
+    QRandomGenerator m_random;
+
+    Profile m_profile;
+    int m_baudRate = 115200;
+    qsizetype m_receiveBufferSize = 64 * 1024;
+
+    QList<Step> m_script;
+    qsizetype m_scriptPosition = 0;
+    qint64 m_scriptWaitUntilNs = never;
+
+    qint64 m_nextMessageNs = never;
+    qint64 m_dropoutUntilNs = 0;
+    qint64 m_disconnectedUntilNs = 0;
+    qint64 m_sequence = 0;
+
+    QByteArray m_buffer;
+    qsizetype m_bufferOffset = 0;
+    QByteArray m_written;
+
+    Responder m_responder;
+    qint64 m_responseLatencyNs = 0;
+    // Replies in order of arrival; the line carries one at a time
+    QList<Reply> m_replies;
+    qint64 m_replyLineFreeNs = 0;
+
+    Stats m_stats;
+};
+
+#endif // SIMULATEDSERIALPORT_H
@@ -0,0 +1,308 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "TermiosSerialPort.h"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QDebug>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "IoReactor.h"
+
+namespace {
+
+speed_t speedForBaudRate(int baudRate)
+{
+    switch (baudRate) {
+    case 1200: return B1200;
+    case 2400: return B2400;
+    case 4800: return B4800;
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 500000: return B500000;
+    case 921600: return B921600;
+    case 1000000: return B1000000;
+    case 2000000: return B2000000;
+    case 3000000: return B3000000;
+    case 4000000: return B4000000;
+    default: return B0;
+    }
+}
+
+bool configure(int fd, int baudRate)
+{
+    const speed_t speed = speedForBaudRate(baudRate);
+    if (speed == B0) {
+        qWarning() << "Unsupported baud rate" << baudRate;
+        return false;
+    }
+
+    termios tio {};
+    if (tcgetattr(fd, &tio) != 0)
+        return false;
+
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+    tio.c_iflag &= ~(IXON | IXOFF | IXANY);
+    // With VMIN 0 a non-blocking read of an empty tty returns 0 instead of
+    // EAGAIN, which is indistinguishable from a hang-up
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        qWarning() << "tcsetattr failed:" << strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+TermiosSerialPort::TermiosSerialPort(IoReactor *reactor)
+    : m_reactor(reactor)
+{
+}
+
+TermiosSerialPort::~TermiosSerialPort()
+{
+    close();
+}
+
+bool TermiosSerialPort::open(const QString &path, int baudRate)
+{
+    close();
+
+    const int fd = ::open(path.toLocal8Bit().constData(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        qWarning() << "Failed to open" << path << ":" << strerror(errno);
+        return false;
+    }
+    if (!configure(fd, baudRate)) {
+        ::close(fd);
+        return false;
+    }
+    tcflush(fd, TCIOFLUSH);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_fd = fd;
+        m_baudRate = baudRate;
+        m_path = path;
+        m_failed = false;
+    }
+
+    if (m_reactor
+        && !m_reactor->add(fd, [this](ChunkPool::Chunk *chunk) { onChunk(chunk); },
+                           [this](int error) { onError(error); })) {
+        close();
+        return false;
+    }
+
+    qDebug() << "Opened" << path << "at" << baudRate << "baud";
+    return true;
+}
+
+void TermiosSerialPort::close()
+{
+    QMutexLocker fdLocker(&m_fdMutex);
+    int fd;
+    {
+        QMutexLocker locker(&m_mutex);
+        fd = m_fd;
+        m_fd = -1;
+    }
+    if (fd < 0)
+        return;
+
+    if (m_reactor)
+        m_reactor->remove(fd);
+    ::close(fd);
+    fdLocker.unlock();
+
+    QMutexLocker locker(&m_mutex);
+    releaseChunks();
+    m_dataAvailable.wakeAll();
+}
+
+bool TermiosSerialPort::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_fd >= 0 && !m_failed;
+}
+
+QByteArray TermiosSerialPort::readData(int maxLength, int timeoutMs)
+{
+    if (m_reactor)
+        return readBuffered(maxLength, timeoutMs);
+
+    int fd;
+    {
+        QMutexLocker locker(&m_mutex);
+        fd = m_fd;
+    }
+    if (fd < 0)
+        return {};
+
+    pollfd pfd { fd, POLLIN, 0 };
+    if (poll(&pfd, 1, timeoutMs) <= 0)
+        return {};
+
+    QByteArray buffer(maxLength, Qt::Uninitialized);
+    const ssize_t bytes = ::read(fd, buffer.data(), size_t(maxLength));
+    if (bytes <= 0) {
+        if (bytes == 0 || (errno != EAGAIN && errno != EINTR))
+            onError(bytes == 0 ? 0 : errno);
+        return {};
+    }
+    buffer.truncate(bytes);
+    return buffer;
+}
+
+QByteArray TermiosSerialPort::readBuffered(int maxLength, int timeoutMs)
+{
+    QDeadlineTimer deadline(timeoutMs);
+
+    QMutexLocker locker(&m_mutex);
+    while (m_bufferedBytes == 0 && m_fd >= 0 && !m_failed) {
+        if (!m_dataAvailable.wait(&m_mutex, deadline))
+            break;
+    }
+    if (m_bufferedBytes == 0)
+        return {};
+
+    QByteArray result;
+    result.reserve(qMin<qsizetype>(maxLength, m_bufferedBytes));
+    while (!m_chunks.empty() && result.size() < maxLength) {
+        ChunkPool::Chunk *chunk = m_chunks.front();
+        const qsizetype take = qMin(chunk->size - m_chunkOffset, maxLength - result.size());
+        result.append(chunk->data + m_chunkOffset, take);
+        m_chunkOffset += take;
+        if (m_chunkOffset == chunk->size) {
+            m_chunks.pop_front();
+            m_chunkOffset = 0;
+            m_reactor->chunkPool().release(chunk);
+        }
+    }
+    m_bufferedBytes -= result.size();
+    return result;
+}
+
+bool TermiosSerialPort::writeData(const QByteArray &data, int timeoutMs)
+{
+    int fd;
+    {
+        QMutexLocker locker(&m_mutex);
+        fd = m_fd;
+    }
+    if (fd < 0)
+        return false;
+
+    QDeadlineTimer deadline(timeoutMs);
+    qsizetype written = 0;
+    while (written < data.size()) {
+        const ssize_t bytes = ::write(fd, data.constData() + written, size_t(data.size() - written));
+        if (bytes > 0) {
+            written += bytes;
+            continue;
+        }
+        if (bytes < 0 && errno == EINTR)
+            continue;
+        if (bytes < 0 && errno != EAGAIN) {
+            qWarning() << "Write to" << m_path << "failed:" << strerror(errno);
+            return false;
+        }
+
+        pollfd pfd { fd, POLLOUT, 0 };
+        if (poll(&pfd, 1, int(deadline.remainingTime())) <= 0) {
+            qWarning() << "Write to" << m_path << "timed out";
+            return false;
+        }
+    }
+    return true;
+}
+
+int TermiosSerialPort::baudRate() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_baudRate;
+}
+
+bool TermiosSerialPort::setBaudRate(int baudRate)
+{
+    // Keeps close() from closing the fd, whose number could then be
+    // reused by another open(), while the output drains
+    QMutexLocker fdLocker(&m_fdMutex);
+    int fd;
+    {
+        QMutexLocker locker(&m_mutex);
+        fd = m_fd;
+    }
+    if (fd < 0)
+        return false;
+
+    // Let pending output go out at the old rate first. That can take a
+    // while at low rates, and the reactor thread must not be held up on
+    // m_mutex meanwhile.
+    tcdrain(fd);
+
+    QMutexLocker locker(&m_mutex);
+    if (!configure(fd, baudRate))
+        return false;
+    m_baudRate = baudRate;
+    return true;
+}
+
+qsizetype TermiosSerialPort::bytesBuffered() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_bufferedBytes;
+}
+
+void TermiosSerialPort::onChunk(ChunkPool::Chunk *chunk)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_fd < 0) {
+        m_reactor->chunkPool().release(chunk);
+        return;
+    }
+    m_chunks.push_back(chunk);
+    m_bufferedBytes += chunk->size;
+    m_dataAvailable.wakeAll();
+}
+
+void TermiosSerialPort::onError(int error)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_failed)
+        return;
+    m_failed = true;
+    if (error != 0)
+        qWarning() << "Read from" << m_path << "failed:" << strerror(error);
+    else
+        qWarning() << m_path << "hung up";
+    m_dataAvailable.wakeAll();
+}
+
+void TermiosSerialPort::releaseChunks()
+{
+    for (ChunkPool::Chunk *chunk : m_chunks)
+        m_reactor->chunkPool().release(chunk);
+    m_chunks.clear();
+    m_chunkOffset = 0;
+    m_bufferedBytes = 0;
+}
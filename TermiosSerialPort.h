@@ -0,0 +1,63 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef TERMIOSSERIALPORT_H
+#define TERMIOSSERIALPORT_H
+
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QWaitCondition>
+
+#include <deque>
+
+#include "AbstractSerialPort.h"
+#include "ChunkPool.h"
+
+class IoReactor;
+
+// Serial port on a Linux tty device (/dev/ttyUSB*, /dev/ttyACM*, pty
+// pairs), raw 8N1 without flow control. Without a reactor, readData()
+// polls the fd itself. With a reactor, the reactor thread collects the
+// incoming data and readData() only hands out what has been buffered.
+class TermiosSerialPort : public AbstractSerialPort {
+public:
+    explicit TermiosSerialPort(IoReactor *reactor = nullptr);
+    ~TermiosSerialPort() override;
+
+    TermiosSerialPort(const TermiosSerialPort &) = delete;
+    TermiosSerialPort &operator=(const TermiosSerialPort &) = delete;
+
+    bool open(const QString &path, int baudRate = 9600);
+    void close();
+
+    bool isOpen() const override;
+    QByteArray readData(int maxLength = 1024, int timeoutMs = 1000) override;
+    bool writeData(const QByteArray &data, int timeoutMs = 1000) override;
+    int baudRate() const override;
+    bool setBaudRate(int baudRate) override;
+
+    // Bytes collected by the reactor and not yet read
+    qsizetype bytesBuffered() const;
+
+private:
+    QByteArray readBuffered(int maxLength, int timeoutMs);
+    void onChunk(ChunkPool::Chunk *chunk);
+    void onError(int error);
+    void releaseChunks();
+
+    IoReactor *const m_reactor;
+
+    // Held by close() and by calls that block on the fd outside m_mutex
+    QMutex m_fdMutex;
+    mutable QMutex m_mutex;
+    QWaitCondition m_dataAvailable;
+    int m_fd = -1;
+    int m_baudRate = 0;
+    QString m_path;
+
+    std::deque<ChunkPool::Chunk *> m_chunks;
+    qsizetype m_chunkOffset = 0;
+    qsizetype m_bufferedBytes = 0;
+    bool m_failed = false;
+};
+
+#endif // TERMIOSSERIALPORT_H
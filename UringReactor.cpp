@@ -0,0 +1,406 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "UringReactor.h"
+
+#include <QtCore/QDebug>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+quint64 userData(quint64 id, quint64 tag)
+{
+    return (id << 2) | tag;
+}
+
+unsigned loadAcquire(const unsigned *value)
+{
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+void storeRelease(unsigned *value, unsigned newValue)
+{
+    __atomic_store_n(value, newValue, __ATOMIC_RELEASE);
+}
+
+} // namespace
+
+UringReactor::UringReactor()
+    : IoReactor("UringReactor")
+{
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeFd < 0 || !setupRing()) {
+        if (m_ringFd >= 0) {
+            ::close(m_ringFd);
+            m_ringFd = -1;
+        }
+        return;
+    }
+    registerBuffers();
+}
+
+UringReactor::~UringReactor()
+{
+    stop();
+
+    // Closing the ring cancels whatever is still in flight
+    if (m_ringFd >= 0)
+        ::close(m_ringFd);
+    if (m_sqes)
+        munmap(m_sqes, m_sqesSize);
+    if (m_cqRing && m_cqRing != m_sqRing)
+        munmap(m_cqRing, m_cqRingSize);
+    if (m_sqRing)
+        munmap(m_sqRing, m_sqRingSize);
+    if (m_wakeFd >= 0)
+        ::close(m_wakeFd);
+}
+
+bool UringReactor::setupRing()
+{
+    io_uring_params params {};
+    m_ringFd = int(syscall(__NR_io_uring_setup, ringEntries, &params));
+    if (m_ringFd < 0)
+        return false;
+
+    // Reads use the current file position, i.e. offset -1, which also
+    // works on ttys
+    if (!(params.features & IORING_FEAT_RW_CUR_POS) || !(params.features & IORING_FEAT_NODROP)) {
+        qDebug() << "io_uring lacks required features" << Qt::hex << params.features;
+        return false;
+    }
+
+    m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap)
+        m_sqRingSize = m_cqRingSize = qMax(m_sqRingSize, m_cqRingSize);
+
+    m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    m_ringFd, IORING_OFF_SQ_RING);
+    if (m_sqRing == MAP_FAILED) {
+        m_sqRing = nullptr;
+        return false;
+    }
+    if (singleMmap) {
+        m_cqRing = m_sqRing;
+    } else {
+        m_cqRing = mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        m_ringFd, IORING_OFF_CQ_RING);
+        if (m_cqRing == MAP_FAILED) {
+            m_cqRing = nullptr;
+            return false;
+        }
+    }
+
+    m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      m_ringFd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+        return false;
+    m_sqes = static_cast<io_uring_sqe *>(sqes);
+
+    auto *sq = static_cast<char *>(m_sqRing);
+    m_sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    m_sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    m_sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    m_sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    m_sqEntries = params.sq_entries;
+
+    auto *cq = static_cast<char *>(m_cqRing);
+    m_cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    m_cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+}
+
+void UringReactor::registerBuffers()
+{
+    const std::vector<ChunkPool::Chunk *> chunks = m_chunkPool.chunks();
+    std::vector<iovec> buffers;
+    buffers.reserve(chunks.size());
+    for (ChunkPool::Chunk *chunk : chunks)
+        buffers.push_back({ chunk->data, size_t(ChunkPool::chunkCapacity) });
+
+    // Fails if the pinned memory exceeds RLIMIT_MEMLOCK; plain reads into
+    // the same chunks still work then
+    if (syscall(__NR_io_uring_register, m_ringFd, IORING_REGISTER_BUFFERS,
+                buffers.data(), unsigned(buffers.size())) != 0) {
+        qDebug() << "Could not register read buffers:" << strerror(errno);
+        return;
+    }
+    m_registeredChunks = int(chunks.size());
+}
+
+bool UringReactor::add(int fd, ReadHandler onRead, ErrorHandler onError)
+{
+    if (!isValid())
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+    if (m_ports.contains(fd) || m_ports.size() >= maxPorts) {
+        qWarning() << "Cannot watch fd" << fd;
+        return false;
+    }
+
+    auto registration = std::make_shared<Registration>();
+    registration->id = m_nextId++;
+    registration->fd = fd;
+    registration->onRead = std::move(onRead);
+    registration->onError = std::move(onError);
+    m_ports.insert(fd, registration->id);
+    m_pendingAdds.push_back(std::move(registration));
+
+    if (isRunning())
+        wake();
+    return true;
+}
+
+void UringReactor::remove(int fd)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_ports.contains(fd))
+        return;
+    m_pendingRemoves.push_back(m_ports.take(fd));
+    const quint64 generation = ++m_requestedGeneration;
+
+    if (!isRunning() || isReactorThread()) {
+        // Nobody else touches the rings now
+        locker.unlock();
+        applyPending();
+        return;
+    }
+
+    // Once the reactor thread applied the removal, it does not call the
+    // handlers anymore
+    wake();
+    while (m_appliedGeneration < generation)
+        m_applied.wait(&m_mutex);
+}
+
+void UringReactor::wake()
+{
+    const quint64 one = 1;
+    [[maybe_unused]] const ssize_t written = ::write(m_wakeFd, &one, sizeof(one));
+}
+
+void UringReactor::run()
+{
+    armWake();
+
+    while (!stopping()) {
+        applyPending();
+
+        if (enter(1) < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                continue;
+            qWarning() << "io_uring_enter failed:" << strerror(errno);
+            return;
+        }
+
+        unsigned head = *m_cqHead;
+        const unsigned tail = loadAcquire(m_cqTail);
+        const int count = int(tail - head);
+        for (; head != tail; head++) {
+            const io_uring_cqe &cqe = m_cqes[head & m_cqMask];
+            const quint64 data = cqe.user_data;
+            const int result = cqe.res;
+            // Hand the slot back first: handlers may queue new requests
+            storeRelease(m_cqHead, head + 1);
+            handleCompletion(data, result);
+        }
+        countWakeup(count, std::exchange(m_syscallsSinceWakeup, 0));
+    }
+}
+
+io_uring_sqe *UringReactor::nextSqe()
+{
+    reserveSqes(1);
+
+    const unsigned tail = *m_sqTail;
+    const unsigned index = tail & m_sqMask;
+    io_uring_sqe *sqe = &m_sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    m_sqArray[index] = index;
+    storeRelease(m_sqTail, tail + 1);
+    m_queuedSqes++;
+    return sqe;
+}
+
+void UringReactor::reserveSqes(unsigned count)
+{
+    while (*m_sqTail - loadAcquire(m_sqHead) + count > m_sqEntries) {
+        if (enter(0) < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+            return;
+    }
+}
+
+int UringReactor::enter(unsigned waitFor)
+{
+    const int submitted = int(syscall(__NR_io_uring_enter, m_ringFd, m_queuedSqes, waitFor,
+                                      waitFor > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+    m_syscallsSinceWakeup++;
+    if (submitted > 0)
+        m_queuedSqes -= unsigned(submitted);
+    return submitted;
+}
+
+void UringReactor::armWake()
+{
+    io_uring_sqe *sqe = nextSqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = m_wakeFd;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = userData(0, quint64(Tag::Wake));
+}
+
+void UringReactor::armRead(Registration *registration)
+{
+    reserveSqes(2);
+
+    // The fd is non-blocking, so a read on an empty tty would fail with
+    // EAGAIN; the linked poll delays it until there is data
+    io_uring_sqe *poll = nextSqe();
+    poll->opcode = IORING_OP_POLL_ADD;
+    poll->fd = registration->fd;
+    poll->poll32_events = POLLIN;
+    poll->flags = IOSQE_IO_LINK;
+    poll->user_data = userData(registration->id, quint64(Tag::Poll));
+
+    ChunkPool::Chunk *chunk = acquireChunk();
+    registration->chunk = chunk;
+    registration->pollError = 0;
+
+    io_uring_sqe *read = nextSqe();
+    if (!isDiscardChunk(chunk) && chunk->index < m_registeredChunks) {
+        read->opcode = IORING_OP_READ_FIXED;
+        read->buf_index = quint16(chunk->index);
+    } else {
+        read->opcode = IORING_OP_READ;
+    }
+    read->fd = registration->fd;
+    read->addr = reinterpret_cast<quint64>(chunk->data);
+    read->len = unsigned(ChunkPool::chunkCapacity);
+    read->off = quint64(-1);
+    read->user_data = userData(registration->id, quint64(Tag::Read));
+}
+
+void UringReactor::cancel(const Registration *registration)
+{
+    // Cancelling the poll also cancels the linked read; the read itself is
+    // cancelled in case the poll has already completed
+    for (const Tag tag : { Tag::Poll, Tag::Read }) {
+        io_uring_sqe *sqe = nextSqe();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = userData(registration->id, quint64(tag));
+        sqe->user_data = userData(registration->id, quint64(Tag::Cancel));
+    }
+}
+
+void UringReactor::handleCompletion(quint64 data, int result)
+{
+    const auto tag = Tag(data & 3);
+    if (tag == Tag::Wake) {
+        quint64 value;
+        [[maybe_unused]] const ssize_t bytes = ::read(m_wakeFd, &value, sizeof(value));
+        m_syscallsSinceWakeup++;
+        if (!stopping())
+            armWake();
+        return;
+    }
+
+    const std::shared_ptr<Registration> registration = m_registrations.value(data >> 2);
+    if (!registration || tag == Tag::Cancel)
+        return;
+
+    if (tag == Tag::Poll) {
+        if (result < 0 && result != -ECANCELED)
+            registration->pollError = -result;
+        return;
+    }
+
+    ChunkPool::Chunk *chunk = registration->chunk;
+    registration->chunk = nullptr;
+    countRead(result);
+
+    if (registration->removed) {
+        releaseChunk(chunk);
+        m_registrations.remove(registration->id);
+        return;
+    }
+
+    if (result > 0) {
+        if (isDiscardChunk(chunk)) {
+            countDropped(result);
+        } else {
+            chunk->size = result;
+            registration->onRead(chunk);
+        }
+        if (!registration->removed)
+            armRead(registration.get());
+        return;
+    }
+
+    releaseChunk(chunk);
+    if (result == -EAGAIN || result == -EINTR || (result == -ECANCELED && registration->pollError == 0)) {
+        armRead(registration.get());
+        return;
+    }
+
+    // 0 is end of file: the tty has gone away. The registration stays
+    // until remove(), but nothing is read anymore.
+    const int error = result == -ECANCELED ? registration->pollError : -result;
+    registration->onError(error);
+}
+
+void UringReactor::applyPending()
+{
+    std::vector<std::shared_ptr<Registration>> adds;
+    std::vector<quint64> removes;
+    quint64 generation;
+    {
+        QMutexLocker locker(&m_mutex);
+        adds.swap(m_pendingAdds);
+        removes.swap(m_pendingRemoves);
+        generation = m_requestedGeneration;
+    }
+
+    for (const auto &registration : adds) {
+        m_registrations.insert(registration->id, registration);
+        armRead(registration.get());
+    }
+    for (const quint64 id : removes)
+        applyRemove(id);
+
+    QMutexLocker locker(&m_mutex);
+    m_appliedGeneration = qMax(m_appliedGeneration, generation);
+    m_applied.wakeAll();
+}
+
+void UringReactor::applyRemove(quint64 id)
+{
+    const std::shared_ptr<Registration> registration = m_registrations.value(id);
+    if (!registration)
+        return;
+
+    registration->removed = true;
+    if (registration->chunk) {
+        // Forgotten once the cancelled read completes
+        cancel(registration.get());
+    } else {
+        m_registrations.remove(id);
+    }
+}
@@ -0,0 +1,117 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef URINGREACTOR_H
+#define URINGREACTOR_H
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+
+#include <vector>
+
+#include "IoReactor.h"
+
+struct io_uring_cqe;
+struct io_uring_sqe;
+
+// Reactor on io_uring. Every port has a poll linked to a read in flight.
+// Follow-up requests are queued while completions are handled, and one
+// io_uring_enter() per wakeup submits them for all ports and waits for
+// the next completions. Reads go into the chunk pool's preallocated
+// chunks, which are registered with the kernel as fixed buffers.
+//
+// Only the reactor thread touches the rings; add() and remove() hand
+// their requests over to it.
+class UringReactor : public IoReactor {
+public:
+    static constexpr int maxPorts = 64;
+
+    UringReactor();
+    ~UringReactor() override;
+
+    bool isValid() const override { return m_ringFd >= 0; }
+
+    bool add(int fd, ReadHandler onRead, ErrorHandler onError) override;
+    void remove(int fd) override;
+
+protected:
+    void run() override;
+    void wake() override;
+
+private:
+    struct Registration {
+        quint64 id;
+        int fd;
+        ReadHandler onRead;
+        ErrorHandler onError;
+        // Buffer of the read in flight
+        ChunkPool::Chunk *chunk = nullptr;
+        int pollError = 0;
+        bool removed = false;
+    };
+
+    enum class Tag : quint64 {
+        Wake = 0,
+        Poll,
+        Read,
+        Cancel
+    };
+
+    static constexpr unsigned ringEntries = 256;
+
+    bool setupRing();
+    void registerBuffers();
+
+    io_uring_sqe *nextSqe();
+    // Makes sure that count SQEs can be queued back to back
+    void reserveSqes(unsigned count);
+    int enter(unsigned waitFor);
+
+    void armWake();
+    void armRead(Registration *registration);
+    void cancel(const Registration *registration);
+    void handleCompletion(quint64 userData, int result);
+
+    void applyPending();
+    void applyRemove(quint64 id);
+
+    int m_ringFd = -1;
+    int m_wakeFd = -1;
+
+    void *m_sqRing = nullptr;
+    size_t m_sqRingSize = 0;
+    void *m_cqRing = nullptr;
+    size_t m_cqRingSize = 0;
+    io_uring_sqe *m_sqes = nullptr;
+    size_t m_sqesSize = 0;
+
+    unsigned *m_sqHead = nullptr;
+    unsigned *m_sqTail = nullptr;
+    unsigned *m_sqArray = nullptr;
+    unsigned m_sqMask = 0;
+    unsigned m_sqEntries = 0;
+    unsigned *m_cqHead = nullptr;
+    unsigned *m_cqTail = nullptr;
+    unsigned m_cqMask = 0;
+    io_uring_cqe *m_cqes = nullptr;
+
+    unsigned m_queuedSqes = 0;
+    // io_uring_enter() and eventfd reads, reported with the next wakeup
+    int m_syscallsSinceWakeup = 0;
+    int m_registeredChunks = 0;
+
+    // Owned by the reactor thread while it runs
+    QHash<quint64, std::shared_ptr<Registration>> m_registrations;
+
+    QMutex m_mutex;
+    QWaitCondition m_applied;
+    std::vector<std::shared_ptr<Registration>> m_pendingAdds;
+    std::vector<quint64> m_pendingRemoves;
+    // Registration ids by fd
+    QHash<int, quint64> m_ports;
+    quint64 m_nextId = 1;
+    quint64 m_requestedGeneration = 0;
+    quint64 m_appliedGeneration = 0;
+};
+
+#endif // URINGREACTOR_H
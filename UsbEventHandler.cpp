@@ -0,0 +1,28 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "UsbEventHandler.h"
+
+UsbEventHandler *UsbEventHandler::instance()
+{
+    static UsbEventHandler handler;
+    return &handler;
+}
+
+void UsbEventHandler::onDeviceAttached(const QString &deviceName, int vendorId, int productId,
+                                       int deviceClass)
+{
+    Q_UNUSED(deviceClass);
+    emit deviceAttached(deviceName, vendorId, productId);
+}
+
+void UsbEventHandler::onDeviceDetached(const QString &deviceName)
+{
+    emit deviceDetached(deviceName);
+}
+
+void UsbEventHandler::onAppStartedByDevice(const QString &deviceName, int vendorId,
+                                           int productId, const QString &driverName)
+{
+    emit appStartedByDevice(deviceName, vendorId, productId, driverName);
+}
@@ -0,0 +1,35 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef USBEVENTHANDLER_H
+#define USBEVENTHANDLER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+// Forwards the USB attach/detach broadcasts that reach the native side to
+// Qt signals. The on...() calls come from the Android main thread; the
+// signals are delivered queued to receivers living in other threads.
+class UsbEventHandler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static UsbEventHandler *instance();
+
+    void onDeviceAttached(const QString &deviceName, int vendorId, int productId,
+                          int deviceClass);
+    void onDeviceDetached(const QString &deviceName);
+    void onAppStartedByDevice(const QString &deviceName, int vendorId, int productId,
+                              const QString &driverName);
+
+signals:
+    void deviceAttached(const QString &deviceName, int vendorId, int productId);
+    void deviceDetached(const QString &deviceName);
+    void appStartedByDevice(const QString &deviceName, int vendorId, int productId,
+                            const QString &driverName);
+
+private:
+    UsbEventHandler() = default;
+};
+
+#endif // USBEVENTHANDLER_H
@@ -0,0 +1,72 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "UsbFs.h"
+
+#include <QtCore/QDeadlineTimer>
+
+#include <cerrno>
+
+#include <poll.h>
+#include <sys/ioctl.h>
+
+namespace {
+
+class SystemUsbFs final : public UsbFs {
+public:
+    int submitUrb(int fd, usbdevfs_urb *urb) override
+    {
+        return result(ioctl(fd, USBDEVFS_SUBMITURB, urb));
+    }
+
+    int discardUrb(int fd, usbdevfs_urb *urb) override
+    {
+        return result(ioctl(fd, USBDEVFS_DISCARDURB, urb));
+    }
+
+    int reapUrb(int fd, usbdevfs_urb **urb, int timeoutMs) override
+    {
+        // usbfs reports completed URBs as the fd being writable
+        QDeadlineTimer deadline(timeoutMs);
+        for (;;) {
+            if (ioctl(fd, USBDEVFS_REAPURBNDELAY, urb) == 0)
+                return 0;
+            if (errno != EAGAIN)
+                return -errno;
+
+            pollfd pfd { fd, POLLOUT, 0 };
+            const int ready = poll(&pfd, 1, int(deadline.remainingTime()));
+            if (ready == 0)
+                return -ETIMEDOUT;
+            if (ready < 0 && errno != EINTR)
+                return -errno;
+        }
+    }
+
+    int bulkTransfer(int fd, unsigned endpoint, void *data, unsigned length,
+                     unsigned timeoutMs) override
+    {
+        usbdevfs_bulktransfer transfer {};
+        transfer.ep = endpoint;
+        transfer.len = length;
+        transfer.timeout = timeoutMs;
+        transfer.data = data;
+        return result(ioctl(fd, USBDEVFS_BULK, &transfer));
+    }
+
+    int clearHalt(int fd, unsigned endpoint) override
+    {
+        return result(ioctl(fd, USBDEVFS_CLEAR_HALT, &endpoint));
+    }
+
+private:
+    static int result(int value) { return value < 0 ? -errno : value; }
+};
+
+} // namespace
+
+UsbFs *UsbFs::system()
+{
+    static SystemUsbFs usbFs;
+    return &usbFs;
+}
@@ -0,0 +1,29 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef USBFS_H
+#define USBFS_H
+
+#include <linux/usbdevice_fs.h>
+
+// The usbfs requests used by UsbFsTransport, so that a mock can replace
+// the kernel when testing the transport on a host without the device.
+// All calls return 0, or the transferred length where noted, on success
+// and a negative errno on failure.
+class UsbFs {
+public:
+    virtual ~UsbFs() = default;
+
+    // The ioctls on the device fd
+    static UsbFs *system();
+
+    virtual int submitUrb(int fd, usbdevfs_urb *urb) = 0;
+    virtual int discardUrb(int fd, usbdevfs_urb *urb) = 0;
+    // Waits up to timeoutMs for a completed URB; -ETIMEDOUT if none
+    virtual int reapUrb(int fd, usbdevfs_urb **urb, int timeoutMs) = 0;
+    // Synchronous bulk transfer; returns the transferred length
+    virtual int bulkTransfer(int fd, unsigned endpoint, void *data, unsigned length,
+                             unsigned timeoutMs) = 0;
+    virtual int clearHalt(int fd, unsigned endpoint) = 0;
+};
+
+#endif // USBFS_H
@@ -0,0 +1,297 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "UsbFsTransport.h"
+
+#include "FtdiPackets.h"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QDebug>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+UsbFsTransport::UsbFsTransport(int fd, const Endpoints &endpoints, PacketFormat format,
+                               UsbFs *usbFs)
+    : m_fd(fd)
+    , m_endpoints(endpoints)
+    , m_format(format)
+    , m_usbFs(usbFs)
+{
+    for (Urb &urb : m_urbs) {
+        urb.buffer.resize(urbBufferSize);
+        urb.urb.type = USBDEVFS_URB_TYPE_BULK;
+        urb.urb.endpoint = (unsigned char)(m_endpoints.in);
+        urb.urb.buffer = urb.buffer.data();
+        urb.urb.buffer_length = urbBufferSize;
+    }
+}
+
+UsbFsTransport::~UsbFsTransport()
+{
+    close();
+}
+
+bool UsbFsTransport::start()
+{
+    QMutexLocker locker(&m_readMutex);
+    for (Urb &urb : m_urbs) {
+        if (!submit(urb)) {
+            locker.unlock();
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void UsbFsTransport::close()
+{
+    if (m_closing.exchange(true))
+        return;
+
+    // Wakes a read blocked on the URBs; it returns once it reaped them
+    discardAll();
+
+    QMutexLocker locker(&m_readMutex);
+    // A read may have resubmitted a URB before it noticed the close
+    discardAll();
+
+    QDeadlineTimer deadline(closeReapTimeoutMs);
+    auto anySubmitted = [this]() {
+        return std::any_of(m_urbs.cbegin(), m_urbs.cend(),
+                           [](const Urb &urb) { return urb.submitted; });
+    };
+    while (anySubmitted()) {
+        usbdevfs_urb *reaped = nullptr;
+        // If the device is gone, the kernel drops the URBs with the fd
+        if (m_usbFs->reapUrb(m_fd, &reaped, int(deadline.remainingTime())) < 0)
+            break;
+        if (Urb *urb = ownUrb(reaped))
+            complete(*urb);
+    }
+    m_pending.clear();
+}
+
+bool UsbFsTransport::isRunning() const
+{
+    return !m_closing.load(std::memory_order_relaxed) && !m_failed.load(std::memory_order_relaxed);
+}
+
+QByteArray UsbFsTransport::read(int maxLength, int timeoutMs)
+{
+    QMutexLocker locker(&m_readMutex);
+    if (!m_pending.isEmpty())
+        return takePending(maxLength);
+
+    const QDeadlineTimer deadline = timeoutMs > 0 ? QDeadlineTimer(timeoutMs)
+                                                  : QDeadlineTimer(QDeadlineTimer::Forever);
+    while (isRunning()) {
+        usbdevfs_urb *reaped = nullptr;
+        const int result = m_usbFs->reapUrb(m_fd, &reaped, int(deadline.remainingTime()));
+        if (result == -ETIMEDOUT)
+            break;
+        if (result < 0) {
+            qWarning() << "Reaping URB failed:" << strerror(-result);
+            m_errors.fetch_add(1, std::memory_order_relaxed);
+            m_failed.store(true, std::memory_order_relaxed);
+            break;
+        }
+
+        if (Urb *urb = ownUrb(reaped))
+            complete(*urb);
+        if (!m_pending.isEmpty())
+            return takePending(maxLength);
+        if (deadline.hasExpired())
+            break;
+    }
+    return QByteArray();
+}
+
+bool UsbFsTransport::write(const QByteArray &data, int timeoutMs)
+{
+    if (!isRunning())
+        return false;
+
+    QDeadlineTimer deadline = timeoutMs > 0 ? QDeadlineTimer(timeoutMs)
+                                            : QDeadlineTimer(QDeadlineTimer::Forever);
+    qsizetype offset = 0;
+    int stalls = 0;
+    while (offset < data.size()) {
+        // usbfs takes 0 as no timeout
+        const qint64 remaining = deadline.remainingTime();
+        if (remaining == 0) {
+            qWarning() << "Write timed out after" << offset << "of" << data.size() << "bytes";
+            return false;
+        }
+
+        const unsigned length = unsigned(qMin<qsizetype>(maxWriteChunk, data.size() - offset));
+        const int result = m_usbFs->bulkTransfer(m_fd, m_endpoints.out,
+                                                 const_cast<char *>(data.constData() + offset),
+                                                 length, remaining < 0 ? 0 : unsigned(remaining));
+        if (result == -EPIPE) {
+            m_stalls.fetch_add(1, std::memory_order_relaxed);
+            // A halt that comes back after clearing is not transient
+            if (++stalls > maxWriteStallRetries) {
+                qWarning() << "Bulk write still stalled after" << maxWriteStallRetries
+                           << "cleared halts";
+                m_errors.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (!clearHalt(m_endpoints.out))
+                return false;
+            continue;
+        }
+        if (result < 0) {
+            qWarning() << "Bulk write failed:" << strerror(-result);
+            m_errors.fetch_add(1, std::memory_order_relaxed);
+            if (result == -ENODEV)
+                m_failed.store(true, std::memory_order_relaxed);
+            return false;
+        }
+
+        offset += result;
+        m_bytesWritten.fetch_add(result, std::memory_order_relaxed);
+        stalls = 0;
+    }
+    return true;
+}
+
+void UsbFsTransport::discardPending()
+{
+    QMutexLocker locker(&m_readMutex);
+    m_pending.clear();
+}
+
+UsbFsTransport::Stats UsbFsTransport::stats() const
+{
+    Stats stats;
+    stats.urbsReaped = m_urbsReaped.load(std::memory_order_relaxed);
+    stats.bytesRead = m_bytesRead.load(std::memory_order_relaxed);
+    stats.bytesWritten = m_bytesWritten.load(std::memory_order_relaxed);
+    stats.stalls = m_stalls.load(std::memory_order_relaxed);
+    stats.errors = m_errors.load(std::memory_order_relaxed);
+    stats.overruns = m_overruns.load(std::memory_order_relaxed);
+    stats.parityErrors = m_parityErrors.load(std::memory_order_relaxed);
+    stats.framingErrors = m_framingErrors.load(std::memory_order_relaxed);
+    stats.breaks = m_breaks.load(std::memory_order_relaxed);
+    stats.modemStatus = m_modemStatus.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool UsbFsTransport::submit(Urb &urb)
+{
+    urb.urb.status = 0;
+    urb.urb.actual_length = 0;
+    const int result = m_usbFs->submitUrb(m_fd, &urb.urb);
+    if (result < 0) {
+        qWarning() << "Submitting URB failed:" << strerror(-result);
+        m_errors.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    urb.submitted = true;
+    return true;
+}
+
+bool UsbFsTransport::clearHalt(unsigned endpoint)
+{
+    const int result = m_usbFs->clearHalt(m_fd, endpoint);
+    if (result < 0) {
+        qWarning() << "Clearing the halt of endpoint" << Qt::hex << endpoint << "failed:"
+                   << strerror(-result);
+        m_errors.fetch_add(1, std::memory_order_relaxed);
+        if (result == -ENODEV)
+            m_failed.store(true, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+// Discarding a URB that is not in flight fails harmlessly, so this does
+// not need to know which ones are
+void UsbFsTransport::discardAll()
+{
+    for (Urb &urb : m_urbs)
+        m_usbFs->discardUrb(m_fd, &urb.urb);
+}
+
+// Only our URBs are expected on the fd, but a request queued through the
+// Java UsbDeviceConnection would be reaped here as well
+UsbFsTransport::Urb *UsbFsTransport::ownUrb(usbdevfs_urb *reaped)
+{
+    for (Urb &urb : m_urbs) {
+        if (&urb.urb == reaped)
+            return &urb;
+    }
+    qWarning() << "Reaped a foreign URB";
+    return nullptr;
+}
+
+void UsbFsTransport::complete(Urb &urb)
+{
+    urb.submitted = false;
+    m_urbsReaped.fetch_add(1, std::memory_order_relaxed);
+
+    switch (urb.urb.status) {
+    case 0:
+        deliver(urb.buffer.data(), urb.urb.actual_length);
+        break;
+    case -ENOENT:
+    case -ECONNRESET:
+        // Discarded by close()
+        return;
+    case -EPIPE:
+        m_stalls.fetch_add(1, std::memory_order_relaxed);
+        // Resubmitting to an endpoint that stays halted would only stall again
+        if (!clearHalt(m_endpoints.in)) {
+            m_failed.store(true, std::memory_order_relaxed);
+            return;
+        }
+        break;
+    case -ENODEV:
+    case -ESHUTDOWN:
+        m_failed.store(true, std::memory_order_relaxed);
+        return;
+    default:
+        // -EPROTO, -EOVERFLOW, ...: a damaged packet, the next may be fine
+        m_errors.fetch_add(1, std::memory_order_relaxed);
+        break;
+    }
+
+    if (isRunning() && !submit(urb))
+        m_failed.store(true, std::memory_order_relaxed);
+}
+
+void UsbFsTransport::deliver(char *data, qsizetype length)
+{
+    if (m_format == PacketFormat::FtdiStatus) {
+        FtdiPackets::LineStatus status;
+        length = FtdiPackets::stripStatus(data, length, m_endpoints.maxPacketSize, status);
+        // Zero-length transfers carry no header to take the status from
+        if (status.packets > 0)
+            m_modemStatus.store(status.modemStatus, std::memory_order_relaxed);
+        if (status.overruns || status.parityErrors || status.framingErrors || status.breaks) {
+            m_overruns.fetch_add(status.overruns, std::memory_order_relaxed);
+            m_parityErrors.fetch_add(status.parityErrors, std::memory_order_relaxed);
+            m_framingErrors.fetch_add(status.framingErrors, std::memory_order_relaxed);
+            m_breaks.fetch_add(status.breaks, std::memory_order_relaxed);
+        }
+    }
+
+    if (length > 0) {
+        m_pending.append(data, length);
+        m_bytesRead.fetch_add(length, std::memory_order_relaxed);
+    }
+}
+
+QByteArray UsbFsTransport::takePending(int maxLength)
+{
+    if (m_pending.size() <= maxLength)
+        return std::exchange(m_pending, QByteArray());
+
+    QByteArray data = m_pending.left(maxLength);
+    m_pending.remove(0, maxLength);
+    return data;
+}
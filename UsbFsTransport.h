@@ -0,0 +1,126 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef USBFSTRANSPORT_H
+#define USBFSTRANSPORT_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMutex>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "UsbFs.h"
+
+// Bulk data path of an open USB serial adapter, directly on the usbfs fd
+// of its UsbDeviceConnection. Several read URBs stay queued on the IN
+// endpoint, so the adapter is polled by the host controller while the
+// last packet is being handed out, and each byte is copied once instead
+// of crossing JNI twice. Opening the device, claiming the interface and
+// the line setup stay with the Java driver.
+//
+// read() may block on one thread while write() runs on another; reads
+// are serialized among themselves.
+class UsbFsTransport {
+public:
+    enum class PacketFormat {
+        Raw,
+        // Two status bytes in front of every packet, see FtdiPackets
+        FtdiStatus
+    };
+
+    struct Endpoints {
+        unsigned in = 0;
+        unsigned out = 0;
+        int maxPacketSize = 64;
+    };
+
+    struct Stats {
+        qint64 urbsReaped = 0;
+        qint64 bytesRead = 0;
+        qint64 bytesWritten = 0;
+        qint64 stalls = 0;
+        qint64 errors = 0;
+        // Reported in-band by FTDI adapters
+        qint64 overruns = 0;
+        qint64 parityErrors = 0;
+        qint64 framingErrors = 0;
+        qint64 breaks = 0;
+        quint8 modemStatus = 0;
+    };
+
+    // Does not take ownership of fd
+    UsbFsTransport(int fd, const Endpoints &endpoints, PacketFormat format = PacketFormat::Raw,
+                   UsbFs *usbFs = UsbFs::system());
+    ~UsbFsTransport();
+
+    UsbFsTransport(const UsbFsTransport &) = delete;
+    UsbFsTransport &operator=(const UsbFsTransport &) = delete;
+
+    // Queues the read URBs
+    bool start();
+    // Cancels the read URBs and waits for them; the fd may be closed then
+    void close();
+
+    // False after close() or once the device has gone away
+    bool isRunning() const;
+
+    // Returns an empty array on timeout or error. As with the Java driver,
+    // timeouts of 0 wait forever.
+    QByteArray read(int maxLength, int timeoutMs);
+    bool write(const QByteArray &data, int timeoutMs);
+
+    // Drops data that has been received but not read yet
+    void discardPending();
+
+    Stats stats() const;
+
+private:
+    static constexpr int urbCount = 4;
+    // A multiple of both full and high speed packet sizes
+    static constexpr int urbBufferSize = 16 * 1024;
+    static constexpr int maxWriteChunk = 16 * 1024;
+    static constexpr int closeReapTimeoutMs = 200;
+    static constexpr int maxWriteStallRetries = 3;
+
+    struct Urb {
+        std::vector<char> buffer;
+        bool submitted = false;
+        // Last, as it ends in an (unused) flexible array
+        usbdevfs_urb urb {};
+    };
+
+    bool submit(Urb &urb);
+    bool clearHalt(unsigned endpoint);
+    void discardAll();
+    Urb *ownUrb(usbdevfs_urb *reaped);
+    // Handles one completed URB; expects m_readMutex
+    void complete(Urb &urb);
+    // Appends the payload of a transfer, which may be modified in place
+    void deliver(char *data, qsizetype length);
+    QByteArray takePending(int maxLength);
+
+    const int m_fd;
+    const Endpoints m_endpoints;
+    const PacketFormat m_format;
+    UsbFs *const m_usbFs;
+
+    QMutex m_readMutex;
+    std::array<Urb, urbCount> m_urbs;
+    QByteArray m_pending;
+    std::atomic<bool> m_closing { false };
+    std::atomic<bool> m_failed { false };
+
+    std::atomic<qint64> m_urbsReaped { 0 };
+    std::atomic<qint64> m_bytesRead { 0 };
+    std::atomic<qint64> m_bytesWritten { 0 };
+    std::atomic<qint64> m_stalls { 0 };
+    std::atomic<qint64> m_errors { 0 };
+    std::atomic<qint64> m_overruns { 0 };
+    std::atomic<qint64> m_parityErrors { 0 };
+    std::atomic<qint64> m_framingErrors { 0 };
+    std::atomic<qint64> m_breaks { 0 };
+    std::atomic<quint8> m_modemStatus { 0 };
+};
+
+#endif // USBFSTRANSPORT_H
@@ -0,0 +1,60 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "UsbSerialDevice.h"
+#include "UsbEventHandler.h"
+
+UsbSerialDevice::UsbSerialDevice(const UsbSerialHelper::SerialDevice &device, int portIndex,
+                                 int baudRate, QObject *parent)
+    : QObject{ parent },
+      m_vendorId(device.vendorId),
+      m_productId(device.productId),
+      m_serialNumber(device.serialNumber),
+      m_portIndex(portIndex),
+      m_baudRate(baudRate),
+      m_deviceName(device.deviceName)
+{
+    connect(UsbEventHandler::instance(), &UsbEventHandler::deviceDetached, this,
+            [this](const QString &deviceName) {
+                if (deviceName == name())
+                    emit detached();
+            });
+
+    connect(UsbEventHandler::instance(), &UsbEventHandler::deviceAttached, this,
+            [this](const QString &, int vendorId, int productId) {
+                if (vendorId == m_vendorId && productId == m_productId) {
+                    m_permissionRequested.store(false);
+                    emit attached();
+                }
+            });
+}
+
+bool UsbSerialDevice::open()
+{
+    const int deviceIndex = UsbSerialHelper::findDevice(m_vendorId, m_productId, m_serialNumber);
+    if (deviceIndex < 0)
+        return false;
+
+    // Only the first attempt may bring up the permission dialog
+    m_helper.setPermissionRequestsEnabled(!m_permissionRequested.exchange(true));
+    if (!m_helper.openDevice(deviceIndex, m_portIndex, m_baudRate))
+        return false;
+
+    // A later connection loss may ask once more
+    m_permissionRequested.store(false);
+
+    QMutexLocker locker(&m_mutex);
+    m_deviceName = m_helper.deviceName();
+    return true;
+}
+
+void UsbSerialDevice::close()
+{
+    m_helper.closeDevice();
+}
+
+QString UsbSerialDevice::name() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_deviceName;
+}
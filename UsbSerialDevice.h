@@ -0,0 +1,54 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef USBSERIALDEVICE_H
+#define USBSERIALDEVICE_H
+
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+
+#include <atomic>
+
+#include "SerialSession.h"
+#include "UsbSerialHelper.h"
+
+// A USB serial adapter for SerialSession. The device name changes with
+// every plug-in, so the adapter is looked up by its VID, PID and serial
+// number each time it is opened. After a replug the app has no permission
+// for it yet and sees an empty serial number; findDevice() then matches
+// it on VID and PID, and the first open() afterwards asks for permission.
+// Retries do not ask again until the adapter is plugged in once more.
+class UsbSerialDevice : public QObject, public SerialSession::Device
+{
+    Q_OBJECT
+
+public:
+    UsbSerialDevice(const UsbSerialHelper::SerialDevice &device, int portIndex = 0,
+                    int baudRate = 9600, QObject *parent = nullptr);
+
+    bool open() override;
+    void close() override;
+    AbstractSerialPort *port() override { return &m_helper; }
+    QString name() const override;
+
+    UsbSerialHelper *helper() { return &m_helper; }
+
+signals:
+    // Detach and attach broadcasts for this adapter; connect them to
+    // SerialSession::reopen() and SerialSession::retryNow()
+    void detached();
+    void attached();
+
+private:
+    UsbSerialHelper m_helper;
+    const int m_vendorId;
+    const int m_productId;
+    const QString m_serialNumber;
+    const int m_portIndex;
+    const int m_baudRate;
+
+    mutable QMutex m_mutex;
+    QString m_deviceName;
+    std::atomic<bool> m_permissionRequested { false };
+};
+
+#endif // USBSERIALDEVICE_H
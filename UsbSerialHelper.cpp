@@ -1,514 +1,900 @@
-// Copyright (C) 2025 The Qt Company Ltd.
-// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
-#include <QGuiApplication>
-#include <QQmlApplicationEngine>
-#include <QQuickView>
-#include <QTimer>
-
-#include "UsbSerialHelper.h"
-
-UsbSerialHelper::UsbSerialHelper()
-{
-    QJniObject::callStaticMethod<void>(
-        "org/qtproject/example/appqtjenny_consumer/MainActivity",
-        "onQtInitialized",
-        "()V"
-        );
-}
-
-
-QList<UsbSerialHelper::SerialDevice> UsbSerialHelper::getAvailableDevices() {
-    QList<SerialDevice> devices;
-
-    // Get Android context
-    auto *nativeInterface = QCoreApplication::instance()
-                                ->nativeInterface<QNativeInterface::QAndroidApplication>();
-
-    if (!nativeInterface) {
-        qWarning() << "Failed to get native interface";
-        return devices;
-    }
-
-    QJniObject context = nativeInterface->context();
-    if (!context.isValid()) {
-        qWarning() << "Invalid context";
-        return devices;
-    }
-
-    // Get UsbManager system service
-    QJniObject usbServiceString = QJniObject::fromString("usb");
-    QJniObject usbManager = context.callObjectMethod(
-        "getSystemService",
-        "(Ljava/lang/String;)Ljava/lang/Object;",
-        usbServiceString.object()
-        );
-
-    if (!usbManager.isValid()) {
-        qWarning() << "Failed to get UsbManager";
-        return devices;
-    }
-
-    // Get default UsbSerialProber
-    QJniObject prober = QJniObject::callStaticObjectMethod(
-        "com/hoho/android/usbserial/driver/UsbSerialProber",
-        "getDefaultProber",
-        "()Lcom/hoho/android/usbserial/driver/UsbSerialProber;"
-        );
-
-    if (!prober.isValid()) {
-        qWarning() << "Failed to get UsbSerialProber";
-        return devices;
-    }
-
-    // Get list of available drivers
-    QJniObject driverList = prober.callObjectMethod(
-        "findAllDrivers",
-        "(Landroid/hardware/usb/UsbManager;)Ljava/util/List;",
-        usbManager.object()
-        );
-
-    if (!driverList.isValid()) {
-        qWarning() << "Failed to get driver list";
-        return devices;
-    }
-
-    // Get the size of the list
-    int size = driverList.callMethod<jint>("size", "()I");
-    qWarning() << "Found" << size << "USB serial device(s)";
-
-    // Iterate through all drivers
-    for (int i = 0; i < size; i++) {
-        // Get driver at index i
-        QJniObject driver = driverList.callObjectMethod(
-            "get",
-            "(I)Ljava/lang/Object;",
-            i
-            );
-
-        if (!driver.isValid()) {
-            continue;
-        }
-
-        SerialDevice device;
-
-        // Get UsbDevice
-        QJniObject usbDevice = driver.callObjectMethod(
-            "getDevice",
-            "()Landroid/hardware/usb/UsbDevice;"
-            );
-
-        if (usbDevice.isValid()) {
-            // Get device name
-            QJniObject deviceNameObj = usbDevice.callObjectMethod(
-                "getDeviceName",
-                "()Ljava/lang/String;"
-                );
-            device.deviceName = deviceNameObj.toString();
-
-            // Get vendor ID
-            device.vendorId = usbDevice.callMethod<jint>("getVendorId", "()I");
-
-            // Get product ID
-            device.productId = usbDevice.callMethod<jint>("getProductId", "()I");
-        }
-
-        // Get driver class name (e.g., CdcAcmSerialDriver, FtdiSerialDriver, etc.)
-        QJniObject driverClass = driver.callObjectMethod(
-            "getClass",
-            "()Ljava/lang/Class;"
-            );
-        QJniObject driverClassName = driverClass.callObjectMethod(
-            "getSimpleName",
-            "()Ljava/lang/String;"
-            );
-        device.driverName = driverClassName.toString();
-
-        // Get number of ports
-        QJniObject ports = driver.callObjectMethod(
-            "getPorts",
-            "()Ljava/util/List;"
-            );
-        device.portCount = ports.callMethod<jint>("size", "()I");
-
-        devices.append(device);
-
-        // Log device info
-        qWarning() << "Device" << i << ":";
-        qWarning() << "  Name:" << device.deviceName;
-        qWarning() << "  Driver:" << device.driverName;
-        qWarning() << "  Vendor ID:" << QString("0x%1").arg(device.vendorId, 4, 16, QChar('0'));
-        qWarning() << "  Product ID:" << QString("0x%1").arg(device.productId, 4, 16, QChar('0'));
-        qWarning() << "  Port count:" << device.portCount;
-    }
-
-    return devices;
-}
-
-// Optional: Get a specific driver by index
-QJniObject UsbSerialHelper::getDriverAtIndex(int index) {
-    auto *nativeInterface = QCoreApplication::instance()
-    ->nativeInterface<QNativeInterface::QAndroidApplication>();
-
-    if (!nativeInterface) {
-        return QJniObject();
-    }
-
-    QJniObject context = nativeInterface->context();
-    QJniObject usbServiceString = QJniObject::fromString("usb");
-    QJniObject usbManager = context.callObjectMethod(
-        "getSystemService",
-        "(Ljava/lang/String;)Ljava/lang/Object;",
-        usbServiceString.object()
-        );
-
-    QJniObject prober = QJniObject::callStaticObjectMethod(
-        "com/hoho/android/usbserial/driver/UsbSerialProber",
-        "getDefaultProber",
-        "()Lcom/hoho/android/usbserial/driver/UsbSerialProber;"
-        );
-
-    QJniObject driverList = prober.callObjectMethod(
-        "findAllDrivers",
-        "(Landroid/hardware/usb/UsbManager;)Ljava/util/List;",
-        usbManager.object()
-        );
-
-    int size = driverList.callMethod<jint>("size", "()I");
-    if (index < 0 || index >= size) {
-        qWarning() << "Index out of range";
-        return QJniObject();
-    }
-
-    return driverList.callObjectMethod(
-        "get",
-        "(I)Ljava/lang/Object;",
-        index
-        );
-}
-
-
-bool UsbSerialHelper::openDevice(int deviceIndex, int portIndex, int baudRate) {
-    auto *nativeInterface = QCoreApplication::instance()
-    ->nativeInterface<QNativeInterface::QAndroidApplication>();
-
-    if (!nativeInterface) {
-        qWarning() << "Failed to get native interface";
-        return false;
-    }
-
-    QJniObject context = nativeInterface->context();
-    QJniObject usbServiceString = QJniObject::fromString("usb");
-    QJniObject usbManager = context.callObjectMethod(
-        "getSystemService",
-        "(Ljava/lang/String;)Ljava/lang/Object;",
-        usbServiceString.object()
-        );
-
-    QJniObject prober = QJniObject::callStaticObjectMethod(
-        "com/hoho/android/usbserial/driver/UsbSerialProber",
-        "getDefaultProber",
-        "()Lcom/hoho/android/usbserial/driver/UsbSerialProber;"
-        );
-
-    QJniObject driverList = prober.callObjectMethod(
-        "findAllDrivers",
-        "(Landroid/hardware/usb/UsbManager;)Ljava/util/List;",
-        usbManager.object()
-        );
-
-    int size = driverList.callMethod<jint>("size", "()I");
-    if (deviceIndex < 0 || deviceIndex >= size) {
-        qWarning() << "Device index out of range";
-        return false;
-    }
-
-    // Get the driver
-    m_driver = driverList.callObjectMethod(
-        "get",
-        "(I)Ljava/lang/Object;",
-        deviceIndex
-        );
-
-    if (!m_driver.isValid()) {
-        qWarning() << "Invalid driver";
-        return false;
-    }
-
-    // Get the USB device
-    QJniObject usbDevice = m_driver.callObjectMethod(
-        "getDevice",
-        "()Landroid/hardware/usb/UsbDevice;"
-        );
-
-    // Check if we have permission
-    bool hasPermission = usbManager.callMethod<jboolean>(
-        "hasPermission",
-        "(Landroid/hardware/usb/UsbDevice;)Z",
-        usbDevice.object()
-        );
-
-    if (!hasPermission) {
-        qWarning() << "No USB permission - requesting...";
-        requestPermission(usbManager, usbDevice);
-        return false; // Will need to retry after permission granted
-    }
-
-    // Get the port
-    QJniObject ports = m_driver.callObjectMethod(
-        "getPorts",
-        "()Ljava/util/List;"
-        );
-
-    int portCount = ports.callMethod<jint>("size", "()I");
-    if (portIndex < 0 || portIndex >= portCount) {
-        qWarning() << "Port index out of range";
-        return false;
-    }
-
-    m_port = ports.callObjectMethod(
-        "get",
-        "(I)Ljava/lang/Object;",
-        portIndex
-        );
-
-    if (!m_port.isValid()) {
-        qWarning() << "Invalid port";
-        return false;
-    }
-
-    // Open a connection to the USB device
-    QJniObject connection = usbManager.callObjectMethod(
-        "openDevice",
-        "(Landroid/hardware/usb/UsbDevice;)Landroid/hardware/usb/UsbDeviceConnection;",
-        usbDevice.object()
-        );
-
-    if (!connection.isValid()) {
-        qWarning() << "Failed to open USB connection";
-        return false;
-    }
-
-    // Open the serial port
-    QJniEnvironment env;
-    m_port.callMethod<void>(
-        "open",
-        "(Landroid/hardware/usb/UsbDeviceConnection;)V",
-        connection.object()
-        );
-
-    if (env->ExceptionCheck()) {
-        env->ExceptionDescribe();
-        env->ExceptionClear();
-        qWarning() << "Failed to open serial port";
-        return false;
-    }
-
-    // Set parameters: baud rate, data bits, stop bits, parity
-    m_port.callMethod<void>(
-        "setParameters",
-        "(IIII)V",
-        baudRate,     // baud rate
-        8,            // data bits (8)
-        1,            // stop bits (1 = STOPBITS_1)
-        0             // parity (0 = PARITY_NONE)
-        );
-
-    if (env->ExceptionCheck()) {
-        env->ExceptionDescribe();
-        env->ExceptionClear();
-        qWarning() << "Failed to set port parameters";
-        closeDevice();
-        return false;
-    }
-
-    qDebug() << "Successfully opened device" << deviceIndex
-             << "port" << portIndex
-             << "at" << baudRate << "baud";
-
-    return true;
-}
-
-void UsbSerialHelper::closeDevice() {
-    if (m_port.isValid()) {
-        QJniEnvironment env;
-        m_port.callMethod<void>("close", "()V");
-
-        if (env->ExceptionCheck()) {
-            env->ExceptionDescribe();
-            env->ExceptionClear();
-        }
-
-        m_port = QJniObject();
-        qDebug() << "Device closed";
-    }
-    m_driver = QJniObject();
-}
-
-QByteArray UsbSerialHelper::readData(int maxLength, int timeoutMs) {
-    if (!m_port.isValid()) {
-        qWarning() << "Port not open";
-        return QByteArray();
-    }
-
-    QJniEnvironment env;
-
-    // Create a byte array to read into
-    jbyteArray buffer = env->NewByteArray(maxLength);
-
-    // Read from the port
-    int bytesRead = m_port.callMethod<jint>(
-        "read",
-        "([BI)I",
-        buffer,
-        timeoutMs
-        );
-
-    if (env->ExceptionCheck()) {
-        env->ExceptionDescribe();
-        env->ExceptionClear();
-        env->DeleteLocalRef(buffer);
-        return QByteArray();
-    }
-
-    if (bytesRead <= 0) {
-        env->DeleteLocalRef(buffer);
-        return QByteArray();
-    }
-
-    // Convert Java byte array to QByteArray
-    jbyte* bytes = env->GetByteArrayElements(buffer, nullptr);
-    QByteArray data(reinterpret_cast<const char*>(bytes), bytesRead);
-    env->ReleaseByteArrayElements(buffer, bytes, JNI_ABORT);
-    env->DeleteLocalRef(buffer);
-
-    return data;
-}
-
-bool UsbSerialHelper::writeData(const QByteArray &data, int timeoutMs)
-{
-    if (!m_port.isValid()) {
-        qWarning() << "Port not open";
-        return false;
-    }
-
-    QJniEnvironment env;
-
-    // Create Java byte array from QByteArray
-    jbyteArray buffer = env->NewByteArray(data.size());
-    env->SetByteArrayRegion(buffer, 0, data.size(),
-                            reinterpret_cast<const jbyte*>(data.constData()));
-
-    // Write to the port
-    int bytesWritten = m_port.callMethod<jint>(
-        "write",
-        "([BI)I",
-        buffer,
-        timeoutMs
-        );
-
-    env->DeleteLocalRef(buffer);
-
-    if (env->ExceptionCheck()) {
-        env->ExceptionDescribe();
-        env->ExceptionClear();
-        return false;
-    }
-
-    if (bytesWritten != data.size()) {
-        qWarning() << "Only wrote" << bytesWritten << "of" << data.size() << "bytes";
-        return false;
-    }
-
-    qDebug() << "Wrote" << bytesWritten << "bytes";
-    return true;
-}
-
-void UsbSerialHelper::requestPermission(const QJniObject &usbManager, const QJniObject &usbDevice) {
-    auto *nativeInterface = QCoreApplication::instance()
-    ->nativeInterface<QNativeInterface::QAndroidApplication>();
-    QJniObject context = nativeInterface->context();
-
-    // Create a PendingIntent for the permission request
-    QJniObject action = QJniObject::fromString("com.yourapp.USB_PERMISSION");
-
-    QJniObject pendingIntent = QJniObject::callStaticObjectMethod(
-        "android/app/PendingIntent",
-        "getBroadcast",
-        "(Landroid/content/Context;ILandroid/content/Intent;I)Landroid/app/PendingIntent;",
-        context.object(),
-        0,
-        QJniObject("android/content/Intent", "(Ljava/lang/String;)V", action.object()).object(),
-        0x04000000  // PendingIntent.FLAG_IMMUTABLE
-        );
-
-    // Request permission
-    usbManager.callMethod<void>(
-        "requestPermission",
-        "(Landroid/hardware/usb/UsbDevice;Landroid/app/PendingIntent;)V",
-        usbDevice.object(),
-        pendingIntent.object()
-        );
-
-    qDebug() << "USB permission requested";
-}
-
-
-
-extern "C" {
-
-JNIEXPORT void JNICALL
-Java_org_qtproject_example_appqtjenny_1consumer_UsbConnectionReceiver_notifyUsbDeviceAttached(
-    JNIEnv *env, jobject obj, jstring jDeviceName,
-    jint vendorId, jint productId, jint deviceClass)
-{
-    const char *deviceName = env->GetStringUTFChars(jDeviceName, nullptr);
-
-    qDebug() << "USB Device Attached:" << deviceName
-             << "VID:" << QString::number(vendorId, 16)
-             << "PID:" << QString::number(productId, 16);
-
-/*
-    UsbEventHandler::instance()->onDeviceAttached(
-        QString(deviceName), vendorId, productId, deviceClass
-        );
- */
-    env->ReleaseStringUTFChars(jDeviceName, deviceName);
-}
-
-JNIEXPORT void JNICALL
-Java_org_qtproject_example_appqtjenny_1consumer_UsbConnectionReceiver_notifyUsbDeviceDetached(
-    JNIEnv *env, jobject obj, jstring jDeviceName)
-{
-    const char *deviceName = env->GetStringUTFChars(jDeviceName, nullptr);
-
-    qDebug() << "USB Device Detached:" << deviceName;
-
-    //UsbEventHandler::instance()->onDeviceDetached(QString(deviceName));
-
-    env->ReleaseStringUTFChars(jDeviceName, deviceName);
-}
-
-JNIEXPORT void JNICALL
-Java_org_qtproject_example_appqtjenny_1consumer_UsbConnectionReceiver_notifyAppStartedByUsbDevice(
-    JNIEnv *env, jobject obj, jstring jDeviceName,
-    jint vendorId, jint productId, jstring jDriverName)
-{
-    const char *deviceName = env->GetStringUTFChars(jDeviceName, nullptr);
-    const char *driverName = env->GetStringUTFChars(jDriverName, nullptr);
-
-    qDebug() << "App started by USB device:" << deviceName
-             << "VID:" << QString::number(vendorId, 16)
-             << "PID:" << QString::number(productId, 16)
-             << "Driver:" << driverName;
-
-/*
-    // Notify your application logic
-    UsbEventHandler::instance()->onAppStartedByDevice(
-        QString(deviceName), vendorId, productId, QString(driverName)
-        );
-*/
-    env->ReleaseStringUTFChars(jDeviceName, deviceName);
-    env->ReleaseStringUTFChars(jDriverName, driverName);
-}
-
-} // extern "C"
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#include <QGuiApplication>
+#include <QQmlApplicationEngine>
+#include <QQuickView>
+#include <QTimer>
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QElapsedTimer>
+
+#include <memory>
+#include <utility>
+
+#include "AllocationTracker.h"
+#include "JavaPortIo.h"
+#include "UsbEventHandler.h"
+#include "UsbSerialHelper.h"
+
+UsbSerialHelper::UsbSerialHelper()
+{
+    // One thread for reading and one for writing or control calls; more
+    // would only queue up on the USB connection.
+    m_ioPool.setMaxThreadCount(2);
+    m_ioPool.setObjectName("UsbSerialIo");
+
+    QJniObject::callStaticMethod<void>(
+        "org/qtproject/example/appqtjenny_consumer/MainActivity",
+        "onQtInitialized",
+        "()V"
+        );
+}
+
+
+QList<UsbSerialHelper::SerialDevice> UsbSerialHelper::getAvailableDevices() {
+    QList<SerialDevice> devices;
+
+    // Get Android context
+    auto *nativeInterface = QCoreApplication::instance()
+                                ->nativeInterface<QNativeInterface::QAndroidApplication>();
+
+    if (!nativeInterface) {
+        qWarning() << "Failed to get native interface";
+        return devices;
+    }
+
+    QJniObject context = nativeInterface->context();
+    if (!context.isValid()) {
+        qWarning() << "Invalid context";
+        return devices;
+    }
+
+    // Get UsbManager system service
+    QJniObject usbServiceString = QJniObject::fromString("usb");
+    QJniObject usbManager = context.callObjectMethod(
+        "getSystemService",
+        "(Ljava/lang/String;)Ljava/lang/Object;",
+        usbServiceString.object()
+        );
+
+    if (!usbManager.isValid()) {
+        qWarning() << "Failed to get UsbManager";
+        return devices;
+    }
+
+    // Get default UsbSerialProber
+    QJniObject prober = QJniObject::callStaticObjectMethod(
+        "com/hoho/android/usbserial/driver/UsbSerialProber",
+        "getDefaultProber",
+        "()Lcom/hoho/android/usbserial/driver/UsbSerialProber;"
+        );
+
+    if (!prober.isValid()) {
+        qWarning() << "Failed to get UsbSerialProber";
+        return devices;
+    }
+
+    // Get list of available drivers
+    QJniObject driverList = prober.callObjectMethod(
+        "findAllDrivers",
+        "(Landroid/hardware/usb/UsbManager;)Ljava/util/List;",
+        usbManager.object()
+        );
+
+    if (!driverList.isValid()) {
+        qWarning() << "Failed to get driver list";
+        return devices;
+    }
+
+    // Get the size of the list
+    int size = driverList.callMethod<jint>("size", "()I");
+    qWarning() << "Found" << size << "USB serial device(s)";
+
+    // Iterate through all drivers
+    for (int i = 0; i < size; i++) {
+        // Get driver at index i
+        QJniObject driver = driverList.callObjectMethod(
+            "get",
+            "(I)Ljava/lang/Object;",
+            i
+            );
+
+        if (!driver.isValid()) {
+            continue;
+        }
+
+        SerialDevice device;
+
+        // Get UsbDevice
+        QJniObject usbDevice = driver.callObjectMethod(
+            "getDevice",
+            "()Landroid/hardware/usb/UsbDevice;"
+            );
+
+        if (usbDevice.isValid()) {
+            // Get device name
+            QJniObject deviceNameObj = usbDevice.callObjectMethod(
+                "getDeviceName",
+                "()Ljava/lang/String;"
+                );
+            device.deviceName = deviceNameObj.toString();
+
+            // Get vendor ID
+            device.vendorId = usbDevice.callMethod<jint>("getVendorId", "()I");
+
+            // Get product ID
+            device.productId = usbDevice.callMethod<jint>("getProductId", "()I");
+
+            // Get serial number. This needs USB permission on Android 10
+            // and later, and stays empty without it.
+            QJniObject serialNumberObj = usbDevice.callObjectMethod(
+                "getSerialNumber",
+                "()Ljava/lang/String;"
+                );
+            device.serialNumber = serialNumberObj.toString();
+        }
+
+        // Get driver class name (e.g., CdcAcmSerialDriver, FtdiSerialDriver, etc.)
+        QJniObject driverClass = driver.callObjectMethod(
+            "getClass",
+            "()Ljava/lang/Class;"
+            );
+        QJniObject driverClassName = driverClass.callObjectMethod(
+            "getSimpleName",
+            "()Ljava/lang/String;"
+            );
+        device.driverName = driverClassName.toString();
+
+        // Get number of ports
+        QJniObject ports = driver.callObjectMethod(
+            "getPorts",
+            "()Ljava/util/List;"
+            );
+        device.portCount = ports.callMethod<jint>("size", "()I");
+
+        devices.append(device);
+
+        // Log device info
+        qWarning() << "Device" << i << ":";
+        qWarning() << "  Name:" << device.deviceName;
+        qWarning() << "  Driver:" << device.driverName;
+        qWarning() << "  Vendor ID:" << QString("0x%1").arg(device.vendorId, 4, 16, QChar('0'));
+        qWarning() << "  Product ID:" << QString("0x%1").arg(device.productId, 4, 16, QChar('0'));
+        qWarning() << "  Serial number:" << device.serialNumber;
+        qWarning() << "  Port count:" << device.portCount;
+    }
+
+    return devices;
+}
+
+int UsbSerialHelper::findDevice(int vendorId, int productId, const QString &serialNumber)
+{
+    const QList<SerialDevice> devices = getAvailableDevices();
+    int unknownSerial = -1;
+    for (int i = 0; i < devices.size(); i++) {
+        const SerialDevice &device = devices[i];
+        if (device.vendorId != vendorId || device.productId != productId)
+            continue;
+        if (!serialNumber.isEmpty() && device.serialNumber == serialNumber)
+            return i;
+        if ((serialNumber.isEmpty() || device.serialNumber.isEmpty()) && unknownSerial < 0)
+            unknownSerial = i;
+    }
+    return unknownSerial;
+}
+
+// Optional: Get a specific driver by index
+QJniObject UsbSerialHelper::getDriverAtIndex(int index) {
+    auto *nativeInterface = QCoreApplication::instance()
+    ->nativeInterface<QNativeInterface::QAndroidApplication>();
+
+    if (!nativeInterface) {
+        return QJniObject();
+    }
+
+    QJniObject context = nativeInterface->context();
+    QJniObject usbServiceString = QJniObject::fromString("usb");
+    QJniObject usbManager = context.callObjectMethod(
+        "getSystemService",
+        "(Ljava/lang/String;)Ljava/lang/Object;",
+        usbServiceString.object()
+        );
+
+    QJniObject prober = QJniObject::callStaticObjectMethod(
+        "com/hoho/android/usbserial/driver/UsbSerialProber",
+        "getDefaultProber",
+        "()Lcom/hoho/android/usbserial/driver/UsbSerialProber;"
+        );
+
+    QJniObject driverList = prober.callObjectMethod(
+        "findAllDrivers",
+        "(Landroid/hardware/usb/UsbManager;)Ljava/util/List;",
+        usbManager.object()
+        );
+
+    int size = driverList.callMethod<jint>("size", "()I");
+    if (index < 0 || index >= size) {
+        qWarning() << "Index out of range";
+        return QJniObject();
+    }
+
+    return driverList.callObjectMethod(
+        "get",
+        "(I)Ljava/lang/Object;",
+        index
+        );
+}
+
+
+bool UsbSerialHelper::openDevice(int deviceIndex, int portIndex, int baudRate) {
+    auto *nativeInterface = QCoreApplication::instance()
+    ->nativeInterface<QNativeInterface::QAndroidApplication>();
+
+    if (!nativeInterface) {
+        qWarning() << "Failed to get native interface";
+        return false;
+    }
+
+    QJniObject context = nativeInterface->context();
+    QJniObject usbServiceString = QJniObject::fromString("usb");
+    QJniObject usbManager = context.callObjectMethod(
+        "getSystemService",
+        "(Ljava/lang/String;)Ljava/lang/Object;",
+        usbServiceString.object()
+        );
+
+    QJniObject prober = QJniObject::callStaticObjectMethod(
+        "com/hoho/android/usbserial/driver/UsbSerialProber",
+        "getDefaultProber",
+        "()Lcom/hoho/android/usbserial/driver/UsbSerialProber;"
+        );
+
+    QJniObject driverList = prober.callObjectMethod(
+        "findAllDrivers",
+        "(Landroid/hardware/usb/UsbManager;)Ljava/util/List;",
+        usbManager.object()
+        );
+
+    int size = driverList.callMethod<jint>("size", "()I");
+    if (deviceIndex < 0 || deviceIndex >= size) {
+        qWarning() << "Device index out of range";
+        return false;
+    }
+
+    // Get the driver
+    QJniObject driver = driverList.callObjectMethod(
+        "get",
+        "(I)Ljava/lang/Object;",
+        deviceIndex
+        );
+
+    if (!driver.isValid()) {
+        qWarning() << "Invalid driver";
+        return false;
+    }
+
+    // Get the USB device
+    QJniObject usbDevice = driver.callObjectMethod(
+        "getDevice",
+        "()Landroid/hardware/usb/UsbDevice;"
+        );
+
+    // Check if we have permission
+    bool hasPermission = usbManager.callMethod<jboolean>(
+        "hasPermission",
+        "(Landroid/hardware/usb/UsbDevice;)Z",
+        usbDevice.object()
+        );
+
+    if (!hasPermission) {
+        if (!m_permissionRequestsEnabled.load(std::memory_order_relaxed)) {
+            qWarning() << "No USB permission";
+            return false;
+        }
+        qWarning() << "No USB permission - requesting...";
+        requestPermission(usbManager, usbDevice);
+        return false; // Will need to retry after permission granted
+    }
+
+    // Get the port
+    QJniObject ports = driver.callObjectMethod(
+        "getPorts",
+        "()Ljava/util/List;"
+        );
+
+    int portCount = ports.callMethod<jint>("size", "()I");
+    if (portIndex < 0 || portIndex >= portCount) {
+        qWarning() << "Port index out of range";
+        return false;
+    }
+
+    QJniObject port = ports.callObjectMethod(
+        "get",
+        "(I)Ljava/lang/Object;",
+        portIndex
+        );
+
+    if (!port.isValid()) {
+        qWarning() << "Invalid port";
+        return false;
+    }
+
+    // Open a connection to the USB device
+    QJniObject connection = usbManager.callObjectMethod(
+        "openDevice",
+        "(Landroid/hardware/usb/UsbDevice;)Landroid/hardware/usb/UsbDeviceConnection;",
+        usbDevice.object()
+        );
+
+    if (!connection.isValid()) {
+        qWarning() << "Failed to open USB connection";
+        return false;
+    }
+
+    // Open the serial port
+    QJniEnvironment env;
+    port.callMethod<void>(
+        "open",
+        "(Landroid/hardware/usb/UsbDeviceConnection;)V",
+        connection.object()
+        );
+
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        qWarning() << "Failed to open serial port";
+        return false;
+    }
+
+    if (!setLineParameters(port, baudRate)) {
+        qWarning() << "Failed to set port parameters";
+        port.callMethod<void>("close", "()V");
+        if (env->ExceptionCheck()) {
+            env->ExceptionDescribe();
+            env->ExceptionClear();
+        }
+        return false;
+    }
+
+    const QString deviceName = usbDevice.callObjectMethod(
+        "getDeviceName",
+        "()Ljava/lang/String;"
+        ).toString();
+
+    std::shared_ptr<UsbFsTransport> transport;
+    if (m_nativeTransportEnabled.load(std::memory_order_relaxed))
+        transport = createTransport(driver, port, connection);
+
+    std::shared_ptr<PushReceiver> receiver;
+    if (!transport && m_pushModeEnabled.load(std::memory_order_relaxed)) {
+        receiver = std::make_shared<PushReceiver>();
+        if (!receiver->start(port))
+            receiver.reset();
+    }
+
+    closeDevice();
+    {
+        QMutexLocker locker(&m_mutex);
+        m_driver = driver;
+        m_port = port;
+        m_transport = transport;
+        m_receiver = receiver;
+        m_baudRate = baudRate;
+        m_deviceName = deviceName;
+    }
+    m_consecutiveErrors.store(0, std::memory_order_relaxed);
+
+    qDebug() << "Successfully opened device" << deviceIndex
+             << "port" << portIndex
+             << "at" << baudRate << "baud"
+             << (transport ? "(native transport)" : receiver ? "(push mode)" : "");
+
+    return true;
+}
+
+void UsbSerialHelper::closeDevice() {
+    QJniObject port;
+    std::shared_ptr<UsbFsTransport> transport;
+    std::shared_ptr<PushReceiver> receiver;
+    {
+        QMutexLocker locker(&m_mutex);
+        port = std::exchange(m_port, QJniObject());
+        transport = std::exchange(m_transport, nullptr);
+        receiver = std::exchange(m_receiver, nullptr);
+        m_driver = QJniObject();
+        m_baudRate = 0;
+        m_deviceName.clear();
+    }
+
+    // Before the Java port closes the connection and with it the fd
+    if (transport)
+        transport->close();
+    // Likewise, the reader thread must not read from a closed port
+    if (receiver)
+        receiver->stop();
+
+    if (port.isValid()) {
+        QJniEnvironment env;
+        port.callMethod<void>("close", "()V");
+
+        if (env->ExceptionCheck()) {
+            env->ExceptionDescribe();
+            env->ExceptionClear();
+        }
+
+        qDebug() << "Device closed";
+    }
+}
+
+bool UsbSerialHelper::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_port.isValid();
+}
+
+// Returns a copy of the port, so that a concurrent closeDevice() cannot
+// pull it out from under a blocking call
+QJniObject UsbSerialHelper::currentPort() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_port;
+}
+
+std::shared_ptr<UsbFsTransport> UsbSerialHelper::currentTransport() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_transport;
+}
+
+std::shared_ptr<PushReceiver> UsbSerialHelper::currentReceiver() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_receiver;
+}
+
+void UsbSerialHelper::setNativeTransportEnabled(bool enabled)
+{
+    m_nativeTransportEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool UsbSerialHelper::usesNativeTransport() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_transport != nullptr;
+}
+
+UsbFsTransport::Stats UsbSerialHelper::nativeTransportStats() const
+{
+    const auto transport = currentTransport();
+    return transport ? transport->stats() : UsbFsTransport::Stats();
+}
+
+void UsbSerialHelper::setPermissionRequestsEnabled(bool enabled)
+{
+    m_permissionRequestsEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void UsbSerialHelper::setPushModeEnabled(bool enabled)
+{
+    m_pushModeEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool UsbSerialHelper::usesPushMode() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_receiver != nullptr;
+}
+
+PushReceiver::Stats UsbSerialHelper::pushStats() const
+{
+    const auto receiver = currentReceiver();
+    return receiver ? receiver->stats() : PushReceiver::Stats();
+}
+
+QString UsbSerialHelper::deviceName() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_deviceName;
+}
+
+bool UsbSerialHelper::purgeBuffers(bool purgeReadBuffers, bool purgeWriteBuffers)
+{
+    QJniObject port = currentPort();
+    if (!port.isValid()) {
+        qWarning() << "Port not open";
+        return false;
+    }
+
+    if (const auto transport = currentTransport())
+        transport->discardPending();
+    if (const auto receiver = currentReceiver())
+        receiver->clear();
+
+    QJniEnvironment env;
+    env->CallVoidMethod(port.object(), portMethods().purgeHwBuffers,
+                        jboolean(purgeReadBuffers), jboolean(purgeWriteBuffers));
+
+    // UnsupportedOperationException for chips without a purge command
+    if (env.checkAndClearExceptions()) {
+        qWarning() << "Failed to purge buffers of" << deviceName();
+        return false;
+    }
+
+    qDebug() << "Purged buffers of" << deviceName();
+    return true;
+}
+
+int UsbSerialHelper::baudRate() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_baudRate;
+}
+
+bool UsbSerialHelper::setBaudRate(int baudRate)
+{
+    QJniObject port = currentPort();
+    if (!port.isValid()) {
+        qWarning() << "Port not open";
+        return false;
+    }
+
+    if (!setLineParameters(port, baudRate)) {
+        qWarning() << "Failed to set baud rate" << baudRate;
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_baudRate = baudRate;
+    }
+
+    qDebug() << "Baud rate set to" << baudRate;
+    return true;
+}
+
+QByteArray UsbSerialHelper::readData(int maxLength, int timeoutMs) {
+    AllocationTracker::Scope allocations(AllocationTracker::Stage::Read);
+
+    if (const auto transport = currentTransport()) {
+        QByteArray data = transport->read(maxLength, timeoutMs);
+        recordTransfer(transport->isRunning());
+        return data;
+    }
+
+    if (const auto receiver = currentReceiver()) {
+        QByteArray data = receiver->read(maxLength, timeoutMs);
+        recordTransfer(receiver->isRunning());
+        return data;
+    }
+
+    QJniObject port = currentPort();
+    if (!port.isValid()) {
+        qWarning() << "Port not open";
+        return QByteArray();
+    }
+
+    // An IOException from a dead connection fails the transfer; a
+    // timeout only returns no data
+    QJniEnvironment env;
+    bool failed = false;
+    QByteArray data = JavaPortIo::read(env.jniEnv(), port.object(), portMethods().read,
+                                       maxLength, timeoutMs, failed);
+    recordTransfer(!failed);
+    return data;
+}
+
+bool UsbSerialHelper::writeData(const QByteArray &data, int timeoutMs)
+{
+    AllocationTracker::Scope allocations(AllocationTracker::Stage::Write);
+
+    if (const auto transport = currentTransport()) {
+        const bool written = transport->write(data, timeoutMs);
+        recordTransfer(written);
+        return written;
+    }
+
+    QJniObject port = currentPort();
+    if (!port.isValid()) {
+        qWarning() << "Port not open";
+        return false;
+    }
+
+    QJniEnvironment env;
+    if (!JavaPortIo::write(env.jniEnv(), port.object(), portMethods().write, data, timeoutMs)) {
+        qWarning() << "Failed to write" << data.size() << "bytes";
+        recordTransfer(false);
+        return false;
+    }
+    recordTransfer(true);
+    return true;
+}
+
+const UsbSerialHelper::PortMethods &UsbSerialHelper::portMethods()
+{
+    static const PortMethods methods = [] {
+        QJniEnvironment env;
+        jclass portClass = env.findClass("com/hoho/android/usbserial/driver/UsbSerialPort");
+        return PortMethods {
+            env.findMethod(portClass, "read", "([BI)I"),
+            env.findMethod(portClass, "write", "([BI)V"),
+            env.findMethod(portClass, "purgeHwBuffers", "(ZZ)V"),
+            env.findMethod(portClass, "setParameters", "(IIII)V")
+        };
+    }();
+    return methods;
+}
+
+// QJniObject::callMethod() clears a pending exception itself, which would
+// hide an IllegalArgumentException for a rate the chip does not support
+bool UsbSerialHelper::setLineParameters(const QJniObject &port, int baudRate)
+{
+    QJniEnvironment env;
+    env->CallVoidMethod(port.object(), portMethods().setParameters,
+                        jint(baudRate), // baud rate
+                        jint(8),        // data bits (8)
+                        jint(1),        // stop bits (1 = STOPBITS_1)
+                        jint(0));       // parity (0 = PARITY_NONE)
+    return !env.checkAndClearExceptions();
+}
+
+// Sets up the usbfs data path for drivers whose bulk data the transport
+// understands: plain serial data, or FTDI packets with status bytes.
+// Other drivers and library versions without endpoint accessors stay on
+// the Java path.
+std::shared_ptr<UsbFsTransport> UsbSerialHelper::createTransport(const QJniObject &driver,
+                                                                 const QJniObject &port,
+                                                                 const QJniObject &connection)
+{
+    static const QStringList rawDrivers {
+        QStringLiteral("CdcAcmSerialDriver"),
+        QStringLiteral("Cp21xxSerialDriver"),
+        QStringLiteral("Ch34xSerialDriver"),
+        QStringLiteral("ProlificSerialDriver"),
+    };
+
+    QJniEnvironment env;
+    const QString driverName = driver.callObjectMethod("getClass", "()Ljava/lang/Class;")
+                                   .callObjectMethod("getSimpleName", "()Ljava/lang/String;")
+                                   .toString();
+    const bool ftdi = driverName == QLatin1String("FtdiSerialDriver");
+    if (!ftdi && !rawDrivers.contains(driverName))
+        return nullptr;
+
+    const QJniObject readEndpoint = port.callObjectMethod(
+        "getReadEndpoint", "()Landroid/hardware/usb/UsbEndpoint;");
+    const QJniObject writeEndpoint = port.callObjectMethod(
+        "getWriteEndpoint", "()Landroid/hardware/usb/UsbEndpoint;");
+    const int fd = connection.callMethod<jint>("getFileDescriptor", "()I");
+    if (env.checkAndClearExceptions() || !readEndpoint.isValid() || !writeEndpoint.isValid()
+        || fd < 0) {
+        return nullptr;
+    }
+
+    UsbFsTransport::Endpoints endpoints;
+    endpoints.in = unsigned(readEndpoint.callMethod<jint>("getAddress", "()I"));
+    endpoints.out = unsigned(writeEndpoint.callMethod<jint>("getAddress", "()I"));
+    endpoints.maxPacketSize = readEndpoint.callMethod<jint>("getMaxPacketSize", "()I");
+
+    auto transport = std::make_shared<UsbFsTransport>(
+        fd, endpoints,
+        ftdi ? UsbFsTransport::PacketFormat::FtdiStatus : UsbFsTransport::PacketFormat::Raw);
+    if (!transport->start()) {
+        qWarning() << "Native transport unavailable, using the Java driver";
+        return nullptr;
+    }
+    return transport;
+}
+
+// A few failed transfers in a row mean the adapter is gone (unplugged,
+// browned out); close the port so that isOpen() reflects that.
+void UsbSerialHelper::recordTransfer(bool succeeded)
+{
+    if (succeeded) {
+        m_consecutiveErrors.store(0, std::memory_order_relaxed);
+        return;
+    }
+
+    if (m_consecutiveErrors.fetch_add(1, std::memory_order_relaxed) + 1 == maxConsecutiveErrors) {
+        qWarning() << "Connection to" << deviceName() << "lost";
+        closeDevice();
+    }
+}
+
+template <typename T, typename Function>
+QFuture<T> UsbSerialHelper::runAsync(AsyncOperation operation, Function function)
+{
+    auto promise = std::make_shared<QPromise<T>>();
+    QFuture<T> future = promise->future();
+    promise->start();
+
+    QElapsedTimer queued;
+    queued.start();
+
+    m_ioPool.start([this, operation, promise, queued, function = std::move(function)]() mutable {
+        const qint64 queueWaitUs = queued.nsecsElapsed() / 1000;
+
+        if (promise->isCanceled()) {
+            recordAsync(operation, queueWaitUs, 0, true);
+            promise->finish();
+            return;
+        }
+
+        QElapsedTimer execution;
+        execution.start();
+        promise->addResult(function(*promise));
+        recordAsync(operation, queueWaitUs, execution.nsecsElapsed() / 1000,
+                    promise->isCanceled());
+        promise->finish();
+    });
+
+    return future;
+}
+
+void UsbSerialHelper::recordAsync(AsyncOperation operation, qint64 queueWaitUs,
+                                  qint64 executionUs, bool cancelled)
+{
+    const auto updateMax = [](std::atomic<qint64> &max, qint64 value) {
+        qint64 current = max.load(std::memory_order_relaxed);
+        while (value > current
+               && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    };
+
+    AsyncCounters &counters = m_asyncCounters[int(operation)];
+    if (cancelled)
+        counters.cancelled.fetch_add(1, std::memory_order_relaxed);
+    else
+        counters.completed.fetch_add(1, std::memory_order_relaxed);
+    counters.totalQueueWaitUs.fetch_add(queueWaitUs, std::memory_order_relaxed);
+    counters.totalExecutionUs.fetch_add(executionUs, std::memory_order_relaxed);
+    updateMax(counters.maxQueueWaitUs, queueWaitUs);
+    updateMax(counters.maxExecutionUs, executionUs);
+}
+
+UsbSerialHelper::AsyncStats UsbSerialHelper::asyncStats(AsyncOperation operation) const
+{
+    const AsyncCounters &counters = m_asyncCounters[int(operation)];
+
+    AsyncStats stats;
+    stats.completed = counters.completed.load(std::memory_order_relaxed);
+    stats.cancelled = counters.cancelled.load(std::memory_order_relaxed);
+    stats.totalQueueWaitUs = counters.totalQueueWaitUs.load(std::memory_order_relaxed);
+    stats.maxQueueWaitUs = counters.maxQueueWaitUs.load(std::memory_order_relaxed);
+    stats.totalExecutionUs = counters.totalExecutionUs.load(std::memory_order_relaxed);
+    stats.maxExecutionUs = counters.maxExecutionUs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+QFuture<QList<UsbSerialHelper::SerialDevice>> UsbSerialHelper::enumerateAsync()
+{
+    return runAsync<QList<SerialDevice>>(AsyncOperation::Enumerate,
+        [](QPromise<QList<SerialDevice>> &) {
+            return getAvailableDevices();
+        });
+}
+
+QFuture<bool> UsbSerialHelper::openAsync(int deviceIndex, int portIndex, int baudRate)
+{
+    return runAsync<bool>(AsyncOperation::Open,
+        [this, deviceIndex, portIndex, baudRate](QPromise<bool> &) {
+            return openDevice(deviceIndex, portIndex, baudRate);
+        });
+}
+
+QFuture<QByteArray> UsbSerialHelper::readAsync(int maxLength, int timeoutMs)
+{
+    return runAsync<QByteArray>(AsyncOperation::Read,
+        [this, maxLength, timeoutMs](QPromise<QByteArray> &promise) {
+            // A timeout of 0 blocks forever in usb-serial-for-android; keep
+            // that meaning, but read in short slices so that cancellation
+            // is noticed without waiting for the full timeout.
+            const QDeadlineTimer deadline = timeoutMs > 0 ? QDeadlineTimer(timeoutMs)
+                                                          : QDeadlineTimer(QDeadlineTimer::Forever);
+            QByteArray data;
+            while (data.isEmpty() && isOpen() && !promise.isCanceled()) {
+                const qint64 remaining = deadline.remainingTime();
+                if (remaining == 0)
+                    break;
+                const int slice = remaining < 0 ? asyncReadSliceMs
+                                                : int(qBound<qint64>(1, remaining, asyncReadSliceMs));
+                data = readData(maxLength, slice);
+            }
+            return data;
+        });
+}
+
+QFuture<bool> UsbSerialHelper::writeAsync(const QByteArray &data, int timeoutMs)
+{
+    return runAsync<bool>(AsyncOperation::Write,
+        [this, data, timeoutMs](QPromise<bool> &) {
+            return writeData(data, timeoutMs);
+        });
+}
+
+void UsbSerialHelper::requestPermission(const QJniObject &usbManager, const QJniObject &usbDevice) {
+    auto *nativeInterface = QCoreApplication::instance()
+    ->nativeInterface<QNativeInterface::QAndroidApplication>();
+    QJniObject context = nativeInterface->context();
+
+    // Create a PendingIntent for the permission request
+    QJniObject action = QJniObject::fromString("com.yourapp.USB_PERMISSION");
+
+    QJniObject pendingIntent = QJniObject::callStaticObjectMethod(
+        "android/app/PendingIntent",
+        "getBroadcast",
+        "(Landroid/content/Context;ILandroid/content/Intent;I)Landroid/app/PendingIntent;",
+        context.object(),
+        0,
+        QJniObject("android/content/Intent", "(Ljava/lang/String;)V", action.object()).object(),
+        0x04000000  // PendingIntent.FLAG_IMMUTABLE
+        );
+
+    // Request permission
+    usbManager.callMethod<void>(
+        "requestPermission",
+        "(Landroid/hardware/usb/UsbDevice;Landroid/app/PendingIntent;)V",
+        usbDevice.object(),
+        pendingIntent.object()
+        );
+
+    qDebug() << "USB permission requested";
+}
+
+
+
+extern "C" {
+
+JNIEXPORT void JNICALL
+Java_org_qtproject_example_appqtjenny_1consumer_UsbConnectionReceiver_notifyUsbDeviceAttached(
+    JNIEnv *env, jobject obj, jstring jDeviceName,
+    jint vendorId, jint productId, jint deviceClass)
+{
+    const char *deviceName = env->GetStringUTFChars(jDeviceName, nullptr);
+
+    qDebug() << "USB Device Attached:" << deviceName
+             << "VID:" << QString::number(vendorId, 16)
+             << "PID:" << QString::number(productId, 16);
+
+    UsbEventHandler::instance()->onDeviceAttached(
+        QString(deviceName), vendorId, productId, deviceClass
+        );
+
+    env->ReleaseStringUTFChars(jDeviceName, deviceName);
+}
+
+JNIEXPORT void JNICALL
+Java_org_qtproject_example_appqtjenny_1consumer_UsbConnectionReceiver_notifyUsbDeviceDetached(
+    JNIEnv *env, jobject obj, jstring jDeviceName)
+{
+    const char *deviceName = env->GetStringUTFChars(jDeviceName, nullptr);
+
+    qDebug() << "USB Device Detached:" << deviceName;
+
+    UsbEventHandler::instance()->onDeviceDetached(QString(deviceName));
+
+    env->ReleaseStringUTFChars(jDeviceName, deviceName);
+}
+
+JNIEXPORT void JNICALL
+Java_org_qtproject_example_appqtjenny_1consumer_UsbConnectionReceiver_notifyAppStartedByUsbDevice(
+    JNIEnv *env, jobject obj, jstring jDeviceName,
+    jint vendorId, jint productId, jstring jDriverName)
+{
+    const char *deviceName = env->GetStringUTFChars(jDeviceName, nullptr);
+    const char *driverName = env->GetStringUTFChars(jDriverName, nullptr);
+
+    qDebug() << "App started by USB device:" << deviceName
+             << "VID:" << QString::number(vendorId, 16)
+             << "PID:" << QString::number(productId, 16)
+             << "Driver:" << driverName;
+
+    // Notify your application logic
+    UsbEventHandler::instance()->onAppStartedByDevice(
+        QString(deviceName), vendorId, productId, QString(driverName)
+        );
+
+    env->ReleaseStringUTFChars(jDeviceName, deviceName);
+    env->ReleaseStringUTFChars(jDriverName, driverName);
+}
+
+} // extern "C"
@@ -1,45 +1,182 @@
-// Copyright (C) 2025 The Qt Company Ltd.
-// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
-#include <QGuiApplication>
-#include <QQmlApplicationEngine>
-#include <QQuickView>
-#include <QTimer>
-
-
-
-class UsbSerialHelper {
-public:
-    struct SerialDevice {
-        QString deviceName;
-        QString driverName;
-        int vendorId;
-        int productId;
-        int portCount;
-    };
-
-    UsbSerialHelper();
-
-    static QList<SerialDevice> getAvailableDevices();
-
-    // Optional: Get a specific driver by index
-    static QJniObject getDriverAtIndex(int index);
-
-    bool openDevice(int deviceIndex, int portIndex = 0, int baudRate = 9600);
-
-    void closeDevice();
-
-    QByteArray readData(int maxLength = 1024, int timeoutMs = 1000);
-
-    bool writeData(const QByteArray &data, int timeoutMs = 1000);
-
-signals:
-    void permissionGranted();
-    void permissionDenied();
-
-private:
-    QJniObject m_driver;
-    QJniObject m_port;
-
-    void requestPermission(const QJniObject &usbManager, const QJniObject &usbDevice);
-};
-
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef USBSERIALHELPER_H
+#define USBSERIALHELPER_H
+
+#include <QGuiApplication>
+#include <QQmlApplicationEngine>
+#include <QQuickView>
+#include <QTimer>
+
+#include <QtCore/QFuture>
+#include <QtCore/QJniObject>
+#include <QtCore/QMutex>
+#include <QtCore/QPromise>
+#include <QtCore/QThreadPool>
+
+#include <atomic>
+#include <memory>
+
+#include "AbstractSerialPort.h"
+#include "PushReceiver.h"
+#include "UsbFsTransport.h"
+
+class UsbSerialHelper : public AbstractSerialPort {
+public:
+    struct SerialDevice {
+        QString deviceName;
+        QString driverName;
+        int vendorId;
+        int productId;
+        QString serialNumber;
+        int portCount;
+    };
+
+    enum class AsyncOperation {
+        Enumerate = 0,
+        Open,
+        Read,
+        Write,
+        Count
+    };
+
+    // Timing of the asynchronous operations. Queue wait is the time a job
+    // spent in the I/O thread pool before it started, execution the time
+    // it then took to run. Times are in microseconds.
+    struct AsyncStats {
+        qint64 completed = 0;
+        qint64 cancelled = 0;
+        qint64 totalQueueWaitUs = 0;
+        qint64 maxQueueWaitUs = 0;
+        qint64 totalExecutionUs = 0;
+        qint64 maxExecutionUs = 0;
+    };
+
+    UsbSerialHelper();
+
+    static QList<SerialDevice> getAvailableDevices();
+
+    // Optional: Get a specific driver by index
+    static QJniObject getDriverAtIndex(int index);
+
+    // Index of the device with the given identity in getAvailableDevices(),
+    // or -1. A device whose serial number is known and equal wins; failing
+    // that, an empty serial number on either side, as on a device that has
+    // not granted permission yet, matches on VID and PID alone.
+    static int findDevice(int vendorId, int productId, const QString &serialNumber = QString());
+
+    bool openDevice(int deviceIndex, int portIndex = 0, int baudRate = 9600);
+
+    void closeDevice();
+
+    bool isOpen() const override;
+
+    // Android device name (e.g. /dev/bus/usb/001/002) of the open device
+    QString deviceName() const;
+
+    QByteArray readData(int maxLength = 1024, int timeoutMs = 1000) override;
+
+    bool writeData(const QByteArray &data, int timeoutMs = 1000) override;
+
+    // Not every chip supports this; returns false then
+    bool purgeBuffers(bool purgeReadBuffers = true, bool purgeWriteBuffers = true) override;
+
+    int baudRate() const override;
+
+    bool setBaudRate(int baudRate) override;
+
+    // Non-blocking variants of the calls above. They run on the helper's
+    // own I/O thread pool, so they can be used from the GUI thread.
+    // Cancelling the returned future before the job has started skips it;
+    // a pending read also stops waiting for data once cancelled.
+    QFuture<QList<SerialDevice>> enumerateAsync();
+    QFuture<bool> openAsync(int deviceIndex, int portIndex = 0, int baudRate = 9600);
+    QFuture<QByteArray> readAsync(int maxLength = 1024, int timeoutMs = 1000);
+    QFuture<bool> writeAsync(const QByteArray &data, int timeoutMs = 1000);
+
+    AsyncStats asyncStats(AsyncOperation operation) const;
+
+    // Reads and writes go straight to usbfs instead of through the Java
+    // driver, for adapters whose bulk data is plain serial data. Takes
+    // effect on the next openDevice(); enabled by default.
+    void setNativeTransportEnabled(bool enabled);
+    bool usesNativeTransport() const;
+
+    // Transfer and line status counters of the native transport; all zero
+    // if it is not in use
+    UsbFsTransport::Stats nativeTransportStats() const;
+
+    // Whether openDevice() asks the user for USB permission when the app
+    // does not have it yet. A retry loop turns this off after the first
+    // attempt, so the dialog does not come up again and again. Enabled by
+    // default.
+    void setPermissionRequestsEnabled(bool enabled);
+
+    // Ports on the Java driver are read by a Java thread that pushes the
+    // data in batches, instead of each readData() calling into Java. Takes
+    // effect on the next openDevice(); enabled by default.
+    void setPushModeEnabled(bool enabled);
+    bool usesPushMode() const;
+
+    // Batch counters of push mode; all zero if it is not in use
+    PushReceiver::Stats pushStats() const;
+
+signals:
+    void permissionGranted();
+    void permissionDenied();
+
+private:
+    struct AsyncCounters {
+        std::atomic<qint64> completed { 0 };
+        std::atomic<qint64> cancelled { 0 };
+        std::atomic<qint64> totalQueueWaitUs { 0 };
+        std::atomic<qint64> maxQueueWaitUs { 0 };
+        std::atomic<qint64> totalExecutionUs { 0 };
+        std::atomic<qint64> maxExecutionUs { 0 };
+    };
+
+    struct PortMethods {
+        jmethodID read;
+        jmethodID write;
+        jmethodID purgeHwBuffers;
+        jmethodID setParameters;
+    };
+
+    static constexpr int asyncReadSliceMs = 50;
+    static constexpr int maxConsecutiveErrors = 3;
+
+    mutable QMutex m_mutex;
+    QJniObject m_driver;
+    QJniObject m_port;
+    std::shared_ptr<UsbFsTransport> m_transport;
+    std::shared_ptr<PushReceiver> m_receiver;
+    QString m_deviceName;
+    int m_baudRate = 0;
+    std::atomic<bool> m_nativeTransportEnabled { true };
+    std::atomic<bool> m_pushModeEnabled { true };
+    std::atomic<bool> m_permissionRequestsEnabled { true };
+    std::atomic<int> m_consecutiveErrors { 0 };
+    AsyncCounters m_asyncCounters[int(AsyncOperation::Count)];
+
+    static const PortMethods &portMethods();
+    static bool setLineParameters(const QJniObject &port, int baudRate);
+    QJniObject currentPort() const;
+    std::shared_ptr<UsbFsTransport> currentTransport() const;
+    std::shared_ptr<PushReceiver> currentReceiver() const;
+    static std::shared_ptr<UsbFsTransport> createTransport(const QJniObject &driver,
+                                                           const QJniObject &port,
+                                                           const QJniObject &connection);
+    void recordTransfer(bool succeeded);
+    void requestPermission(const QJniObject &usbManager, const QJniObject &usbDevice);
+
+    template <typename T, typename Function>
+    QFuture<T> runAsync(AsyncOperation operation, Function function);
+    void recordAsync(AsyncOperation operation, qint64 queueWaitUs, qint64 executionUs,
+                     bool cancelled);
+
+    // Declared last, so that it is destroyed first and waits for all
+    // pending jobs while the rest of the helper is still alive.
+    QThreadPool m_ioPool;
+};
+
+#endif // USBSERIALHELPER_H
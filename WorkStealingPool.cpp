@@ -0,0 +1,127 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "WorkStealingPool.h"
+
+WorkStealingPool::WorkStealingPool(int workerCount, int keyCount, RunFunction run,
+                                   HasWorkFunction hasWork)
+    : m_run(std::move(run)), m_hasWork(std::move(hasWork)),
+      m_scheduled(std::make_unique<std::atomic<bool>[]>(std::size_t(keyCount)))
+{
+    for (int i = 0; i < qMax(1, workerCount); i++)
+        m_workers.push_back(std::make_unique<Worker>());
+    for (int key = 0; key < keyCount; key++)
+        m_scheduled[key].store(false, std::memory_order_relaxed);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    stop();
+}
+
+void WorkStealingPool::start()
+{
+    m_stopping.store(false, std::memory_order_relaxed);
+    for (int i = 0; i < workerCount(); i++) {
+        Worker &worker = *m_workers[i];
+        if (worker.thread)
+            continue;
+        worker.thread.reset(QThread::create([this, i]() { workerLoop(i); }));
+        worker.thread->setObjectName(QStringLiteral("SerialParserPool%1").arg(i));
+        worker.thread->start();
+    }
+}
+
+void WorkStealingPool::stop()
+{
+    m_stopping.store(true, std::memory_order_relaxed);
+    m_workAvailable.release(workerCount());
+    for (const auto &worker : m_workers) {
+        if (!worker->thread)
+            continue;
+        worker->thread->wait();
+        worker->thread.reset();
+    }
+}
+
+void WorkStealingPool::schedule(int key)
+{
+    bool expected = false;
+    if (!m_scheduled[key].compare_exchange_strong(expected, true))
+        return;
+
+    // Spread new keys over the workers; stealing evens out the rest
+    const unsigned worker = m_nextWorker.fetch_add(1, std::memory_order_relaxed) % workerCount();
+    push(*m_workers[worker], key);
+    m_workAvailable.release();
+}
+
+WorkStealingPool::WorkerStats WorkStealingPool::workerStats(int worker) const
+{
+    WorkerStats stats;
+    stats.batches = m_workers.at(worker)->batches.load(std::memory_order_relaxed);
+    stats.steals = m_workers.at(worker)->steals.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void WorkStealingPool::workerLoop(int index)
+{
+    Worker &self = *m_workers[index];
+
+    while (!m_stopping.load(std::memory_order_relaxed)) {
+        int key = -1;
+        if (!takeLocal(self, key) && !steal(index, key)) {
+            m_workAvailable.tryAcquire(1, idleWaitMs);
+            continue;
+        }
+
+        self.batches.fetch_add(1, std::memory_order_relaxed);
+        if (m_run(key)) {
+            // Behind the other keys of this worker, so one busy key cannot
+            // starve the rest. With a backlog, wake an idle worker to steal.
+            if (push(self, key) > 1)
+                m_workAvailable.release();
+            continue;
+        }
+
+        // Sequentially consistent, so that a schedule() that found the key
+        // still set is matched by m_hasWork() seeing the state it acted on
+        m_scheduled[key].store(false);
+        if (m_hasWork(key))
+            schedule(key);
+    }
+}
+
+// Owners work from the front, thieves take from the back
+bool WorkStealingPool::takeLocal(Worker &worker, int &key)
+{
+    QMutexLocker locker(&worker.mutex);
+    if (worker.keys.empty())
+        return false;
+    key = worker.keys.front();
+    worker.keys.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(int thief, int &key)
+{
+    const int count = workerCount();
+    for (int offset = 1; offset < count; offset++) {
+        Worker &victim = *m_workers[(thief + offset) % count];
+        QMutexLocker locker(&victim.mutex);
+        if (victim.keys.empty())
+            continue;
+        key = victim.keys.back();
+        victim.keys.pop_back();
+        m_workers[thief]->steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+std::size_t WorkStealingPool::push(Worker &worker, int key)
+{
+    QMutexLocker locker(&worker.mutex);
+    worker.keys.push_back(key);
+    return worker.keys.size();
+}
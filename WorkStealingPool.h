@@ -0,0 +1,73 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <QtCore/QMutex>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Executor for work that is keyed, e.g. by serial port, and must be
+// processed in order per key. A key is handled by at most one worker at a
+// time, but any worker may pick it up: each worker has its own deque of
+// scheduled keys, and idle workers steal whole keys from the others.
+class WorkStealingPool {
+public:
+    // Processes one batch of work for key; returns true if there is more
+    using RunFunction = std::function<bool(int key)>;
+    // Returns true if key has work waiting; checked after a key has been
+    // released, so that work arriving in that moment is not lost
+    using HasWorkFunction = std::function<bool(int key)>;
+
+    struct WorkerStats {
+        qint64 batches = 0;
+        qint64 steals = 0;
+    };
+
+    WorkStealingPool(int workerCount, int keyCount, RunFunction run, HasWorkFunction hasWork);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    void start();
+    void stop();
+
+    // Thread-safe. Does nothing if key is already scheduled or running.
+    void schedule(int key);
+
+    int workerCount() const { return int(m_workers.size()); }
+    WorkerStats workerStats(int worker) const;
+
+private:
+    struct Worker {
+        mutable QMutex mutex;
+        std::deque<int> keys;
+        std::unique_ptr<QThread> thread;
+        std::atomic<qint64> batches { 0 };
+        std::atomic<qint64> steals { 0 };
+    };
+
+    static constexpr int idleWaitMs = 100;
+
+    void workerLoop(int index);
+    bool takeLocal(Worker &worker, int &key);
+    bool steal(int thief, int &key);
+    std::size_t push(Worker &worker, int key);
+
+    const RunFunction m_run;
+    const HasWorkFunction m_hasWork;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::unique_ptr<std::atomic<bool>[]> m_scheduled;
+    std::atomic<unsigned> m_nextWorker { 0 };
+    std::atomic<bool> m_stopping { false };
+    QSemaphore m_workAvailable;
+};
+
+#endif // WORKSTEALINGPOOL_H
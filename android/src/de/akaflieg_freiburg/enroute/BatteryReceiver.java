@@ -0,0 +1,41 @@
+package org.qtproject.example.appqtjenny_consumer;
+
+import android.content.BroadcastReceiver;
+import android.content.Context;
+import android.content.Intent;
+import android.content.IntentFilter;
+
+// Forwards battery changes to PowerPolicy, which reads the new state
+// through BatteryManager. ACTION_BATTERY_CHANGED can only be received by a
+// receiver registered at runtime.
+public class BatteryReceiver extends BroadcastReceiver
+{
+    private static BatteryReceiver instance = null;
+
+    public static synchronized void register(Context context)
+    {
+        if (instance != null)
+            return;
+        instance = new BatteryReceiver();
+        context.getApplicationContext().registerReceiver(
+            instance, new IntentFilter(Intent.ACTION_BATTERY_CHANGED));
+    }
+
+    public static synchronized void unregister(Context context)
+    {
+        if (instance == null)
+            return;
+        context.getApplicationContext().unregisterReceiver(instance);
+        instance = null;
+    }
+
+    @Override
+    public void onReceive(Context context, Intent intent)
+    {
+        if (Intent.ACTION_BATTERY_CHANGED.equals(intent.getAction()))
+            nativeBatteryChanged();
+    }
+
+    // Native method implemented in C++
+    private static native void nativeBatteryChanged();
+}
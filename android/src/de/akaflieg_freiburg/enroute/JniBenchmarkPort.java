@@ -0,0 +1,37 @@
+package org.qtproject.example.appqtjenny_consumer;
+
+import java.nio.ByteBuffer;
+
+// Stand-in for UsbSerialPort used by JniBenchmark.cpp. It has the same
+// read/write signatures, plus a direct-buffer read, and does no I/O, so
+// that only the cost of crossing JNI and copying the data is measured.
+public class JniBenchmarkPort
+{
+    private final byte[] source = new byte[65536];
+    private final String deviceName = "/dev/bus/usb/001/002";
+
+    public int read(byte[] dest, int timeout)
+    {
+        int length = Math.min(dest.length, source.length);
+        System.arraycopy(source, 0, dest, 0, length);
+        return length;
+    }
+
+    public void write(byte[] src, int timeout)
+    {
+    }
+
+    public int readDirect(ByteBuffer dest, int length)
+    {
+        length = Math.min(length, source.length);
+        dest.clear();
+        dest.put(source, 0, length);
+        return length;
+    }
+
+    // Mimics UsbDevice.getDeviceName() as used while enumerating
+    public String getDeviceName()
+    {
+        return deviceName;
+    }
+}
@@ -0,0 +1,34 @@
+package org.qtproject.example.appqtjenny_consumer;
+
+import android.app.PendingIntent;
+import android.content.BroadcastReceiver;
+import android.content.Context;
+import android.content.Intent;
+
+// Tells NotificationDispatcher that the user dismissed one of its
+// notifications, so that the channel counts its alerts from zero again.
+// The intent names this class, so the receiver needs no intent filter and
+// is not exported.
+public class NotificationDismissReceiver extends BroadcastReceiver
+{
+    private static final String EXTRA_ID = "notificationId";
+
+    // The delete intent of the notification shown under id
+    public static PendingIntent deleteIntent(Context context, int id)
+    {
+        Intent intent = new Intent(context, NotificationDismissReceiver.class);
+        intent.putExtra(EXTRA_ID, id);
+        return PendingIntent.getBroadcast(context, id, intent,
+            PendingIntent.FLAG_UPDATE_CURRENT | PendingIntent.FLAG_IMMUTABLE);
+    }
+
+    @Override
+    public void onReceive(Context context, Intent intent)
+    {
+        if (intent.hasExtra(EXTRA_ID))
+            nativeNotificationDismissed(intent.getIntExtra(EXTRA_ID, 0));
+    }
+
+    // Native method implemented in C++
+    private static native void nativeNotificationDismissed(int id);
+}
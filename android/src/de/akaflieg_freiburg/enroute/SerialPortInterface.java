@@ -1,259 +1,106 @@
-package de.akaflieg_freiburg.enroute;
+package org.qtproject.example.appqtjenny_consumer;
 
-import java.util.HashMap;
-import java.util.List;
-import java.util.concurrent.ExecutorService;
-import java.util.concurrent.Executors;
 import java.io.IOException;
+import java.nio.ByteBuffer;
 
-import android.app.Activity;
-import android.content.BroadcastReceiver;
-import android.content.Context;
-import android.content.Intent;
-import android.content.IntentFilter;
-import android.hardware.usb.*;
-import android.widget.Toast;
-import java.nio.charset.StandardCharsets;
+import com.hoho.android.usbserial.driver.UsbSerialPort;
 
-import com.hoho.android.usbserial.driver.*;
-import com.hoho.android.usbserial.util.*;
-
-//import org.qtproject.SerialPortInterface.SerialInputOutputManager;
-
-//import org.qtproject.qt.android.bindings.QtActivity;
-import org.qtproject.qt.android.QtNative;
-
-public class SerialPortInterface
+// Reads a UsbSerialPort on its own thread and pushes the data to the
+// native PushReceiver. Several reads are collected into one direct buffer
+// and handed over with a single JNI call, once the batch is nearly full or
+// batchMs after its first byte arrived. The native side copies the data
+// before the call returns, so the buffer is reused for the next batch.
+public class SerialPortInterface implements Runnable
 {
-    private static UsbManager usbManager;
-    private static HashMap<String, UsbSerialPort> m_usbSerialPort;
-    private static HashMap<String, SerialInputOutputManager> m_usbIoManager;
+    // Read timeout while no batch is pending; bounds how long stop() waits
+    private static final int IDLE_READ_TIMEOUT_MS = 200;
 
-    private static native void nativeDeviceException(int classPoint, String messageA);
-    private static native void nativeDeviceNewData(int classPoint, byte[] dataA);
+    private final UsbSerialPort m_port;
+    private final long m_handle;
+    private final byte[] m_readBuffer;
+    private final ByteBuffer m_batch;
+    private final long m_batchNs;
+    private final Thread m_thread;
+    private volatile boolean m_running = true;
 
-    public SerialPortInterface()
+    private static native void nativeDeviceNewData(long handle, ByteBuffer data, int length);
+    private static native void nativeDeviceException(long handle, String message);
+
+    private SerialPortInterface(UsbSerialPort port, long handle, int readSize, int batchBytes, int batchMs)
     {
-        //m_instance = this;
-        m_usbIoManager = new HashMap<String, SerialInputOutputManager>();
-        m_usbSerialPort = new HashMap<String, UsbSerialPort>();
+        m_port = port;
+        m_handle = handle;
+        m_readBuffer = new byte[readSize];
+        m_batch = ByteBuffer.allocateDirect(Math.max(batchBytes, readSize));
+        m_batchNs = batchMs * 1000000L;
+        m_thread = new Thread(this, "SerialReader");
+        m_thread.setPriority(Thread.MAX_PRIORITY);
     }
 
-    /*
-    private static boolean getCurrentDevices()
+    public static SerialPortInterface start(UsbSerialPort port, long handle, int readSize, int batchBytes, int batchMs)
     {
-        if (QtNative.activity() == null)
-            return false;
-
-        if (usbManager == null)
-            usbManager = (UsbManager)QtNative.activity().getSystemService(Context.USB_SERVICE);
-
-        return true;
+        SerialPortInterface reader = new SerialPortInterface(port, handle, readSize, batchBytes, batchMs);
+        reader.m_thread.start();
+        return reader;
     }
 
-    public static String[] availableDevicesInfo()
+    // Returns once the last batch has been delivered
+    public void stop()
     {
-        //  GET THE LIST OF CURRENT DEVICES
-        if (!getCurrentDevices())
-            return null;
-
-        if (usbManager.getDeviceList().size() < 1)
-            return null;
-
-        String[] listL = new String[usbManager.getDeviceList().size()];
-        String tempL;
-
-        UsbSerialProber usbDefaultProber = UsbSerialProber.getDefaultProber();
-        int countL = 0;
-        for(UsbDevice deviceL : usbManager.getDeviceList().values()) {
-
-            UsbSerialDriver driverL = usbDefaultProber.probeDevice(deviceL);
-            tempL = deviceL.getDeviceName() + ":";
-
-            if (driverL == null) {
-                tempL = tempL + "Unknown:";
-            }
-            else if (driverL instanceof CdcAcmSerialDriver)
-            {
-                tempL = tempL + "Cdc Acm:";
-            }
-            else if (driverL instanceof Ch34xSerialDriver)
-            {
-                tempL = tempL + "Ch34x:";
-            }
-            else if (driverL instanceof CommonUsbSerialPort)
-            {
-                tempL = tempL + "CommonUsb:";
+        m_running = false;
+        boolean interrupted = false;
+        while (m_thread.isAlive()) {
+            try {
+                m_thread.join();
             }
-            else if (driverL instanceof Cp21xxSerialDriver)
-            {
-                tempL = tempL + "Cp21xx:";
+            catch (InterruptedException e) {
+                interrupted = true;
             }
-            else if (driverL instanceof FtdiSerialDriver)
-            {
-                tempL = tempL + "Ftdi:";
-            }
-            else if (driverL instanceof ProlificSerialDriver)
-            {
-                tempL = tempL + "Prolific:";
-            }
-
-            tempL = tempL + deviceL.getManufacturerName() + ":";
-
-            tempL = tempL + Integer.toString(deviceL.getProductId()) + ":";
-            tempL = tempL + Integer.toString(deviceL.getVendorId()) + ":";
-
-            listL[countL] = tempL;
-            countL++;
         }
-
-        return listL;
+        if (interrupted)
+            Thread.currentThread().interrupt();
     }
 
-    public static boolean setParameters(String portNameA, int baudRateA, int dataBitsA, int stopBitsA, int parityA)
+    @Override
+    public void run()
     {
-        if (m_usbSerialPort.size() <= 0)
-            return false;
-
-        if (m_usbSerialPort.get(portNameA) == null)
-            return false;
-
-        try
-        {
-            m_usbSerialPort.get(portNameA).setParameters(baudRateA, dataBitsA, stopBitsA, parityA);
-            return true;
+        long batchStart = 0;
+        try {
+            while (m_running) {
+                int timeout = IDLE_READ_TIMEOUT_MS;
+                if (m_batch.position() > 0)
+                    timeout = (int)Math.max(1, (m_batchNs - (System.nanoTime() - batchStart)) / 1000000);
+
+                int length = m_port.read(m_readBuffer, timeout);
+                if (length > 0) {
+                    if (m_batch.position() == 0)
+                        batchStart = System.nanoTime();
+                    m_batch.put(m_readBuffer, 0, length);
+                }
+
+                if (m_batch.position() > 0
+                    && (m_batch.remaining() < m_readBuffer.length
+                        || System.nanoTime() - batchStart >= m_batchNs))
+                    flush();
+            }
+            flush();
         }
-        catch(IOException eA)
-        {
-            return false;
+        // The driver also fails with unchecked exceptions, e.g. an
+        // IllegalStateException once the connection has been closed.
+        // Without this, the thread would die silently and the native side
+        // would keep waiting for a port it still considers running.
+        catch (IOException | RuntimeException e) {
+            flush();
+            if (m_running)
+                nativeDeviceException(m_handle, e.getMessage() != null ? e.getMessage() : e.toString());
         }
     }
 
-    public static void stopIoManager(String portNameA)
+    private void flush()
     {
-        if (m_usbIoManager.get(portNameA) == null)
+        if (m_batch.position() == 0)
             return;
-
-        m_usbIoManager.get(portNameA).stop();
-        m_usbIoManager.remove(portNameA);
+        nativeDeviceNewData(m_handle, m_batch, m_batch.position());
+        m_batch.clear();
     }
-
-    public static void startIoManager(String portNameA, int classPoint)
-    {
-        if (m_usbSerialPort.get(portNameA) == null)
-            return;
-
-        SerialInputOutputManager usbIoManager = new SerialInputOutputManager(m_usbSerialPort.get(portNameA), m_Listener, classPoint);
-
-        m_usbIoManager.put(portNameA, usbIoManager);
-        m_usbIoManager.get(portNameA).start();
-    }
-
-    public static boolean close(String portNameA)
-    {
-        if (m_usbSerialPort.get(portNameA) == null)
-            return false;
-
-        try
-        {
-            stopIoManager(portNameA);
-            m_usbSerialPort.get(portNameA).close();
-            m_usbSerialPort.remove(portNameA);
-
-            return true;
-        }
-        catch (IOException eA)
-        {
-            return false;
-        }
-    }
-
-    public static int open(String portNameA, int classPoint)
-    {
-        //  GET THE LIST OF CURRENT DEVICES
-        if (!getCurrentDevices())
-            return 0;
-
-        if (usbManager.getDeviceList().size() < 1)
-            return 0;
-
-        if (m_usbSerialPort.get(portNameA) != null)
-            return 0;
-
-        UsbSerialProber usbDefaultProber = UsbSerialProber.getDefaultProber();
-        for(UsbDevice deviceL : usbManager.getDeviceList().values()) {
-
-            if (portNameA.equals(deviceL.getDeviceName()))
-            {
-            }
-            else
-            {
-                continue;
-            }
-
-            UsbSerialDriver driverL = usbDefaultProber.probeDevice(deviceL);
-            if (driverL == null)
-            {
-                return 0;
-            }
-
-            UsbDeviceConnection connectionL = usbManager.openDevice(driverL.getDevice());
-            if (connectionL == null) {
-                return 0;
-            }
-
-            UsbSerialPort usbSerialPort = driverL.getPorts().get(0);
-
-            try{
-                usbSerialPort.open(connectionL);
-                m_usbSerialPort.put(portNameA ,usbSerialPort);
-
-                startIoManager(portNameA, classPoint);
-
-                return 1;
-            }
-            catch (Exception e) {
-                m_usbSerialPort.remove(portNameA);
-                stopIoManager(portNameA);
-                return 0;
-            }
-        }
-        return 0;
-    }
-
-    public static int write(String portNameA, byte[] sourceA, int timeoutMSecA)
-    {
-        if (m_usbSerialPort.get(portNameA) == null)
-            return 0;
-
-        try
-        {
-            System.out.println("Serial write:" + new String(sourceA, StandardCharsets.UTF_8));
-            m_usbSerialPort.get(portNameA).write(sourceA, timeoutMSecA);
-        }
-        catch (IOException eA)
-        {
-            return 0;
-        }
-
-        return 1;
-    }
-
-    // SerialInputOutputManager.Listener
-
-    private final static SerialInputOutputManager.Listener m_Listener =
-    new SerialInputOutputManager.Listener()
-    {
-        @Override
-        public void onNewData(byte[] data, int classPoint) {
-            nativeDeviceNewData(classPoint, data);
-            System.out.println("Serial read:" + new String(data, StandardCharsets.UTF_8));
-        };
-
-        @Override
-        public void onRunError(Exception e, int classPoint) {
-            nativeDeviceException(classPoint, e.getMessage());
-        }
-    };
-    */
 }
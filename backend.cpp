@@ -1,205 +1,496 @@
-// Copyright (C) 2025 The Qt Company Ltd.
-// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
-
-#include "backend.h"
-
-BackEnd::BackEnd(QObject *parent) : QObject{ parent }
-{
-    using namespace android::os;
-    using namespace android::app;
-
-    // Initialize members
-    m_qAndroidApp = qGuiApp->nativeInterface<QNativeInterface::QAndroidApplication>();
-    m_context = ContextProxy(m_qAndroidApp->context());
-    m_activityContext = ActivityProxy(m_qAndroidApp->context());
-    PowerManagerProxy powerManager = m_activityContext.getSystemService(
-        QJniObject::fromString(m_context.POWER_SERVICE).object<jstring>());
-    m_audioManager = m_activityContext.getSystemService(
-        QJniObject::fromString(m_context.AUDIO_SERVICE).object<jstring>());
-    m_window = m_activityContext.getWindow();
-    m_layoutParams = m_window.getAttributes();
-    m_partialWakeLock = powerManager.newWakeLock(powerManager.PARTIAL_WAKE_LOCK,
-        QJniObject::fromString("PARTIALWAKELOCK").object<jstring>());
-
-    // If system implements a fixed volume policy, disable volume slider
-    if (m_audioManager.isVolumeFixed())
-        handleVolumeError("Device implements fixed volume setting.", "");
-
-    m_qAndroidApp->runOnAndroidMainThread([&]() {
-        m_layoutParams.setScreenBrightness(0.5);
-        m_window.setAttributes(m_layoutParams);
-    });
-
-    createNotification();
-}
-
-void BackEnd::vibrate()
-{
-    using namespace android::os;
-
-    VibrationEffectProxy effect;
-    VibratorManagerProxy vibratorManager;
-    VibratorProxy vibrator;
-
-    if (m_systemVersion >= 12) {
-        vibratorManager = m_activityContext.getSystemService(
-            QJniObject::fromString(m_context.VIBRATOR_MANAGER_SERVICE).object<jstring>());
-        vibrator = vibratorManager.getDefaultVibrator();
-    } else {
-        vibrator = m_activityContext.getSystemService(
-            QJniObject::fromString(m_context.VIBRATOR_SERVICE).object<jstring>());
-    }
-
-    effect = VibrationEffectProxy().createOneShot(
-        vibrateTimeInMillisecs, VibrationEffectProxy().DEFAULT_AMPLITUDE);
-    vibrator.vibrate(effect->object<jobject>());
-}
-
-// Posts an Android notification
-void BackEnd::notify()
-{
-    using namespace QtAndroidPrivate;
-
-    PermissionResult result = checkPermission("android.permission.POST_NOTIFICATIONS").result();
-
-    if (result == Authorized || m_systemVersion <= 12) {
-        m_notificationManager.notify(0, m_notification);
-    } else {
-        requestPermission("android.permission.POST_NOTIFICATIONS").then(
-            [&](PermissionResult result) {
-                if (result == Denied)
-                    qWarning() << "POST_NOTIFICATIONS permission was denied";
-                else if (result == Authorized)
-                    m_notificationManager.notify(0, m_notification);
-            });
-    }
-}
-
-// Adjust system volume, either lowering or raising based on given direction
-void BackEnd::adjustVolume(enum Direction direction)
-{
-    if (m_global.getInt(m_context.getContentResolver().object<jobject>(),
-                        QJniObject::fromString("zen_mode").object<jstring>()) != 0) {
-        handleVolumeError("Do not Disturb mode is on",
-                          "Disable Do not Disturb mode to adjust the volume");
-    } else if (m_audioManager.getRingerMode() != m_audioManager.RINGER_MODE_NORMAL) {
-        if (m_audioManager.getRingerMode() == m_audioManager.RINGER_MODE_VIBRATE) {
-            handleVolumeError("Vibrate only mode is on",
-                              "Disable vibrate only mode to adjust volume.");
-        } else if (m_audioManager.getRingerMode() == m_audioManager.RINGER_MODE_SILENT) {
-            handleVolumeError("Silent mode is on", "Disable Silent mode to adjust the volume.");
-        }
-    } else if (direction == Direction::Up) {
-        m_audioManager.adjustVolume(m_audioManager.ADJUST_RAISE, m_audioManager.FLAG_SHOW_UI);
-    } else if (direction == Direction::Down) {
-        m_audioManager.adjustVolume(m_audioManager.ADJUST_LOWER, m_audioManager.FLAG_SHOW_UI);
-    }
-}
-
-// Adjust system brightness, either lowering or raising based on given direction
-void BackEnd::adjustBrightness(enum Direction direction)
-{
-    using namespace android::content;
-    using namespace android::provider;
-
-    IntentProxy m_intent = m_intent.newInstance(QJniObject::fromString(
-        SettingsProxy::ACTION_MANAGE_WRITE_SETTINGS).object<jstring>());
-
-    // Check if app has permission to write system settings.
-    // Start an Activity with the ACTION_MANAGE_WRITE_SETTINGS intent if app
-    // does not have permission to write said settings, after which user
-    // has to manually give the permission to this app.
-    if (!m_system.canWrite(m_context))
-        m_context.startActivity(m_intent);
-
-    int brightness = m_system.getInt(m_context.getContentResolver().object<jobject>(),
-        QJniObject::fromString(m_system.SCREEN_BRIGHTNESS).object<jstring>());
-
-    if (direction == Direction::Up) {
-        if (brightness <= maxBrightness)
-            brightness += 10;
-    } else if (direction == Direction::Down) {
-        if (brightness >= minBrightness)
-            brightness -= 10;
-    }
-
-    double brightnessToDouble = brightnessStep * (brightness / 10.0);
-
-    // We need to set the brightness to system settings and to Window separately, as
-    // synchronization does not happen automatically and updating one or
-    // the other only, leaves the other one out of sync.
-    m_system.putInt(m_context.getContentResolver().object<jobject>(),
-        QJniObject::fromString(m_system.SCREEN_BRIGHTNESS).object<jstring>(),
-        brightness);
-    m_qAndroidApp->runOnAndroidMainThread([this, brightness = brightnessToDouble]() {
-        m_layoutParams.setScreenBrightness(brightness);
-        m_window.setAttributes(m_layoutParams);
-    });
-}
-
-void BackEnd::setPartialWakeLock()
-{
-    m_partialWakeLock.acquire(m_activityContext);
-}
-
-void BackEnd::disablePartialWakeLock()
-{
-    m_partialWakeLock.release(m_activityContext);
-}
-
-void BackEnd::setFullWakeLock()
-{
-    m_qAndroidApp->runOnAndroidMainThread([&]() {
-        m_window.addFlags(m_layoutParams.FLAG_KEEP_SCREEN_ON);
-    }).then([]() {
-            qInfo() << "Full WakeLock set";
-        });
-}
-
-void BackEnd::disableFullWakeLock()
-{
-    m_qAndroidApp->runOnAndroidMainThread([&]() {
-        m_window.clearFlags(m_layoutParams.FLAG_KEEP_SCREEN_ON);
-    }).then([]() {
-            qInfo() << "Full WakeLock released";
-        });
-}
-
-// Creates a notification that is later posted in notify() method
-void BackEnd::createNotification()
-{
-    using namespace android::app;
-    using namespace android::drawable;
-
-    NotificationChannelProxy channel;
-    BuilderProxy builder;
-
-    channel = NotificationChannelProxy().newInstance(
-        QJniObject::fromString("01").object<jstring>(),
-        QJniObject::fromString("QtJenny").object<jstring>(),
-        m_notificationManager.IMPORTANCE_HIGH);
-
-    m_notificationManager = m_activityContext.getSystemService(
-        QJniObject::fromString(m_context.NOTIFICATION_SERVICE).object<jstring>());
-    m_notificationManager.createNotificationChannel(channel);
-
-    builder = BuilderProxy().newInstance(m_context,
-        QJniObject::fromString(channel.getId().toString()).object<jstring>());
-    builder.setSmallIcon(drawableProxy::ic_dialog_info);
-    builder.setContentTitle(QJniObject::fromString("QtJenny").object<jstring>());
-    builder.setContentText(QJniObject::fromString(
-                                 "Hello from QtJenny app!").object<jstring>());
-    builder.setDefaults(m_notification.DEFAULT_SOUND);
-    builder.setAutoCancel(true);
-    m_notification = builder.build();
-}
-
-void BackEnd::handleVolumeError(const QString &problem, const QString &solution)
-{
-    if (!problem.isEmpty())
-        qWarning() << problem;
-
-    const QString message = problem.isEmpty() ? solution
-                                              : problem + "\n" + solution;
-    emit showPopup(message);
-}
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include "backend.h"
+#include "PowerPolicy.h"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFuture>
+#include <QtCore/QJniObject>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/private/qandroidextras_p.h>
+
+#include <utility>
+
+#include <qtjenny_output/jenny/proxy/android_app_ActivityProxy.h>
+#include <qtjenny_output/jenny/proxy/android_app_BuilderProxy.h>
+#include <qtjenny_output/jenny/proxy/android_app_NotificationChannelProxy.h>
+#include <qtjenny_output/jenny/proxy/android_app_NotificationManagerProxy.h>
+#include <qtjenny_output/jenny/proxy/android_app_NotificationProxy.h>
+#include <qtjenny_output/jenny/proxy/android_content_IntentProxy.h>
+#include <qtjenny_output/jenny/proxy/android_drawable_drawableProxy.h>
+#include <qtjenny_output/jenny/proxy/android_media_AudioManagerProxy.h>
+#include <qtjenny_output/jenny/proxy/android_os_ContextProxy.h>
+#include <qtjenny_output/jenny/proxy/android_os_PowerManagerProxy.h>
+#include <qtjenny_output/jenny/proxy/android_os_VibrationEffectProxy.h>
+#include <qtjenny_output/jenny/proxy/android_os_VibratorManagerProxy.h>
+#include <qtjenny_output/jenny/proxy/android_os_VibratorProxy.h>
+#include <qtjenny_output/jenny/proxy/android_os_WakeLockProxy.h>
+#include <qtjenny_output/jenny/proxy/android_provider_GlobalProxy.h>
+#include <qtjenny_output/jenny/proxy/android_provider_SettingsProxy.h>
+#include <qtjenny_output/jenny/proxy/android_provider_SystemProxy.h>
+#include <qtjenny_output/jenny/proxy/android_view_LayoutParamsProxy.h>
+#include <qtjenny_output/jenny/proxy/android_view_WindowProxy.h>
+
+struct BackEnd::Proxies
+{
+    android::app::ActivityProxy activityContext;
+    android::app::BuilderProxy notificationBuilder;
+    android::app::NotificationManagerProxy notificationManager;
+    android::app::NotificationProxy notification;
+    android::media::AudioManagerProxy audioManager;
+    android::os::ContextProxy context;
+    android::os::WakeLockProxy partialWakeLock;
+    android::provider::GlobalProxy global;
+    android::provider::SystemProxy system;
+    android::view::LayoutParamsProxy layoutParams;
+    android::view::WindowProxy window;
+};
+
+namespace {
+
+// For the dismissals, which arrive on the Android main thread
+QMutex backEndsMutex;
+QList<BackEnd *> backEnds;
+
+} // namespace
+
+BackEnd::BackEnd(QObject *parent)
+    : QObject{ parent },
+      m_proxies(std::make_unique<Proxies>()),
+      m_notifications([this](const NotificationDispatcher::Notification &notification) {
+          showNotification(notification);
+      })
+{
+    // Keep the thread, and with it its attachment to the Java VM, for the
+    // lifetime of the backend
+    m_jniPool.setMaxThreadCount(1);
+    m_jniPool.setExpiryTimeout(-1);
+    m_jniPool.setObjectName("BackEndJni");
+
+    prewarmProxies();
+
+    m_qAndroidApp = qGuiApp->nativeInterface<QNativeInterface::QAndroidApplication>();
+    postJni("initialize", [this]() { initialize(); });
+
+    QMutexLocker locker(&backEndsMutex);
+    backEnds.append(this);
+
+    // Give up wake locks the power policy no longer allows
+    connect(PowerPolicy::instance(), &PowerPolicy::modeChanged, this, [this]() {
+        const PowerPolicy::Budget budget = PowerPolicy::instance()->budget();
+        if (!budget.allowPartialWakeLock) {
+            postJni("powerPolicy", [this]() {
+                if (m_proxies->partialWakeLock.isHeld()) {
+                    m_proxies->partialWakeLock.release(m_proxies->activityContext);
+                    postToGui([this]() {
+                        emit showPopup("The wake lock was released because the battery is low.");
+                    });
+                }
+            });
+        }
+        if (!budget.allowFullWakeLock)
+            disableFullWakeLock();
+    });
+
+    // Permissions may have been changed in the system settings meanwhile
+    connect(qGuiApp, &QGuiApplication::applicationStateChanged, this,
+            [this](Qt::ApplicationState state) {
+                // The permission dialog only makes the app inactive, so a
+                // refused permission is forgotten only after the user left
+                // the app, for example for the system settings
+                if (state == Qt::ApplicationSuspended || state == Qt::ApplicationHidden)
+                    m_wasInBackground = true;
+                else if (state == Qt::ApplicationActive)
+                    refreshPermissions(std::exchange(m_wasInBackground, false));
+            });
+}
+
+// m_jniPool is destroyed first and waits for the pending commands
+BackEnd::~BackEnd()
+{
+    QMutexLocker locker(&backEndsMutex);
+    backEnds.removeOne(this);
+}
+
+void BackEnd::onNotificationDismissed(int id)
+{
+    QMutexLocker locker(&backEndsMutex);
+    for (BackEnd *backEnd : std::as_const(backEnds)) {
+        QMetaObject::invokeMethod(backEnd, [backEnd, id]() {
+            backEnd->m_notifications.dismissed(id);
+        }, Qt::QueuedConnection);
+    }
+}
+
+void BackEnd::initialize()
+{
+    using namespace android::os;
+    using namespace android::app;
+
+    m_proxies->context = ContextProxy(m_qAndroidApp->context());
+    m_proxies->activityContext = ActivityProxy(m_qAndroidApp->context());
+
+    // Temporaries are views on local references; only what is kept in a
+    // member is promoted to a global reference
+    ActivityProxyView activity = m_proxies->activityContext.view();
+    PowerManagerProxyView powerManager = activity.getSystemService(m_proxies->context.POWER_SERVICE);
+    m_proxies->audioManager = activity.getSystemService(m_proxies->context.AUDIO_SERVICE);
+    m_proxies->window = m_proxies->activityContext.getWindow();
+    m_proxies->layoutParams = m_proxies->window.getAttributes();
+    m_proxies->partialWakeLock = powerManager.newWakeLock(powerManager.PARTIAL_WAKE_LOCK, "PARTIALWAKELOCK");
+
+    // If system implements a fixed volume policy, disable volume slider
+    if (m_proxies->audioManager.isVolumeFixed()) {
+        postToGui([this]() {
+            m_isFixedVolume = true;
+            emit isFixedVolumeChanged();
+        });
+        handleVolumeError("Device implements fixed volume setting.", "");
+    }
+
+    runOnAndroidMainThread([this]() {
+        m_proxies->layoutParams.setScreenBrightness(0.5);
+        m_proxies->window.setAttributes(m_proxies->layoutParams);
+    });
+
+    createNotification();
+    refreshPermissions(false);
+}
+
+void BackEnd::refreshPermissions(bool forgetDenial)
+{
+    postJni("refreshPermissions", [this, forgetDenial]() {
+        using namespace QtAndroidPrivate;
+
+        m_canPostNotifications = m_systemVersion <= 12
+            || checkPermission("android.permission.POST_NOTIFICATIONS").result() == Authorized;
+        if (forgetDenial)
+            m_notificationsDenied = false;
+        m_canWriteSettings = m_proxies->system.canWrite(m_proxies->context);
+    });
+}
+
+void BackEnd::vibrate()
+{
+    postJni("vibrate", [this]() {
+        using namespace android::app;
+        using namespace android::os;
+
+        ActivityProxyView activity = m_proxies->activityContext.view();
+        VibrationEffectProxyView effect;
+        VibratorManagerProxyView vibratorManager;
+        VibratorProxyView vibrator;
+
+        if (m_systemVersion >= 12) {
+            vibratorManager = activity.getSystemService(m_proxies->context.VIBRATOR_MANAGER_SERVICE);
+            vibrator = vibratorManager.getDefaultVibrator();
+        } else {
+            vibrator = activity.getSystemService(m_proxies->context.VIBRATOR_SERVICE);
+        }
+
+        effect = VibrationEffectProxyView().createOneShot(
+            vibrateTimeInMillisecs, VibrationEffectProxyView().DEFAULT_AMPLITUDE);
+        vibrator.vibrate(effect->object<jobject>());
+    });
+}
+
+// Posts an Android notification
+void BackEnd::notify()
+{
+    alert("QtJenny", "QtJenny", "Hello from QtJenny app!");
+}
+
+void BackEnd::alert(const QString &channel, const QString &title, const QString &text)
+{
+    m_notifications.post(channel, title, text);
+}
+
+// Called by the dispatcher when the content of a notification changed
+void BackEnd::showNotification(const NotificationDispatcher::Notification &notification)
+{
+    postJni("notify", [this, notification]() {
+        using namespace QtAndroidPrivate;
+
+        if (m_canPostNotifications) {
+            postNotification(notification);
+            return;
+        }
+        // Asked once, until the app returns from the background after a
+        // refusal; alerts in the meantime are dropped
+        if (m_notificationsDenied || m_askingForNotifications)
+            return;
+
+        // The answer arrives once the user closed the permission dialog
+        m_askingForNotifications = true;
+        requestPermission("android.permission.POST_NOTIFICATIONS").then(this,
+            [this, notification](PermissionResult result) {
+                const bool authorized = result == Authorized;
+                postJni("notify", [this, authorized, notification]() {
+                    m_askingForNotifications = false;
+                    m_canPostNotifications = authorized;
+                    m_notificationsDenied = !authorized;
+                    if (authorized)
+                        postNotification(notification);
+                });
+                if (result == Denied) {
+                    qWarning() << "POST_NOTIFICATIONS permission was denied";
+                    emit showPopup("Notifications are not allowed for this app.");
+                }
+            });
+    });
+}
+
+// Rebuilds the notification through the cached builder, which keeps the
+// channel, icon and flags, and posts or updates it under the alert's id
+void BackEnd::postNotification(const NotificationDispatcher::Notification &notification)
+{
+    const QString title = notification.count > 1
+        ? QString("%1 (%2)").arg(notification.title).arg(notification.count)
+        : notification.title;
+    m_proxies->notificationBuilder.setContentTitle(qtjenny::LocalRef::fromString(title).object<jstring>());
+    m_proxies->notificationBuilder.setContentText(
+        qtjenny::LocalRef::fromString(notification.text).object<jstring>());
+    // Tells the dispatcher when the user swipes the notification away
+    const QJniObject deleteIntent = QJniObject::callStaticMethod<jobject>(
+        "org/qtproject/example/appqtjenny_consumer/NotificationDismissReceiver",
+        "deleteIntent",
+        "(Landroid/content/Context;I)Landroid/app/PendingIntent;",
+        m_proxies->context->object(), jint(notification.id));
+    m_proxies->notificationBuilder.setDeleteIntent(deleteIntent.object());
+    m_proxies->notification = m_proxies->notificationBuilder.build();
+    m_proxies->notificationManager.notify(notification.id, m_proxies->notification);
+    postToGui([this]() { emit notificationPosted(); });
+}
+
+// Adjust system volume, either lowering or raising based on given direction
+void BackEnd::adjustVolume(enum Direction direction)
+{
+    postJni("adjustVolume", [this, direction]() {
+        if (m_proxies->global.getInt(m_proxies->context.view().getContentResolver().object<jobject>(), "zen_mode") != 0) {
+            handleVolumeError("Do not Disturb mode is on",
+                              "Disable Do not Disturb mode to adjust the volume");
+        } else if (m_proxies->audioManager.getRingerMode() != m_proxies->audioManager.RINGER_MODE_NORMAL) {
+            if (m_proxies->audioManager.getRingerMode() == m_proxies->audioManager.RINGER_MODE_VIBRATE) {
+                handleVolumeError("Vibrate only mode is on",
+                                  "Disable vibrate only mode to adjust volume.");
+            } else if (m_proxies->audioManager.getRingerMode() == m_proxies->audioManager.RINGER_MODE_SILENT) {
+                handleVolumeError("Silent mode is on", "Disable Silent mode to adjust the volume.");
+            }
+        } else if (direction == Direction::Up) {
+            m_proxies->audioManager.adjustVolume(m_proxies->audioManager.ADJUST_RAISE, m_proxies->audioManager.FLAG_SHOW_UI);
+        } else if (direction == Direction::Down) {
+            m_proxies->audioManager.adjustVolume(m_proxies->audioManager.ADJUST_LOWER, m_proxies->audioManager.FLAG_SHOW_UI);
+        }
+    });
+}
+
+// Adjust system brightness, either lowering or raising based on given direction
+void BackEnd::adjustBrightness(enum Direction direction)
+{
+    postJni("adjustBrightness", [this, direction]() {
+        using namespace android::content;
+        using namespace android::os;
+        using namespace android::provider;
+
+        ContextProxyView context = m_proxies->context.view();
+
+        // Check if app has permission to write system settings.
+        // Start an Activity with the ACTION_MANAGE_WRITE_SETTINGS intent if app
+        // does not have permission to write said settings, after which user
+        // has to manually give the permission to this app. Returning from
+        // there resumes the app, which refreshes the cached permission.
+        if (!m_canWriteSettings) {
+            IntentProxyView intent =
+                IntentProxyView().newInstance(SettingsProxy::ACTION_MANAGE_WRITE_SETTINGS);
+            context.startActivity(intent);
+            return;
+        }
+
+        const qtjenny::LocalRef contentResolver = context.getContentResolver();
+        const qtjenny::LocalRef brightnessSetting =
+            qtjenny::LocalRef::fromString(m_proxies->system.SCREEN_BRIGHTNESS);
+        int brightness = m_proxies->system.getInt(contentResolver.object<jobject>(),
+            brightnessSetting.object<jstring>());
+
+        if (direction == Direction::Up) {
+            if (brightness <= maxBrightness)
+                brightness += 10;
+        } else if (direction == Direction::Down) {
+            if (brightness >= minBrightness)
+                brightness -= 10;
+        }
+
+        double brightnessToDouble = brightnessStep * (brightness / 10.0);
+
+        // We need to set the brightness to system settings and to Window separately, as
+        // synchronization does not happen automatically and updating one or
+        // the other only, leaves the other one out of sync.
+        m_proxies->system.putInt(contentResolver.object<jobject>(), brightnessSetting.object<jstring>(),
+            brightness);
+        runOnAndroidMainThread([this, brightness = brightnessToDouble]() {
+            m_proxies->layoutParams.setScreenBrightness(brightness);
+            m_proxies->window.setAttributes(m_proxies->layoutParams);
+        });
+    });
+}
+
+void BackEnd::setPartialWakeLock()
+{
+    if (!PowerPolicy::instance()->budget().allowPartialWakeLock) {
+        emit showPopup("Wake locks are disabled while the battery is low.");
+        return;
+    }
+    postJni("setPartialWakeLock", [this]() { m_proxies->partialWakeLock.acquire(m_proxies->activityContext); });
+}
+
+void BackEnd::disablePartialWakeLock()
+{
+    postJni("disablePartialWakeLock", [this]() { m_proxies->partialWakeLock.release(m_proxies->activityContext); });
+}
+
+// Queued like the other commands, so that it runs after initialize()
+void BackEnd::setFullWakeLock()
+{
+    if (!PowerPolicy::instance()->budget().allowFullWakeLock) {
+        emit showPopup("Keeping the screen on is disabled while on battery saver.");
+        return;
+    }
+    postJni("setFullWakeLock", [this]() {
+        const bool done = runOnAndroidMainThread([this]() {
+            m_proxies->window.addFlags(m_proxies->layoutParams.FLAG_KEEP_SCREEN_ON);
+        });
+        if (done)
+            qInfo() << "Full WakeLock set";
+    });
+}
+
+void BackEnd::disableFullWakeLock()
+{
+    postJni("disableFullWakeLock", [this]() {
+        const bool done = runOnAndroidMainThread([this]() {
+            m_proxies->window.clearFlags(m_proxies->layoutParams.FLAG_KEEP_SCREEN_ON);
+        });
+        if (done)
+            qInfo() << "Full WakeLock released";
+    });
+}
+
+// Creates the notification channel and the builder that postNotification()
+// reuses for every update
+void BackEnd::createNotification()
+{
+    using namespace android::app;
+    using namespace android::drawable;
+
+    NotificationChannelProxyView channel;
+
+    // The channel name is a CharSequence, which has no string overload
+    channel = NotificationChannelProxyView().newInstance("01",
+        qtjenny::LocalRef::fromString("QtJenny").object<jstring>(),
+        m_proxies->notificationManager.IMPORTANCE_HIGH);
+
+    m_proxies->notificationManager =
+        m_proxies->activityContext.view().getSystemService(m_proxies->context.NOTIFICATION_SERVICE);
+    m_proxies->notificationManager.createNotificationChannel(channel);
+
+    m_proxies->notificationBuilder = BuilderProxyView().newInstance(m_proxies->context,
+        channel.getId().object<jstring>());
+    m_proxies->notificationBuilder.setSmallIcon(drawableProxy::ic_dialog_info);
+    m_proxies->notificationBuilder.setDefaults(m_proxies->notification.DEFAULT_SOUND);
+    m_proxies->notificationBuilder.setAutoCancel(true);
+    // Updates of a shown notification do not sound again
+    m_proxies->notificationBuilder.setOnlyAlertOnce(true);
+}
+
+// Loads the proxied Java classes and resolves their members on a background
+// thread, so that the first vibrate or notify does not pay for it
+void BackEnd::prewarmProxies()
+{
+    QThread *thread = QThread::create([]() {
+        const qtjenny::PrewarmStats stats = qtjenny::prewarm();
+        qInfo() << "Prewarmed" << stats.classes << "proxy classes and" << stats.members
+                << "members in" << stats.elapsedNs / 1000000.0 << "ms;"
+                << stats.missingClasses << "classes and" << stats.missingMembers
+                << "members not available on this device";
+    });
+    thread->setObjectName("JniPrewarm");
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    thread->start(QThread::LowPriority);
+}
+
+// Opt-in, like the JNI benchmark, as the monitor logs every few seconds
+void BackEnd::monitorFrames(QQuickWindow *window)
+{
+    if (qEnvironmentVariableIsSet("QTJENNY_FRAME_STATS"))
+        m_frameMonitor.attach(window);
+}
+
+void BackEnd::postJni(const char *command, std::function<void()> job)
+{
+    QElapsedTimer queued;
+    queued.start();
+
+    auto run = [command, queued, job = std::move(job)]() {
+        const qint64 queueWaitMs = queued.elapsed();
+
+        QElapsedTimer execution;
+        execution.start();
+        job();
+        if (execution.elapsed() >= slowCommandMs) {
+            qDebug() << command << "took" << execution.elapsed() << "ms after waiting"
+                     << queueWaitMs << "ms";
+        }
+    };
+
+    if (m_jniOnGuiThread)
+        run();
+    else
+        m_jniPool.start(std::move(run));
+}
+
+// The window may only be changed on the Android main thread. Waiting keeps
+// the change in order with the other commands and lets m_jniPool wait for
+// it on destruction; the timeout keeps the JNI thread from hanging when the
+// main thread is blocked, for example while the app shuts down.
+bool BackEnd::runOnAndroidMainThread(std::function<void()> function)
+{
+    QFuture<void> future = m_qAndroidApp->runOnAndroidMainThread(
+        std::move(function), QDeadlineTimer(androidMainThreadTimeoutMs));
+    future.waitForFinished();
+    if (future.isCanceled()) {
+        qWarning() << "The Android main thread did not respond in time";
+        return false;
+    }
+    return true;
+}
+
+// Signal handlers in QML must run on the GUI thread
+void BackEnd::postToGui(std::function<void()> function)
+{
+    QMetaObject::invokeMethod(this, std::move(function), Qt::QueuedConnection);
+}
+
+void BackEnd::handleVolumeError(const QString &problem, const QString &solution)
+{
+    if (!problem.isEmpty())
+        qWarning() << problem;
+
+    const QString message = problem.isEmpty() ? solution
+                                              : problem + "\n" + solution;
+    postToGui([this, message]() { emit showPopup(message); });
+}
+
+extern "C" {
+
+JNIEXPORT void JNICALL
+Java_org_qtproject_example_appqtjenny_1consumer_NotificationDismissReceiver_nativeNotificationDismissed(
+    JNIEnv *, jclass, jint id)
+{
+    BackEnd::onNotificationDismissed(id);
+}
+
+} // extern "C"
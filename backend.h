@@ -1,90 +1,124 @@
-// Copyright (C) 2025 The Qt Company Ltd.
-// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
-#ifndef BACKEND_H
-#define BACKEND_H
-
-#include <QtCore/QCoreApplication>
-#include <QtCore/QJniObject>
-#include <QtCore/QObject>
-#include <QtCore/QOperatingSystemVersion>
-#include <QtCore/QString>
-#include <QtCore/private/qandroidextras_p.h>
-#include <QtQml/qqml.h>
-#include <QtGui/qguiapplication.h>
-
-#include <qtjenny_output/jenny/proxy/android_app_ActivityProxy.h>
-#include <qtjenny_output/jenny/proxy/android_app_BuilderProxy.h>
-#include <qtjenny_output/jenny/proxy/android_app_NotificationChannelProxy.h>
-#include <qtjenny_output/jenny/proxy/android_app_NotificationManagerProxy.h>
-#include <qtjenny_output/jenny/proxy/android_app_NotificationProxy.h>
-#include <qtjenny_output/jenny/proxy/android_content_IntentProxy.h>
-#include <qtjenny_output/jenny/proxy/android_drawable_drawableProxy.h>
-#include <qtjenny_output/jenny/proxy/android_media_AudioManagerProxy.h>
-#include <qtjenny_output/jenny/proxy/android_os_ContextProxy.h>
-#include <qtjenny_output/jenny/proxy/android_os_PowerManagerProxy.h>
-#include <qtjenny_output/jenny/proxy/android_os_VibrationEffectProxy.h>
-#include <qtjenny_output/jenny/proxy/android_os_VibratorManagerProxy.h>
-#include <qtjenny_output/jenny/proxy/android_os_VibratorProxy.h>
-#include <qtjenny_output/jenny/proxy/android_os_WakeLockProxy.h>
-#include <qtjenny_output/jenny/proxy/android_provider_GlobalProxy.h>
-#include <qtjenny_output/jenny/proxy/android_provider_SettingsProxy.h>
-#include <qtjenny_output/jenny/proxy/android_provider_SystemProxy.h>
-#include <qtjenny_output/jenny/proxy/android_view_LayoutParamsProxy.h>
-#include <qtjenny_output/jenny/proxy/android_view_WindowProxy.h>
-
-class BackEnd : public QObject
-{
-    Q_OBJECT
-    QML_ELEMENT
-
-public:
-    explicit BackEnd(QObject *parent = nullptr);
-
-    enum class Direction {
-        Down = 0,
-        Up = 1
-    };
-
-    Q_ENUM(Direction)
-
-    Q_INVOKABLE void disableFullWakeLock();
-    Q_INVOKABLE void disablePartialWakeLock();
-    Q_INVOKABLE void notify();
-    Q_INVOKABLE void setFullWakeLock();
-    Q_INVOKABLE void setPartialWakeLock();
-    Q_INVOKABLE void vibrate();
-    Q_INVOKABLE void adjustBrightness(enum Direction);
-    Q_INVOKABLE void adjustVolume(enum Direction);
-
-    Q_PROPERTY(bool isFixedVolume READ isFixedVolume CONSTANT)
-
-    bool isFixedVolume() const
-    { return m_audioManager.isVolumeFixed(); }
-
-signals:
-    void showPopup(const QString &volumeDisabledReason);
-
-private:
-    const int m_systemVersion = QOperatingSystemVersion::current().version().majorVersion();
-
-    static constexpr int vibrateTimeInMillisecs = 1000;
-    static constexpr int maxBrightness = 245;
-    static constexpr int minBrightness = 10;
-    static constexpr double brightnessStep = 10.0 / 255;
-
-    void createNotification();
-    void handleVolumeError(const QString &problem, const QString &solution);
-
-    QNativeInterface::QAndroidApplication *m_qAndroidApp;
-    android::app::ActivityProxy m_activityContext;
-    android::app::NotificationManagerProxy m_notificationManager;
-    android::app::NotificationProxy m_notification;
-    android::media::AudioManagerProxy m_audioManager;
-    android::os::ContextProxy m_context;
-    android::os::WakeLockProxy m_partialWakeLock;
-    android::provider::GlobalProxy m_global;
-    android::provider::SystemProxy m_system;
-    android::view::LayoutParamsProxy m_layoutParams;
-    android::view::WindowProxy m_window;
-};
-#endif // BACKEND_H
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QObject>
+#include <QtCore/QOperatingSystemVersion>
+#include <QtCore/QString>
+#include <QtCore/QThreadPool>
+#include <QtQml/qqml.h>
+#include <QtGui/qguiapplication.h>
+#include <QtQuick/QQuickWindow>
+
+#include <functional>
+#include <memory>
+
+#include "FrameTimeMonitor.h"
+#include "NotificationDispatcher.h"
+
+// The invokables only queue their JNI work on a dedicated thread and
+// return at once; results and errors come back as signals on the GUI thread.
+class BackEnd : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+
+public:
+    explicit BackEnd(QObject *parent = nullptr);
+    ~BackEnd() override;
+
+    enum class Direction {
+        Down = 0,
+        Up = 1
+    };
+
+    Q_ENUM(Direction)
+
+    Q_INVOKABLE void disableFullWakeLock();
+    Q_INVOKABLE void disablePartialWakeLock();
+    Q_INVOKABLE void notify();
+    // Shows an alert in the channel's notification, rate limited and
+    // coalesced with the channel's earlier alerts
+    Q_INVOKABLE void alert(const QString &channel, const QString &title, const QString &text);
+    Q_INVOKABLE void setFullWakeLock();
+    Q_INVOKABLE void setPartialWakeLock();
+    Q_INVOKABLE void vibrate();
+    Q_INVOKABLE void adjustBrightness(enum Direction);
+    Q_INVOKABLE void adjustVolume(enum Direction);
+
+    // Called by NotificationDismissReceiver on the Android main thread
+    static void onNotificationDismissed(int id);
+
+    // Logs frame time statistics of the window if QTJENNY_FRAME_STATS is
+    // set, see FrameTimeMonitor
+    Q_INVOKABLE void monitorFrames(QQuickWindow *window);
+
+    Q_PROPERTY(bool isFixedVolume READ isFixedVolume NOTIFY isFixedVolumeChanged)
+
+    bool isFixedVolume() const
+    { return m_isFixedVolume; }
+
+signals:
+    void showPopup(const QString &volumeDisabledReason);
+    void isFixedVolumeChanged();
+    void notificationPosted();
+
+private:
+    const int m_systemVersion = QOperatingSystemVersion::current().version().majorVersion();
+
+    static constexpr int vibrateTimeInMillisecs = 1000;
+    static constexpr int maxBrightness = 245;
+    static constexpr int minBrightness = 10;
+    static constexpr double brightnessStep = 10.0 / 255;
+    // Commands taking longer than this are logged
+    static constexpr int slowCommandMs = 50;
+    // Longest wait of the JNI thread for the Android main thread
+    static constexpr int androidMainThreadTimeoutMs = 1000;
+
+    // Runs the commands on the GUI thread, as before the JNI thread, to
+    // compare the frame times of both with QTJENNY_FRAME_STATS
+    const bool m_jniOnGuiThread = qEnvironmentVariableIsSet("QTJENNY_JNI_ON_GUI_THREAD");
+
+    static void prewarmProxies();
+    void initialize();
+    void refreshPermissions(bool forgetDenial);
+    void postJni(const char *command, std::function<void()> job);
+    void postToGui(std::function<void()> function);
+    bool runOnAndroidMainThread(std::function<void()> function);
+    void showNotification(const NotificationDispatcher::Notification &notification);
+    void postNotification(const NotificationDispatcher::Notification &notification);
+    void createNotification();
+    void handleVolumeError(const QString &problem, const QString &solution);
+
+    // The generated proxies, kept out of this header so that moc and the
+    // QML type registration do not parse the proxy headers
+    struct Proxies;
+
+    QNativeInterface::QAndroidApplication *m_qAndroidApp;
+    std::unique_ptr<Proxies> m_proxies;
+
+    bool m_isFixedVolume = false;
+    // Set when the app went to the background, on the GUI thread
+    bool m_wasInBackground = false;
+
+    // Permission state, refreshed when the app becomes active and when a
+    // permission request is answered. Only used on the JNI thread.
+    bool m_canPostNotifications = false;
+    // Set while POST_NOTIFICATIONS is requested and after the user refused
+    // it, until the app returns from the background. Alerts are dropped
+    // meanwhile instead of asking again.
+    bool m_notificationsDenied = false;
+    bool m_askingForNotifications = false;
+    bool m_canWriteSettings = false;
+    FrameTimeMonitor m_frameMonitor;
+    NotificationDispatcher m_notifications;
+
+    // A single thread, so commands run in order and the proxies above are
+    // only used from it, or from the Android main thread while it waits, see
+    // runOnAndroidMainThread(). Declared last, so that it is destroyed first
+    // and waits for pending commands while the proxies are still alive.
+    QThreadPool m_jniPool;
+};
+#endif // BACKEND_H
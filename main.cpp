@@ -1,91 +1,127 @@
-// Copyright (C) 2025 The Qt Company Ltd.
-// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
-#include <QGuiApplication>
-#include <QQmlApplicationEngine>
-#include <QQuickView>
-#include <QTimer>
-
-#include "UsbSerialHelper.h"
-
-
-int main(int argc, char *argv[])
-{
-    // In some cases Android app might not be able to safely clean all threads
-    // while calling exit() and it might crash.
-    // This flag avoids calling exit() and lets the Android system handle this,
-    // at the cost of not attempting to run global destructors.
-    qputenv("QT_ANDROID_NO_EXIT_CALL", "true");
-
-    QGuiApplication app(argc, argv);
-
-
-    UsbSerialHelper helper;
-
-    // List all available USB serial devices
-    qDebug() << "=== Scanning for USB Serial Devices ===";
-    QList<UsbSerialHelper::SerialDevice> devices =
-        UsbSerialHelper::getAvailableDevices();
-
-    if (devices.isEmpty()) {
-        qDebug() << "No USB serial devices found";
-    } else {
-        qWarning() << "\nSummary:";
-        for (int i = 0; i < devices.size(); i++) {
-            const auto &device = devices[i];
-            qWarning() << QString("[%1] %2 (%3) - VID:0x%4 PID:0x%5")
-                              .arg(i)
-                              .arg(device.deviceName)
-                              .arg(device.driverName)
-                              .arg(device.vendorId, 4, 16, QChar('0'))
-                              .arg(device.productId, 4, 16, QChar('0'));
-        }
-
-        // Open the first device
-        qDebug() << "\n=== Opening Device 0 ===";
-        if (!helper.openDevice(0, 0, 9600)) {
-            qDebug() << "Failed to open device - check permissions";
-            // In a real app, you'd wait for permission callback and retry
-            return 1;
-        }
-
-        // Write some data
-        qDebug() << "\n=== Writing Data ===";
-        QByteArray testData = "Hello USB!\r\n";
-        if (helper.writeData(testData)) {
-            qDebug() << "Successfully wrote:" << testData;
-        }
-
-        // Read data continuously for 10 seconds
-        qDebug() << "\n=== Reading Data ===";
-        QTimer *readTimer = new QTimer(&app);
-        int readCount = 0;
-        const int maxReads = 10;
-
-        QObject::connect(readTimer, &QTimer::timeout, [&]() {
-            QByteArray data = helper.readData(1024, 100);
-
-            if (!data.isEmpty()) {
-                qDebug() << "Received" << data.size() << "bytes:" << data;
-            } else {
-                qDebug() << "No data available";
-            }
-
-            readCount++;
-            if (readCount >= maxReads) {
-                readTimer->stop();
-                helper.closeDevice();
-            }
-        });
-
-        readTimer->start(1000); // Read every second
-    }
-
-
-    QQmlApplicationEngine engine;
-    QObject::connect(
-        &engine, &QQmlApplicationEngine::objectCreationFailed, &app,
-        []() { QCoreApplication::exit(-1); }, Qt::QueuedConnection);
-    engine.loadFromModule("qtjenny_consumer", "Main");
-
-    return app.exec();
-}
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+#include <QGuiApplication>
+#include <QQmlApplicationEngine>
+#include <QQuickView>
+#include <QTimer>
+
+#include <memory>
+
+#include "JniBenchmark.h"
+#include "NmeaParser.h"
+#include "PortWatchdog.h"
+#include "PowerPolicy.h"
+#include "SerialPipeline.h"
+#include "SerialSession.h"
+#include "UsbSerialDevice.h"
+#include "UsbSerialHelper.h"
+
+
+int main(int argc, char *argv[])
+{
+    // In some cases Android app might not be able to safely clean all threads
+    // while calling exit() and it might crash.
+    // This flag avoids calling exit() and lets the Android system handle this,
+    // at the cost of not attempting to run global destructors.
+    qputenv("QT_ANDROID_NO_EXIT_CALL", "true");
+
+    QGuiApplication app(argc, argv);
+
+    // Opt-in measurement of the JNI call variants, see JniBenchmark.h
+    if (qEnvironmentVariableIsSet("QTJENNY_JNI_BENCHMARK"))
+        JniBenchmark::run();
+
+    // Created here, so that it lives in the GUI thread
+    PowerPolicy *powerPolicy = PowerPolicy::instance();
+
+    // List all available USB serial devices
+    qDebug() << "=== Scanning for USB Serial Devices ===";
+    QList<UsbSerialHelper::SerialDevice> devices =
+        UsbSerialHelper::getAvailableDevices();
+
+    // The live port: a supervised session on the first device, parsed by
+    // the pipeline and watched for stalls and checksum error bursts. The
+    // pipeline is declared last, so that it stops reading first.
+    std::unique_ptr<UsbSerialDevice> device;
+    std::unique_ptr<SerialSession> session;
+    std::unique_ptr<PortWatchdog> watchdog;
+    SerialPipeline pipeline;
+
+    if (devices.isEmpty()) {
+        qDebug() << "No USB serial devices found";
+    } else {
+        qWarning() << "\nSummary:";
+        for (int i = 0; i < devices.size(); i++) {
+            const auto &device = devices[i];
+            qWarning() << QString("[%1] %2 (%3) - VID:0x%4 PID:0x%5")
+                              .arg(i)
+                              .arg(device.deviceName)
+                              .arg(device.driverName)
+                              .arg(device.vendorId, 4, 16, QChar('0'))
+                              .arg(device.productId, 4, 16, QChar('0'));
+        }
+
+        // Open the first device
+        qDebug() << "\n=== Opening Device 0 ===";
+        device = std::make_unique<UsbSerialDevice>(devices[0], 0, 9600);
+        session = std::make_unique<SerialSession>(device.get());
+        QObject::connect(device.get(), &UsbSerialDevice::detached,
+                         session.get(), &SerialSession::reopen);
+        QObject::connect(device.get(), &UsbSerialDevice::attached,
+                         session.get(), &SerialSession::retryNow);
+
+        if (!session->open()) {
+            qDebug() << "Failed to open device - check permissions";
+            // In a real app, you'd wait for permission callback and retry
+            return 1;
+        }
+
+        // Write some data
+        qDebug() << "\n=== Writing Data ===";
+        QByteArray testData = "Hello USB!\r\n";
+        if (session->writeData(testData)) {
+            qDebug() << "Successfully wrote:" << testData;
+        }
+
+        watchdog = std::make_unique<PortWatchdog>(session.get());
+        QObject::connect(&pipeline, &SerialPipeline::framesReady, watchdog.get(),
+                         [watchdog = watchdog.get()](int, const QList<SerialFrame> &frames,
+                                                     int checksumErrors) {
+                             watchdog->reportFrames(frames.size(), checksumErrors);
+                         });
+
+        // Read continuously
+        qDebug() << "\n=== Reading Data ===";
+        QObject::connect(&pipeline, &SerialPipeline::framesReady, &app,
+                         [](int, const QList<SerialFrame> &frames, int checksumErrors) {
+                             qDebug() << "Received" << frames.size() << "sentences,"
+                                      << checksumErrors << "with checksum errors";
+                         });
+
+        // Hand frames to the GUI thread as often as the power mode allows
+        const auto applyPowerPolicy = [&pipeline, powerPolicy]() {
+            SerialPipeline::Config config = pipeline.config();
+            config.deliveryIntervalMs = powerPolicy->uiUpdateInterval();
+            pipeline.setConfig(config);
+        };
+        applyPowerPolicy();
+        pipeline.addPort(session.get(), std::make_unique<NmeaParser>());
+        pipeline.start();
+
+        QObject::connect(powerPolicy, &PowerPolicy::modeChanged, &pipeline,
+                         [&pipeline, applyPowerPolicy]() {
+                             pipeline.stop();
+                             applyPowerPolicy();
+                             pipeline.start();
+                         });
+    }
+
+
+    QQmlApplicationEngine engine;
+    QObject::connect(
+        &engine, &QQmlApplicationEngine::objectCreationFailed, &app,
+        []() { QCoreApplication::exit(-1); }, Qt::QueuedConnection);
+    engine.loadFromModule("qtjenny_consumer", "Main");
+
+    return app.exec();
+}
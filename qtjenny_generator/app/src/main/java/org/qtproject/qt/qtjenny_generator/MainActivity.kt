@@ -1,5 +1,5 @@
-package org.qtproject.qt.qtjenny_generator
-
-import androidx.activity.ComponentActivity
-
-class MainActivity : ComponentActivity() {}
+package org.qtproject.qt.qtjenny_generator
+
+import androidx.activity.ComponentActivity
+
+class MainActivity : ComponentActivity() {}
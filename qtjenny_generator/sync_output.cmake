@@ -0,0 +1,33 @@
+# Copyright (C) 2025 The Qt Company Ltd.
+# SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+# Copies the files generated by QtJenny from SOURCE_DIR to DESTINATION_DIR.
+# A file is only rewritten when its content hash differs from the existing
+# copy, so regenerating unchanged proxies does not touch their timestamps.
+
+foreach(variable SOURCE_DIR DESTINATION_DIR)
+    if (NOT DEFINED ${variable})
+        message(FATAL_ERROR "sync_output.cmake: ${variable} is not set")
+    endif()
+endforeach()
+
+file(GLOB_RECURSE generated_files RELATIVE "${SOURCE_DIR}" "${SOURCE_DIR}/*")
+
+set(updated 0)
+foreach(file IN LISTS generated_files)
+    set(destination "${DESTINATION_DIR}/${file}")
+    if (EXISTS "${destination}")
+        file(SHA256 "${SOURCE_DIR}/${file}" new_hash)
+        file(SHA256 "${destination}" old_hash)
+        if (new_hash STREQUAL old_hash)
+            continue()
+        endif()
+    endif()
+    get_filename_component(destination_dir "${destination}" DIRECTORY)
+    file(MAKE_DIRECTORY "${destination_dir}")
+    file(COPY_FILE "${SOURCE_DIR}/${file}" "${destination}")
+    math(EXPR updated "${updated} + 1")
+endforeach()
+
+list(LENGTH generated_files total)
+message(STATUS "QtJenny: ${updated} of ${total} generated files changed")
@@ -0,0 +1,123 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtTest/QTest>
+
+#include <cstdlib>
+#include <memory>
+
+#include "AllocationTracker.h"
+
+class tst_AllocationTracker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void operatorNew();
+    void qtContainers();
+    void reallocation();
+    void reservedBufferDoesNotAllocate();
+    void nestedScopes();
+};
+
+void tst_AllocationTracker::init()
+{
+    AllocationTracker::reset();
+}
+
+void tst_AllocationTracker::operatorNew()
+{
+    qint64 allocations = 0;
+    {
+        AllocationTracker::Scope scope(AllocationTracker::Stage::Read);
+        auto value = std::make_unique<int>(1);
+        allocations = scope.allocations();
+    }
+    QCOMPARE(allocations, qint64(1));
+
+    const AllocationTracker::Stats stats = AllocationTracker::stats(AllocationTracker::Stage::Read);
+    QCOMPARE(stats.scopes, qint64(1));
+    QCOMPARE(stats.allocations, qint64(1));
+    QCOMPARE(stats.deallocations, qint64(1));
+}
+
+// Qt's containers allocate with malloc() inside QtCore
+void tst_AllocationTracker::qtContainers()
+{
+    if (!AllocationTracker::isComplete())
+        QSKIP("Only operator new is counted on this platform");
+
+    qint64 allocations = 0;
+    {
+        AllocationTracker::Scope scope(AllocationTracker::Stage::Parse);
+        QByteArray bytes(1024, 'x');
+        QString string(100, u'y');
+        QList<int> list;
+        list.append(1);
+        allocations = scope.allocations();
+    }
+    QCOMPARE(allocations, qint64(3));
+    QCOMPARE(AllocationTracker::stats(AllocationTracker::Stage::Parse).deallocations, qint64(3));
+}
+
+void tst_AllocationTracker::reallocation()
+{
+    if (!AllocationTracker::isComplete())
+        QSKIP("Only operator new is counted on this platform");
+
+    qint64 allocations = 0;
+    {
+        AllocationTracker::Scope scope(AllocationTracker::Stage::Read);
+        void *p = std::malloc(16);
+        p = std::realloc(p, 1 << 20);
+        std::free(p);
+        allocations = scope.allocations();
+    }
+    QCOMPARE(allocations, qint64(2));
+
+    const AllocationTracker::Stats stats = AllocationTracker::stats(AllocationTracker::Stage::Read);
+    QCOMPARE(stats.allocatedBytes, qint64(16 + (1 << 20)));
+    QCOMPARE(stats.deallocations, qint64(2));
+}
+
+void tst_AllocationTracker::reservedBufferDoesNotAllocate()
+{
+    QByteArray buffer;
+    buffer.reserve(4096);
+
+    qint64 allocations = -1;
+    {
+        AllocationTracker::Scope scope(AllocationTracker::Stage::Publish);
+        for (int i = 0; i < 64; ++i)
+            buffer.append("$GPGGA,,,,,,0,,,,,,,,*66\r\n");
+        allocations = scope.allocations();
+    }
+    QCOMPARE(allocations, qint64(0));
+}
+
+// Allocations go to the innermost scope's stage; the outer scope's
+// allocations() includes them
+void tst_AllocationTracker::nestedScopes()
+{
+    qint64 outerAllocations = 0;
+    {
+        AllocationTracker::Scope outer(AllocationTracker::Stage::Publish);
+        auto first = std::make_unique<int>(1);
+        {
+            AllocationTracker::Scope inner(AllocationTracker::Stage::Write);
+            auto second = std::make_unique<int>(2);
+            auto third = std::make_unique<int>(3);
+        }
+        outerAllocations = outer.allocations();
+    }
+    QCOMPARE(outerAllocations, qint64(3));
+    QCOMPARE(AllocationTracker::stats(AllocationTracker::Stage::Publish).allocations, qint64(1));
+    QCOMPARE(AllocationTracker::stats(AllocationTracker::Stage::Write).allocations, qint64(2));
+}
+
+QTEST_GUILESS_MAIN(tst_AllocationTracker)
+#include "tst_allocationtracker.moc"
@@ -0,0 +1,188 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <QtTest/QTest>
+
+#include <utility>
+
+#include "BaudRateNegotiator.h"
+#include "SimulatedSerialPort.h"
+
+namespace {
+
+// Device that understands the commands of request(). Bytes only get
+// through when both sides run at the same rate; otherwise each side
+// sees garbage.
+class FakeDevice : public AbstractSerialPort
+{
+public:
+    static constexpr int defaultBaudRate = 115200;
+
+    // Sends NMEA sentences without a pause
+    bool chatty = false;
+    bool answersProbe = true;
+
+    int deviceBaudRate = defaultBaudRate;
+    QList<QByteArray> commands;
+
+    bool isOpen() const override { return true; }
+
+    QByteArray readData(int maxLength, int timeoutMs) override
+    {
+        QByteArray data = std::exchange(m_pending, QByteArray());
+        if (chatty)
+            data.append("$GPGSV,3,1,12,01,40,083,46*7A\r\n");
+        if (data.isEmpty()) {
+            QThread::msleep(qMin(timeoutMs, 5));
+            return data;
+        }
+        if (m_portBaudRate != deviceBaudRate)
+            data.fill('\xff');
+        return data.left(maxLength);
+    }
+
+    bool writeData(const QByteArray &data, int) override
+    {
+        if (m_portBaudRate != deviceBaudRate)
+            return true;
+        commands.append(data);
+        if (data == "BAUD 921600\r\n") {
+            m_pending.append("OK\r\n");
+            deviceBaudRate = 921600;
+        } else if (data == "BAUD 115200\r\n") {
+            deviceBaudRate = defaultBaudRate;
+        } else if (data == "PING\r\n" && answersProbe) {
+            m_pending.append("PONG\r\n");
+        }
+        return true;
+    }
+
+    int baudRate() const override { return m_portBaudRate; }
+
+    bool setBaudRate(int baudRate) override
+    {
+        m_portBaudRate = baudRate;
+        return true;
+    }
+
+private:
+    int m_portBaudRate = defaultBaudRate;
+    QByteArray m_pending;
+};
+
+} // namespace
+
+class tst_BaudRateNegotiator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void switchesQuietDevice();
+    void failsOnChattyLine();
+    void revertsWhenLineStaysBusy();
+    void revertsWhenDeviceDoesNotAnswer();
+    void rejectsEmptyExpectedReply();
+
+private:
+    static BaudRateNegotiator::Request request();
+    static void silence(SimulatedSerialPort &port);
+};
+
+BaudRateNegotiator::Request tst_BaudRateNegotiator::request()
+{
+    BaudRateNegotiator::Request request;
+    request.baudRate = 921600;
+    request.switchCommand = "BAUD 921600\r\n";
+    request.probe = "PING\r\n";
+    request.expectedReply = "PONG";
+    request.revertCommand = "BAUD 115200\r\n";
+    return request;
+}
+
+void tst_BaudRateNegotiator::silence(SimulatedSerialPort &port)
+{
+    SimulatedSerialPort::Profile profile;
+    profile.traffic = SimulatedSerialPort::Traffic::None;
+    port.setProfile(profile);
+    port.readData(64 * 1024, 0);
+}
+
+void tst_BaudRateNegotiator::switchesQuietDevice()
+{
+    SimulatedSerialPort port;
+    silence(port);
+    port.setResponder([](const QByteArray &written) {
+        return written.contains("PING") ? QByteArray("PONG\r\n") : QByteArray();
+    });
+
+    BaudRateNegotiator negotiator(&port);
+    QVERIFY(negotiator.negotiate(request()));
+    QCOMPARE(port.baudRate(), 921600);
+}
+
+void tst_BaudRateNegotiator::failsOnChattyLine()
+{
+    // Bursts every few milliseconds never leave the drain time of quiet
+    SimulatedSerialPort port;
+    SimulatedSerialPort::Profile profile;
+    profile.traffic = SimulatedSerialPort::Traffic::RandomBursts;
+    profile.rateHz = 200;
+    profile.burstBytes = 64;
+    port.setProfile(profile);
+
+    BaudRateNegotiator negotiator(&port);
+    QElapsedTimer elapsed;
+    elapsed.start();
+    QVERIFY(!negotiator.negotiate(request()));
+    QVERIFY2(elapsed.elapsed() < 5000, "negotiate() does not give up on a busy line");
+    QCOMPARE(port.baudRate(), 115200);
+}
+
+void tst_BaudRateNegotiator::revertsWhenLineStaysBusy()
+{
+    // The device takes the switch command, but its chatter never lets the
+    // line drain. It must not be left behind at the new rate.
+    FakeDevice device;
+    device.chatty = true;
+
+    BaudRateNegotiator negotiator(&device);
+    negotiator.setDrainTime(5);
+    negotiator.setProbeTimeout(20);
+    QVERIFY(!negotiator.negotiate(request()));
+    QCOMPARE(device.baudRate(), FakeDevice::defaultBaudRate);
+    QCOMPARE(device.deviceBaudRate, FakeDevice::defaultBaudRate);
+    QVERIFY(device.commands.contains(request().revertCommand));
+}
+
+void tst_BaudRateNegotiator::revertsWhenDeviceDoesNotAnswer()
+{
+    FakeDevice device;
+    device.answersProbe = false;
+
+    BaudRateNegotiator negotiator(&device);
+    negotiator.setDrainTime(5);
+    negotiator.setProbeTimeout(20);
+    QVERIFY(!negotiator.negotiate(request()));
+    QCOMPARE(device.baudRate(), FakeDevice::defaultBaudRate);
+    QCOMPARE(device.deviceBaudRate, FakeDevice::defaultBaudRate);
+    // Probed at the new rate, and once more after falling back
+    QCOMPARE(device.commands.count(request().probe), 2 * negotiator.probeAttempts());
+}
+
+void tst_BaudRateNegotiator::rejectsEmptyExpectedReply()
+{
+    FakeDevice device;
+    BaudRateNegotiator::Request unverifiable = request();
+    unverifiable.expectedReply.clear();
+
+    BaudRateNegotiator negotiator(&device);
+    QVERIFY(!negotiator.negotiate(unverifiable));
+    QVERIFY(device.commands.isEmpty());
+    QCOMPARE(device.baudRate(), FakeDevice::defaultBaudRate);
+}
+
+QTEST_GUILESS_MAIN(tst_BaudRateNegotiator)
+
+#include "tst_baudratenegotiator.moc"
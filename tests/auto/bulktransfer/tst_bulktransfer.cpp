@@ -0,0 +1,258 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtCore/QBuffer>
+#include <QtCore/QtEndian>
+#include <QtTest/QTest>
+
+#include <algorithm>
+
+#include "BulkTransfer.h"
+#include "SimulatedSerialPort.h"
+
+namespace {
+
+// The logger protocol of tst_bench_bulktransfer:
+//   request  'G' index:u32
+//   reply    STX index:u32 length:u16 payload xor-checksum
+constexpr char requestTag = 'G';
+constexpr char replyTag = 0x02;
+constexpr qsizetype requestSize = 5;
+constexpr qsizetype replyHeaderSize = 7;
+constexpr int blockSize = 64;
+
+QByteArray blockPayload(quint32 index)
+{
+    QByteArray payload(blockSize, Qt::Uninitialized);
+    for (int i = 0; i < blockSize; i++)
+        payload[i] = char((index * 31 + i) & 0xff);
+    return payload;
+}
+
+QByteArray expectedOutput(quint32 blockCount)
+{
+    QByteArray expected;
+    for (quint32 index = 0; index < blockCount; index++)
+        expected.append(blockPayload(index));
+    return expected;
+}
+
+class LoggerProtocol : public BlockProtocol
+{
+public:
+    QByteArray blockRequest(quint32 index) const override
+    {
+        QByteArray request(requestSize, Qt::Uninitialized);
+        request[0] = requestTag;
+        qToBigEndian(index, request.data() + 1);
+        return request;
+    }
+
+    ParseStatus parse(QByteArray &buffer, Block &block) const override
+    {
+        if (buffer.isEmpty())
+            return ParseStatus::NeedMoreData;
+        if (buffer[0] != replyTag) {
+            buffer.remove(0, 1);
+            return ParseStatus::Corrupt;
+        }
+        if (buffer.size() < replyHeaderSize)
+            return ParseStatus::NeedMoreData;
+
+        const quint16 length = qFromBigEndian<quint16>(buffer.constData() + 5);
+        if (buffer.size() < replyHeaderSize + length + 1)
+            return ParseStatus::NeedMoreData;
+
+        char checksum = 0;
+        for (qsizetype i = replyHeaderSize; i < replyHeaderSize + length; i++)
+            checksum ^= buffer[i];
+        if (checksum != buffer[replyHeaderSize + length]) {
+            buffer.remove(0, 1);
+            return ParseStatus::Corrupt;
+        }
+
+        block.index = qFromBigEndian<quint32>(buffer.constData() + 1);
+        block.payload = buffer.mid(replyHeaderSize, length);
+        buffer.remove(0, replyHeaderSize + length + 1);
+        return ParseStatus::Block;
+    }
+};
+
+QList<quint32> requestedBlocks(const QByteArray &written)
+{
+    QList<quint32> indices;
+    for (qsizetype at = 0; at + requestSize <= written.size(); at += requestSize) {
+        if (written[at] == requestTag)
+            indices.append(qFromBigEndian<quint32>(written.constData() + at + 1));
+    }
+    return indices;
+}
+
+QByteArray blockReply(quint32 index)
+{
+    const QByteArray payload = blockPayload(index);
+    char header[replyHeaderSize];
+    header[0] = replyTag;
+    qToBigEndian(index, header + 1);
+    qToBigEndian(quint16(blockSize), header + 5);
+    char checksum = 0;
+    for (const char c : payload)
+        checksum ^= c;
+
+    QByteArray reply(header, replyHeaderSize);
+    reply.append(payload);
+    reply.append(checksum);
+    return reply;
+}
+
+void silence(SimulatedSerialPort &port)
+{
+    SimulatedSerialPort::Profile profile;
+    profile.traffic = SimulatedSerialPort::Traffic::None;
+    port.setProfile(profile);
+    port.readData(64 * 1024, 0);
+    port.setBaudRate(921600);
+}
+
+} // namespace
+
+class tst_BulkTransfer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void reassemblesOutOfOrderReplies();
+    void resumesAfterDisconnect();
+    void failsOnMissingBlock();
+};
+
+void tst_BulkTransfer::reassemblesOutOfOrderReplies()
+{
+    static constexpr quint32 blockCount = 64;
+    static constexpr qsizetype batchSize = 4;
+
+    // The logger collects requests and answers each batch in reverse order
+    SimulatedSerialPort port;
+    silence(port);
+    QList<quint32> pending;
+    port.setResponder([&pending](const QByteArray &written) {
+        pending.append(requestedBlocks(written));
+        QByteArray reply;
+        while (pending.size() >= batchSize) {
+            std::reverse(pending.begin(), pending.begin() + batchSize);
+            for (qsizetype i = 0; i < batchSize; i++)
+                reply.append(blockReply(pending[i]));
+            pending.remove(0, batchSize);
+        }
+        return reply;
+    }, 2);
+
+    LoggerProtocol protocol;
+    BulkTransfer transfer(&protocol);
+    transfer.setWindowSize(8);
+
+    QByteArray downloaded;
+    QBuffer output(&downloaded);
+    QVERIFY(output.open(QIODevice::WriteOnly));
+
+    QCOMPARE(transfer.run(&port, &output, blockCount), BulkTransfer::Result::Completed);
+    QCOMPARE(downloaded, expectedOutput(blockCount));
+    QCOMPARE(transfer.nextBlock(), blockCount);
+    QCOMPARE(transfer.stats().corruptReplies, 0);
+}
+
+void tst_BulkTransfer::resumesAfterDisconnect()
+{
+    static constexpr quint32 blockCount = 64;
+    static constexpr quint32 disconnectAfter = 20;
+
+    // Pairs of requests are answered swapped, so blocks arrive ahead of
+    // the output when the cable is pulled
+    SimulatedSerialPort port;
+    silence(port);
+    QList<quint32> requested;
+    QList<quint32> pending;
+    port.setResponder([&](const QByteArray &written) {
+        const QList<quint32> indices = requestedBlocks(written);
+        requested.append(indices);
+        pending.append(indices);
+        QByteArray reply;
+        while (pending.size() >= 2) {
+            reply.append(blockReply(pending[1]));
+            reply.append(blockReply(pending[0]));
+            pending.remove(0, 2);
+        }
+        return reply;
+    }, 2);
+
+    LoggerProtocol protocol;
+    BulkTransfer transfer(&protocol);
+    transfer.setWindowSize(8);
+    transfer.setBlockTimeout(200);
+    const QMetaObject::Connection pullCable = connect(
+            &transfer, &BulkTransfer::progress, &transfer, [&port](quint32 blocksWritten) {
+                if (blocksWritten >= disconnectAfter)
+                    port.disconnect();
+            });
+
+    QByteArray downloaded;
+    QBuffer output(&downloaded);
+    QVERIFY(output.open(QIODevice::WriteOnly));
+
+    QCOMPARE(transfer.run(&port, &output, blockCount), BulkTransfer::Result::Disconnected);
+    const quint32 resumeAt = transfer.nextBlock();
+    QVERIFY(resumeAt >= disconnectAfter);
+    QVERIFY(resumeAt < blockCount);
+    QCOMPARE(downloaded, expectedOutput(resumeAt));
+
+    // Blocks already written are not fetched again after the reconnect
+    disconnect(pullCable);
+    port.reconnect();
+    requested.clear();
+    pending.clear();
+    QCOMPARE(transfer.run(&port, &output, blockCount), BulkTransfer::Result::Completed);
+    QCOMPARE(downloaded, expectedOutput(blockCount));
+    QVERIFY(!requested.isEmpty());
+    QVERIFY(*std::min_element(requested.cbegin(), requested.cend()) >= resumeAt);
+}
+
+void tst_BulkTransfer::failsOnMissingBlock()
+{
+    // Every block but one is answered. Running out of retries is a
+    // failure of the transfer, not a lost device.
+    static constexpr quint32 blockCount = 32;
+    static constexpr quint32 missingBlock = 5;
+
+    SimulatedSerialPort port;
+    silence(port);
+    int missingRequests = 0;
+    port.setResponder([&missingRequests](const QByteArray &written) {
+        QByteArray reply;
+        for (const quint32 index : requestedBlocks(written)) {
+            if (index == missingBlock)
+                missingRequests++;
+            else
+                reply.append(blockReply(index));
+        }
+        return reply;
+    }, 2);
+
+    LoggerProtocol protocol;
+    BulkTransfer transfer(&protocol);
+    transfer.setWindowSize(8);
+    transfer.setBlockTimeout(20);
+    transfer.setMaxRetries(3);
+
+    QByteArray downloaded;
+    QBuffer output(&downloaded);
+    QVERIFY(output.open(QIODevice::WriteOnly));
+
+    QCOMPARE(transfer.run(&port, &output, blockCount), BulkTransfer::Result::Failed);
+    QCOMPARE(missingRequests, transfer.maxRetries() + 1);
+    QCOMPARE(transfer.nextBlock(), missingBlock);
+    QCOMPARE(downloaded, expectedOutput(missingBlock));
+}
+
+QTEST_GUILESS_MAIN(tst_BulkTransfer)
+
+#include "tst_bulktransfer.moc"
@@ -0,0 +1,182 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtTest/QTest>
+
+#include "FtdiPackets.h"
+
+class tst_FtdiPackets : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void stripsFullSpeedPackets();
+    void shortLastPacket();
+    void noHeaderKeepsStatus();
+    void matchesReference_data();
+    void matchesReference();
+};
+
+namespace {
+
+constexpr int packetSize = 64;
+constexpr quint8 cts = 0x10;
+constexpr quint8 dsr = 0x20;
+constexpr quint8 overrun = 0x02;
+
+QByteArray packet(quint8 modemStatus, quint8 lineStatus, const QByteArray &payload)
+{
+    QByteArray data;
+    data.append(char(modemStatus));
+    data.append(char(lineStatus));
+    data.append(payload);
+    return data;
+}
+
+// Every byte depends on its position in the stream, so that a payload
+// moved to the wrong place does not compare equal. 251 is prime, so the
+// pattern does not repeat with the packet size.
+QByteArray payload(int offset, int length)
+{
+    QByteArray data(length, Qt::Uninitialized);
+    for (int i = 0; i < length; i++)
+        data[i] = char((offset + i) % 251);
+    return data;
+}
+
+// A transfer of packetCount full packets and a tail of tailLength bytes,
+// status headers included, with varying status bits
+QByteArray transfer(int packetSize, int packetCount, int tailLength)
+{
+    QByteArray data;
+    int offset = 0;
+    for (int i = 0; i <= packetCount; i++) {
+        const int length = i < packetCount ? packetSize : tailLength;
+        if (length == 0)
+            break;
+        data.append(char(0x10 << (i % 4)));
+        if (length > 1)
+            data.append(char((i * 2) & 0x1e));
+        if (length > 2) {
+            data.append(payload(offset, length - FtdiPackets::statusSize));
+            offset += length - FtdiPackets::statusSize;
+        }
+    }
+    return data;
+}
+
+// Packet by packet, without any of the fast paths
+QByteArray referenceStrip(const QByteArray &data, int packetSize, FtdiPackets::LineStatus &status)
+{
+    QByteArray result;
+    for (qsizetype packet = 0; packet < data.size(); packet += packetSize) {
+        const qsizetype length = qMin<qsizetype>(packetSize, data.size() - packet);
+        if (length < FtdiPackets::statusSize)
+            break;
+        const quint8 lineStatus = quint8(data[packet + 1]);
+        status.modemStatus = quint8(data[packet]);
+        status.packets++;
+        status.overruns += (lineStatus & 0x02) ? 1 : 0;
+        status.parityErrors += (lineStatus & 0x04) ? 1 : 0;
+        status.framingErrors += (lineStatus & 0x08) ? 1 : 0;
+        status.breaks += (lineStatus & 0x10) ? 1 : 0;
+        result.append(data.mid(packet + FtdiPackets::statusSize,
+                               length - FtdiPackets::statusSize));
+    }
+    return result;
+}
+
+} // namespace
+
+void tst_FtdiPackets::stripsFullSpeedPackets()
+{
+    const QByteArray first = payload(0, packetSize - FtdiPackets::statusSize);
+    const QByteArray second = payload(first.size(), packetSize - FtdiPackets::statusSize);
+    QByteArray data = packet(cts, 0, first) + packet(cts | dsr, overrun, second);
+
+    FtdiPackets::LineStatus status;
+    const qsizetype length = FtdiPackets::stripStatus(data.data(), data.size(), packetSize, status);
+    QCOMPARE(data.left(length), first + second);
+    QCOMPARE(status.packets, 2);
+    QCOMPARE(status.overruns, 1);
+    QCOMPARE(status.modemStatus, quint8(cts | dsr));
+}
+
+void tst_FtdiPackets::shortLastPacket()
+{
+    const QByteArray full = payload(0, packetSize - FtdiPackets::statusSize);
+    QByteArray data = packet(cts, 0, full) + packet(dsr, 0, "xyz");
+
+    FtdiPackets::LineStatus status;
+    const qsizetype length = FtdiPackets::stripStatus(data.data(), data.size(), packetSize, status);
+    QCOMPARE(data.left(length), full + "xyz");
+    QCOMPARE(status.packets, 2);
+    QCOMPARE(status.modemStatus, dsr);
+}
+
+void tst_FtdiPackets::noHeaderKeepsStatus()
+{
+    FtdiPackets::LineStatus status;
+    status.modemStatus = cts;
+
+    // A zero-length transfer, and one cut short within the header
+    QByteArray data(1, char(dsr));
+    QCOMPARE(FtdiPackets::stripStatus(data.data(), 0, packetSize, status), qsizetype(0));
+    QCOMPARE(FtdiPackets::stripStatus(data.data(), 1, packetSize, status), qsizetype(0));
+    QCOMPARE(status.packets, 0);
+    QCOMPARE(status.modemStatus, cts);
+
+    // A header without payload still reports the status
+    data = packet(dsr, 0, QByteArray());
+    QCOMPARE(FtdiPackets::stripStatus(data.data(), data.size(), packetSize, status), qsizetype(0));
+    QCOMPARE(status.packets, 1);
+    QCOMPARE(status.modemStatus, dsr);
+}
+
+void tst_FtdiPackets::matchesReference_data()
+{
+    QTest::addColumn<int>("packetSize");
+    QTest::addColumn<int>("packetCount");
+    QTest::addColumn<int>("tailLength");
+
+    // Full and high speed, and a size that takes neither fast path
+    for (const int packetSize : { 64, 512, 16 }) {
+        for (const int packetCount : { 0, 1, 2, 3, 7, 16 }) {
+            for (const int tailLength : { 0, 1, 2, 3, 17, packetSize - 1 }) {
+                if (tailLength >= packetSize)
+                    continue;
+                QTest::addRow("%d bytes, %d packets, tail %d", packetSize, packetCount, tailLength)
+                    << packetSize << packetCount << tailLength;
+            }
+        }
+    }
+    // A whole 16 KiB URB
+    QTest::addRow("64 bytes, 16 KiB") << 64 << 256 << 0;
+    QTest::addRow("512 bytes, 16 KiB") << 512 << 32 << 0;
+}
+
+void tst_FtdiPackets::matchesReference()
+{
+    QFETCH(int, packetSize);
+    QFETCH(int, packetCount);
+    QFETCH(int, tailLength);
+
+    QByteArray data = transfer(packetSize, packetCount, tailLength);
+
+    FtdiPackets::LineStatus expectedStatus;
+    const QByteArray expected = referenceStrip(data, packetSize, expectedStatus);
+
+    FtdiPackets::LineStatus status;
+    const qsizetype length = FtdiPackets::stripStatus(data.data(), data.size(), packetSize, status);
+    QCOMPARE(data.left(length), expected);
+    QCOMPARE(status.packets, expectedStatus.packets);
+    QCOMPARE(status.overruns, expectedStatus.overruns);
+    QCOMPARE(status.parityErrors, expectedStatus.parityErrors);
+    QCOMPARE(status.framingErrors, expectedStatus.framingErrors);
+    QCOMPARE(status.breaks, expectedStatus.breaks);
+    QCOMPARE(status.modemStatus, expectedStatus.modemStatus);
+}
+
+QTEST_GUILESS_MAIN(tst_FtdiPackets)
+
+#include "tst_ftdipackets.moc"
@@ -0,0 +1,426 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtCore/QList>
+#include <QtCore/QSet>
+#include <QtTest/QTest>
+
+#include <cstdarg>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "AllocationTracker.h"
+#include "JavaPortIo.h"
+
+namespace {
+
+// A JNIEnv whose function table counts every call, hands out byte arrays
+// and local and global references it keeps track of, and answers the
+// port's read() and write() from a script. Functions the transfers are not
+// expected to use stay null, so calling one crashes the test. What the
+// fake allocates stands in for the JVM's heap and is charged to jvmStage,
+// which the transfers do not use, so that their own stage only counts
+// what JavaPortIo allocates.
+class FakeJni
+{
+public:
+    struct Step {
+        QByteArray data;    // what read() returns, unused by write()
+        bool throws = false;
+    };
+
+    static constexpr AllocationTracker::Stage jvmStage = AllocationTracker::Stage::Publish;
+
+    FakeJni()
+    {
+        m_table.ExceptionCheck = &exceptionCheck;
+        m_table.ExceptionDescribe = &exceptionDescribe;
+        m_table.ExceptionClear = &exceptionClear;
+        m_table.NewLocalRef = &newLocalRef;
+        m_table.DeleteLocalRef = &deleteLocalRef;
+        m_table.NewGlobalRef = &newGlobalRef;
+        m_table.DeleteGlobalRef = &deleteGlobalRef;
+        m_table.NewByteArray = &newByteArray;
+        m_table.GetArrayLength = &getArrayLength;
+        m_table.GetByteArrayRegion = &getByteArrayRegion;
+        m_table.SetByteArrayRegion = &setByteArrayRegion;
+        m_table.CallIntMethodV = &callIntMethodV;
+        m_table.CallVoidMethodV = &callVoidMethodV;
+        m_env.functions = &m_table;
+        s_current = this;
+    }
+    ~FakeJni() { s_current = nullptr; }
+
+    JNIEnv *env() { return &m_env; }
+    jobject port() { return &m_port; }
+    jmethodID readMethod() const { return reinterpret_cast<jmethodID>(quintptr(1)); }
+    jmethodID writeMethod() const { return reinterpret_cast<jmethodID>(quintptr(2)); }
+
+    void script(const Step &step) { m_script.append(step); }
+
+    // Counted since the last reset()
+    int calls = 0;
+    int arraysAllocated = 0;
+    qint64 arrayBytesAllocated = 0;
+    int localRefsCreated = 0;
+    int globalRefsCreated = 0;
+    int exceptionsDescribed = 0;
+    // Calls other than the ones JNI allows while an exception is pending
+    int callsWithPendingException = 0;
+    int lastTimeoutMs = -1;
+    QList<QByteArray> written;
+
+    void reset()
+    {
+        calls = arraysAllocated = localRefsCreated = globalRefsCreated = 0;
+        exceptionsDescribed = callsWithPendingException = 0;
+        arrayBytesAllocated = 0;
+        lastTimeoutMs = -1;
+        written.clear();
+    }
+
+    qsizetype liveLocalRefs() const { return m_localRefs.size(); }
+    qsizetype liveGlobalRefs() const { return m_globalRefs.size(); }
+    bool exceptionPending() const { return m_exceptionPending; }
+
+private:
+    struct Array : _jbyteArray {
+        QByteArray bytes;
+    };
+
+    static FakeJni &self() { return *s_current; }
+
+    static FakeJni &call(bool allowedWithException = false)
+    {
+        FakeJni &jni = self();
+        ++jni.calls;
+        if (jni.m_exceptionPending && !allowedWithException)
+            ++jni.callsWithPendingException;
+        return jni;
+    }
+
+    Step nextStep()
+    {
+        if (m_script.isEmpty()) {
+            qWarning("FakeJni: the script ran out");
+            return Step();
+        }
+        return m_script.takeFirst();
+    }
+
+    static jboolean exceptionCheck(JNIEnv *)
+    {
+        return call(true).m_exceptionPending ? JNI_TRUE : JNI_FALSE;
+    }
+    static void exceptionDescribe(JNIEnv *) { ++call(true).exceptionsDescribed; }
+    static void exceptionClear(JNIEnv *) { call(true).m_exceptionPending = false; }
+
+    static jobject newLocalRef(JNIEnv *, jobject object)
+    {
+        FakeJni &jni = call();
+        AllocationTracker::Scope jvm(jvmStage);
+        ++jni.localRefsCreated;
+        jni.m_localRefs.insert(object);
+        return object;
+    }
+    static void deleteLocalRef(JNIEnv *, jobject object)
+    {
+        FakeJni &jni = call(true);
+        if (!jni.m_localRefs.remove(object))
+            qWarning("FakeJni: deleting an unknown local reference");
+    }
+    static jobject newGlobalRef(JNIEnv *, jobject object)
+    {
+        FakeJni &jni = call();
+        AllocationTracker::Scope jvm(jvmStage);
+        ++jni.globalRefsCreated;
+        jni.m_globalRefs.insert(object);
+        return object;
+    }
+    static void deleteGlobalRef(JNIEnv *, jobject object)
+    {
+        FakeJni &jni = call(true);
+        if (!jni.m_globalRefs.remove(object))
+            qWarning("FakeJni: deleting an unknown global reference");
+    }
+
+    static jbyteArray newByteArray(JNIEnv *, jsize length)
+    {
+        FakeJni &jni = call();
+        AllocationTracker::Scope jvm(jvmStage);
+        auto array = std::make_unique<Array>();
+        array->bytes = QByteArray(length, '\0');
+        ++jni.arraysAllocated;
+        jni.arrayBytesAllocated += length;
+        ++jni.localRefsCreated;
+        jni.m_localRefs.insert(array.get());
+        jni.m_arrays.push_back(std::move(array));
+        return jni.m_arrays.back().get();
+    }
+    static jsize getArrayLength(JNIEnv *, jarray array)
+    {
+        call();
+        return jsize(static_cast<Array *>(array)->bytes.size());
+    }
+    static void getByteArrayRegion(JNIEnv *, jbyteArray array, jsize start, jsize length,
+                                   jbyte *buffer)
+    {
+        call();
+        memcpy(buffer, static_cast<Array *>(array)->bytes.constData() + start, length);
+    }
+    static void setByteArrayRegion(JNIEnv *, jbyteArray array, jsize start, jsize length,
+                                   const jbyte *buffer)
+    {
+        call();
+        memcpy(static_cast<Array *>(array)->bytes.data() + start, buffer, length);
+    }
+
+    // UsbSerialPort.read(byte[] dest, int timeout)
+    static jint callIntMethodV(JNIEnv *, jobject, jmethodID method, va_list args)
+    {
+        FakeJni &jni = call();
+        AllocationTracker::Scope jvm(jvmStage);
+        auto *array = static_cast<Array *>(va_arg(args, jbyteArray));
+        jni.lastTimeoutMs = va_arg(args, jint);
+        if (method != jni.readMethod())
+            qFatal("FakeJni: unexpected int method");
+
+        const Step step = jni.nextStep();
+        if (step.throws) {
+            jni.m_exceptionPending = true;
+            return 0;
+        }
+        const qsizetype length = qMin(step.data.size(), array->bytes.size());
+        memcpy(array->bytes.data(), step.data.constData(), length);
+        return jint(length);
+    }
+
+    // UsbSerialPort.write(byte[] src, int timeout)
+    static void callVoidMethodV(JNIEnv *, jobject, jmethodID method, va_list args)
+    {
+        FakeJni &jni = call();
+        AllocationTracker::Scope jvm(jvmStage);
+        auto *array = static_cast<Array *>(va_arg(args, jbyteArray));
+        jni.lastTimeoutMs = va_arg(args, jint);
+        if (method != jni.writeMethod())
+            qFatal("FakeJni: unexpected void method");
+
+        jni.written.append(array->bytes);
+        if (jni.nextStep().throws)
+            jni.m_exceptionPending = true;
+    }
+
+    static inline FakeJni *s_current = nullptr;
+
+    JNINativeInterface_ m_table {};
+    JNIEnv m_env {};
+    _jobject m_port;
+    QList<Step> m_script;
+    std::vector<std::unique_ptr<Array>> m_arrays;
+    QSet<jobject> m_localRefs;
+    QSet<jobject> m_globalRefs;
+    bool m_exceptionPending = false;
+};
+
+// C++ heap allocations of a read that moved data: the QByteArray it
+// returns. Writes and reads that return nothing allocate nothing.
+constexpr qint64 readAllocationBudget = 1;
+
+// JNI calls of a transfer that moved data: the byte array, the port call,
+// the exception check, the copy and the deletion of the array. Every
+// transfer allocates exactly one Java array and no global reference.
+constexpr int transferCallBudget = 5;
+
+} // namespace
+
+class tst_JavaPortIo : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void readCopiesData();
+    void readTimeout();
+    void readException();
+    void writeSendsData();
+    void writeException();
+    void steadyState();
+    void heapAllocationsPerTransfer();
+};
+
+void tst_JavaPortIo::readCopiesData()
+{
+    FakeJni jni;
+    jni.script({ "hello" });
+
+    bool failed = true;
+    const QByteArray data = JavaPortIo::read(jni.env(), jni.port(), jni.readMethod(), 16, 200,
+                                             failed);
+    QCOMPARE(data, QByteArray("hello"));
+    QVERIFY(!failed);
+    QCOMPARE(jni.lastTimeoutMs, 200);
+
+    QCOMPARE(jni.calls, transferCallBudget);
+    QCOMPARE(jni.arraysAllocated, 1);
+    QCOMPARE(jni.arrayBytesAllocated, qint64(16));
+    QCOMPARE(jni.localRefsCreated, 1);
+    QCOMPARE(jni.liveLocalRefs(), qsizetype(0));
+    QCOMPARE(jni.globalRefsCreated, 0);
+    QCOMPARE(jni.callsWithPendingException, 0);
+}
+
+void tst_JavaPortIo::readTimeout()
+{
+    FakeJni jni;
+    jni.script({ QByteArray() });
+
+    bool failed = true;
+    const QByteArray data = JavaPortIo::read(jni.env(), jni.port(), jni.readMethod(), 16, 200,
+                                             failed);
+    QVERIFY(data.isEmpty());
+    QVERIFY(!failed);
+
+    // Nothing to copy
+    QCOMPARE(jni.calls, transferCallBudget - 1);
+    QCOMPARE(jni.liveLocalRefs(), qsizetype(0));
+}
+
+void tst_JavaPortIo::readException()
+{
+    FakeJni jni;
+    jni.script({ QByteArray(), true });
+
+    bool failed = false;
+    const QByteArray data = JavaPortIo::read(jni.env(), jni.port(), jni.readMethod(), 16, 200,
+                                             failed);
+    QVERIFY(data.isEmpty());
+    QVERIFY(failed);
+    QVERIFY(!jni.exceptionPending());
+    QCOMPARE(jni.exceptionsDescribed, 1);
+
+    // No copy, but the exception is logged and cleared
+    QCOMPARE(jni.calls, transferCallBudget + 1);
+    QCOMPARE(jni.liveLocalRefs(), qsizetype(0));
+    QCOMPARE(jni.callsWithPendingException, 0);
+}
+
+void tst_JavaPortIo::writeSendsData()
+{
+    FakeJni jni;
+    jni.script({ "hello" });
+
+    QVERIFY(JavaPortIo::write(jni.env(), jni.port(), jni.writeMethod(), "hello", 300));
+    QCOMPARE(jni.written, QList<QByteArray>({ "hello" }));
+    QCOMPARE(jni.lastTimeoutMs, 300);
+
+    QCOMPARE(jni.calls, transferCallBudget);
+    QCOMPARE(jni.arraysAllocated, 1);
+    QCOMPARE(jni.arrayBytesAllocated, qint64(5));
+    QCOMPARE(jni.liveLocalRefs(), qsizetype(0));
+    QCOMPARE(jni.globalRefsCreated, 0);
+    QCOMPARE(jni.callsWithPendingException, 0);
+}
+
+void tst_JavaPortIo::writeException()
+{
+    FakeJni jni;
+    jni.script({ "hello", true });
+
+    QVERIFY(!JavaPortIo::write(jni.env(), jni.port(), jni.writeMethod(), "hello", 300));
+    QVERIFY(!jni.exceptionPending());
+    QCOMPARE(jni.calls, transferCallBudget + 2);
+    QCOMPARE(jni.liveLocalRefs(), qsizetype(0));
+    // Only deleting the array happens while the exception is pending
+    QCOMPARE(jni.callsWithPendingException, 0);
+}
+
+// The cost of a transfer does not grow with the number of transfers
+void tst_JavaPortIo::steadyState()
+{
+    constexpr int transfers = 100;
+    const QByteArray payload(64, 'x');
+
+    FakeJni jni;
+    for (int i = 0; i < transfers; ++i)
+        jni.script({ payload });
+
+    bool failed = false;
+    for (int i = 0; i < transfers; ++i) {
+        jni.reset();
+        QCOMPARE(JavaPortIo::read(jni.env(), jni.port(), jni.readMethod(), 1024, 50, failed),
+                 payload);
+        QCOMPARE(jni.calls, transferCallBudget);
+        QCOMPARE(jni.arraysAllocated, 1);
+        QCOMPARE(jni.liveLocalRefs(), qsizetype(0));
+    }
+
+    for (int i = 0; i < transfers; ++i)
+        jni.script({ payload });
+    for (int i = 0; i < transfers; ++i) {
+        jni.reset();
+        QVERIFY(JavaPortIo::write(jni.env(), jni.port(), jni.writeMethod(), payload, 50));
+        QCOMPARE(jni.calls, transferCallBudget);
+        QCOMPARE(jni.arraysAllocated, 1);
+        QCOMPARE(jni.liveLocalRefs(), qsizetype(0));
+    }
+    QCOMPARE(jni.liveGlobalRefs(), qsizetype(0));
+}
+
+// Every read and write, in the steady state, stays within the allocation
+// budget, charged to the stage UsbSerialHelper uses for it
+void tst_JavaPortIo::heapAllocationsPerTransfer()
+{
+    if (!AllocationTracker::isComplete())
+        QSKIP("Qt's containers are not counted on this platform");
+
+    constexpr int transfers = 100;
+    const QByteArray payload(512, 'x');
+
+    FakeJni jni;
+    for (int i = 0; i < transfers; ++i)
+        jni.script({ payload });
+    jni.script({ QByteArray() });
+    for (int i = 0; i < transfers; ++i)
+        jni.script({ payload });
+
+    AllocationTracker::reset();
+    bool failed = false;
+    qsizetype bytesRead = 0;
+    for (int i = 0; i < transfers; ++i) {
+        AllocationTracker::Scope scope(AllocationTracker::Stage::Read);
+        bytesRead += JavaPortIo::read(jni.env(), jni.port(), jni.readMethod(), 1024, 50,
+                                      failed).size();
+    }
+    QCOMPARE(bytesRead, qsizetype(transfers) * payload.size());
+
+    AllocationTracker::Stats read = AllocationTracker::stats(AllocationTracker::Stage::Read);
+    QCOMPARE(read.scopes, qint64(transfers));
+    QCOMPARE(read.allocations, transfers * readAllocationBudget);
+    QCOMPARE(read.maxAllocationsPerScope, readAllocationBudget);
+    // The fake did allocate, but not on the transfers' account
+    QVERIFY(AllocationTracker::stats(FakeJni::jvmStage).allocations > 0);
+
+    AllocationTracker::reset();
+    {
+        AllocationTracker::Scope scope(AllocationTracker::Stage::Read);
+        QVERIFY(JavaPortIo::read(jni.env(), jni.port(), jni.readMethod(), 1024, 50,
+                                 failed).isEmpty());
+    }
+    read = AllocationTracker::stats(AllocationTracker::Stage::Read);
+    QCOMPARE(read.allocations, qint64(0));
+
+    AllocationTracker::reset();
+    int written = 0;
+    for (int i = 0; i < transfers; ++i) {
+        AllocationTracker::Scope scope(AllocationTracker::Stage::Write);
+        written += JavaPortIo::write(jni.env(), jni.port(), jni.writeMethod(), payload, 50);
+    }
+    QCOMPARE(written, transfers);
+
+    const AllocationTracker::Stats write = AllocationTracker::stats(AllocationTracker::Stage::Write);
+    QCOMPARE(write.scopes, qint64(transfers));
+    QCOMPARE(write.allocations, qint64(0));
+}
+
+QTEST_GUILESS_MAIN(tst_JavaPortIo)
+#include "tst_javaportio.moc"
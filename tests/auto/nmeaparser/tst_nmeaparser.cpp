@@ -0,0 +1,129 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtTest/QTest>
+
+#include "NmeaParser.h"
+
+class tst_NmeaParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void completeSentences();
+    void splitSentence_data();
+    void splitSentence();
+    void badChecksum();
+    void missingChecksum();
+    void overlongLine();
+    void startCharacterRestarts();
+
+private:
+    static QByteArray sentence(const QByteArray &body);
+};
+
+// "$<body>*<checksum>", as a receiver sends it, without the line ending
+QByteArray tst_NmeaParser::sentence(const QByteArray &body)
+{
+    quint8 checksum = 0;
+    for (const char c : body)
+        checksum ^= quint8(c);
+    return '$' + body + '*' + QByteArray::number(checksum, 16).rightJustified(2, '0').toUpper();
+}
+
+void tst_NmeaParser::completeSentences()
+{
+    const QByteArray rmc = sentence("GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W");
+    const QByteArray flaa = sentence("PFLAA,0,-1234,1234,220,2,DD8F12,180,,30,-1.4,1");
+
+    NmeaParser parser;
+    QList<SerialFrame> frames;
+    QCOMPARE(parser.parse(rmc + "\r\n" + flaa + "\r\n", 7, frames), 0);
+    QCOMPARE(frames.size(), 2);
+    QCOMPARE(frames[0].data, rmc);
+    QCOMPARE(frames[0].receivedNs, qint64(7));
+    QCOMPARE(frames[1].data, flaa);
+}
+
+void tst_NmeaParser::splitSentence_data()
+{
+    QTest::addColumn<int>("splitAt");
+
+    // Up to the line ending, which completes the sentence
+    const QByteArray expected = sentence("GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,");
+    for (int i = 1; i <= expected.size(); i++)
+        QTest::addRow("%d", i) << i;
+}
+
+// A sentence arrives in two reads; the frame carries the time of the first
+void tst_NmeaParser::splitSentence()
+{
+    QFETCH(int, splitAt);
+
+    const QByteArray expected = sentence("GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,");
+    const QByteArray line = expected + "\r\n";
+
+    NmeaParser parser;
+    QList<SerialFrame> frames;
+    QCOMPARE(parser.parse(line.left(splitAt), 100, frames), 0);
+    QVERIFY(frames.isEmpty());
+    QCOMPARE(parser.parse(line.mid(splitAt), 200, frames), 0);
+    QCOMPARE(frames.size(), 1);
+    QCOMPARE(frames[0].data, expected);
+    QCOMPARE(frames[0].receivedNs, qint64(100));
+}
+
+void tst_NmeaParser::badChecksum()
+{
+    QByteArray corrupted = sentence("GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W");
+    corrupted[10] = '9';
+    const QByteArray good = sentence("GPVTG,054.7,T,034.4,M,005.5,N,010.2,K");
+
+    NmeaParser parser;
+    QList<SerialFrame> frames;
+    QCOMPARE(parser.parse(corrupted + "\r\n" + good + "\r\n", 0, frames), 1);
+    QCOMPARE(frames.size(), 1);
+    QCOMPARE(frames[0].data, good);
+
+    // A checksum field that is not two hex digits
+    QCOMPARE(parser.parse("$GPVTG,054.7,T*4\r\n$GPVTG,054.7,T*ZZ\r\n", 0, frames), 2);
+    QCOMPARE(frames.size(), 1);
+}
+
+void tst_NmeaParser::missingChecksum()
+{
+    NmeaParser parser;
+    QList<SerialFrame> frames;
+    QCOMPARE(parser.parse("$GPVTG,054.7,T,034.4,M\n", 0, frames), 0);
+    QCOMPARE(frames.size(), 1);
+    QCOMPARE(frames[0].data, QByteArray("$GPVTG,054.7,T,034.4,M"));
+}
+
+// A line without an end is dropped as an error, and the parser recovers
+// with the next start character
+void tst_NmeaParser::overlongLine()
+{
+    const QByteArray good = sentence("GPVTG,054.7,T,034.4,M,005.5,N,010.2,K");
+
+    NmeaParser parser;
+    QList<SerialFrame> frames;
+    QCOMPARE(parser.parse('$' + QByteArray(300, 'A') + "\r\n", 0, frames), 1);
+    QVERIFY(frames.isEmpty());
+    QCOMPARE(parser.parse(good + "\r\n", 0, frames), 0);
+    QCOMPARE(frames.size(), 1);
+    QCOMPARE(frames[0].data, good);
+}
+
+void tst_NmeaParser::startCharacterRestarts()
+{
+    const QByteArray good = sentence("PFLAU,3,1,2,1,0,,0,,");
+
+    NmeaParser parser;
+    QList<SerialFrame> frames;
+    QCOMPARE(parser.parse("garbage$GPRMC,1235" + good + "\r\n", 0, frames), 0);
+    QCOMPARE(frames.size(), 1);
+    QCOMPARE(frames[0].data, good);
+}
+
+QTEST_GUILESS_MAIN(tst_NmeaParser)
+#include "tst_nmeaparser.moc"
@@ -0,0 +1,174 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtTest/QTest>
+
+#include "NotificationDispatcher.h"
+
+namespace {
+
+// Records what the dispatcher posts and when
+struct Recorder
+{
+    NotificationDispatcher::Poster poster()
+    {
+        clock.start();
+        return [this](const NotificationDispatcher::Notification &notification) {
+            posted.append(notification);
+            postedAtMs.append(clock.elapsed());
+        };
+    }
+
+    QList<NotificationDispatcher::Notification> posted;
+    QList<qint64> postedAtMs;
+    QElapsedTimer clock;
+};
+
+} // namespace
+
+class tst_NotificationDispatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void firstAlertPostsAtOnce();
+    void coalescesBurst();
+    void rateLimitsPerChannel();
+    void resetCountsFromZero();
+    void resetKeepsHeldBackAlerts();
+    void dismissedRepostsSameAlert();
+    void dismissedIgnoresUnknownId();
+};
+
+void tst_NotificationDispatcher::firstAlertPostsAtOnce()
+{
+    Recorder recorder;
+    NotificationDispatcher dispatcher(recorder.poster());
+
+    dispatcher.post("gps", "GPS", "No fix");
+    QCOMPARE(recorder.posted.size(), 1);
+    QCOMPARE(recorder.posted[0].title, QStringLiteral("GPS"));
+    QCOMPARE(recorder.posted[0].text, QStringLiteral("No fix"));
+    QCOMPARE(recorder.posted[0].count, 1);
+    QVERIFY(recorder.posted[0].id > 0);
+}
+
+// Alerts within the rate limit end up in one update with their number and
+// the latest text
+void tst_NotificationDispatcher::coalescesBurst()
+{
+    Recorder recorder;
+    NotificationDispatcher dispatcher(recorder.poster());
+    dispatcher.setRateLimit("gps", 200);
+
+    dispatcher.post("gps", "GPS", "No fix");
+    for (int i = 0; i < 5; i++)
+        dispatcher.post("gps", "GPS", QStringLiteral("Satellites: %1").arg(i));
+    QCOMPARE(recorder.posted.size(), 1);
+
+    QTRY_COMPARE(recorder.posted.size(), 2);
+    QCOMPARE(recorder.posted[1].count, 6);
+    QCOMPARE(recorder.posted[1].text, QStringLiteral("Satellites: 4"));
+    QCOMPARE(recorder.posted[1].id, recorder.posted[0].id);
+    QVERIFY(recorder.postedAtMs[1] - recorder.postedAtMs[0] >= 200);
+
+    const NotificationDispatcher::Stats stats = dispatcher.stats();
+    QCOMPARE(stats.alerts, quint64(6));
+    QCOMPARE(stats.posted, quint64(2));
+
+    // Nothing else arrived, so nothing else is posted
+    QTest::qWait(300);
+    QCOMPARE(recorder.posted.size(), 2);
+}
+
+// A busy channel does not hold back another one
+void tst_NotificationDispatcher::rateLimitsPerChannel()
+{
+    Recorder recorder;
+    NotificationDispatcher dispatcher(recorder.poster());
+    dispatcher.setDefaultRateLimit(10000);
+    dispatcher.setRateLimit("battery", 0);
+
+    dispatcher.post("gps", "GPS", "No fix");
+    dispatcher.post("gps", "GPS", "Still no fix");
+    dispatcher.post("battery", "Battery", "Low");
+    dispatcher.post("battery", "Battery", "Critical");
+
+    QCOMPARE(recorder.posted.size(), 3);
+    QCOMPARE(recorder.posted[0].text, QStringLiteral("No fix"));
+    QCOMPARE(recorder.posted[1].text, QStringLiteral("Low"));
+    QCOMPARE(recorder.posted[2].text, QStringLiteral("Critical"));
+    QCOMPARE(recorder.posted[2].count, 2);
+    QVERIFY(recorder.posted[0].id != recorder.posted[1].id);
+}
+
+void tst_NotificationDispatcher::resetCountsFromZero()
+{
+    Recorder recorder;
+    NotificationDispatcher dispatcher(recorder.poster());
+    dispatcher.setRateLimit("gps", 0);
+
+    for (int i = 0; i < 3; i++)
+        dispatcher.post("gps", "GPS", "No fix");
+    QCOMPARE(recorder.posted.last().count, 3);
+
+    dispatcher.reset("gps");
+    dispatcher.post("gps", "GPS", "Fix lost");
+    QCOMPARE(recorder.posted.size(), 4);
+    QCOMPARE(recorder.posted.last().count, 1);
+}
+
+// Alerts the user has not seen yet survive the reset and are still posted
+void tst_NotificationDispatcher::resetKeepsHeldBackAlerts()
+{
+    Recorder recorder;
+    NotificationDispatcher dispatcher(recorder.poster());
+    dispatcher.setRateLimit("gps", 200);
+
+    dispatcher.post("gps", "GPS", "No fix");
+    dispatcher.post("gps", "GPS", "Fix lost");
+    dispatcher.post("gps", "GPS", "Fix lost again");
+    QCOMPARE(recorder.posted.size(), 1);
+
+    dispatcher.reset("gps");
+    QTRY_COMPARE(recorder.posted.size(), 2);
+    QCOMPARE(recorder.posted[1].count, 2);
+    QCOMPARE(recorder.posted[1].text, QStringLiteral("Fix lost again"));
+}
+
+// After a dismissal, the same alert is shown again rather than taken for
+// an unchanged update of the dismissed notification
+void tst_NotificationDispatcher::dismissedRepostsSameAlert()
+{
+    Recorder recorder;
+    NotificationDispatcher dispatcher(recorder.poster());
+    dispatcher.setRateLimit("gps", 0);
+
+    dispatcher.post("gps", "GPS", "No fix");
+    QCOMPARE(recorder.posted.size(), 1);
+
+    dispatcher.dismissed(recorder.posted[0].id);
+    dispatcher.post("gps", "GPS", "No fix");
+    QCOMPARE(recorder.posted.size(), 2);
+    QCOMPARE(recorder.posted[1].count, 1);
+    QCOMPARE(recorder.posted[1].text, QStringLiteral("No fix"));
+    QCOMPARE(dispatcher.stats().unchanged, quint64(0));
+}
+
+void tst_NotificationDispatcher::dismissedIgnoresUnknownId()
+{
+    Recorder recorder;
+    NotificationDispatcher dispatcher(recorder.poster());
+    dispatcher.setRateLimit("gps", 0);
+
+    dispatcher.post("gps", "GPS", "No fix");
+    dispatcher.dismissed(recorder.posted[0].id + 1);
+    dispatcher.post("gps", "GPS", "No fix");
+    QCOMPARE(recorder.posted.last().count, 2);
+}
+
+QTEST_GUILESS_MAIN(tst_NotificationDispatcher)
+
+#include "tst_notificationdispatcher.moc"
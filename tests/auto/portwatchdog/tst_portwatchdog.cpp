@@ -0,0 +1,187 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <atomic>
+
+#include "PortWatchdog.h"
+#include "SerialSession.h"
+#include "SimulatedSerialPort.h"
+
+namespace {
+
+// An adapter that can purge its buffers, like most FTDI and CP210x chips
+class PurgeablePort : public SimulatedSerialPort
+{
+public:
+    bool purgeBuffers(bool purgeReadBuffers, bool purgeWriteBuffers) override
+    {
+        Q_UNUSED(purgeReadBuffers);
+        Q_UNUSED(purgeWriteBuffers);
+        purges++;
+        return purgeSupported;
+    }
+
+    std::atomic<int> purges { 0 };
+    bool purgeSupported = true;
+};
+
+class SimulatedDevice : public SerialSession::Device
+{
+public:
+    SimulatedDevice()
+    {
+        SimulatedSerialPort::Profile profile;
+        profile.rateHz = 50;
+        simulation.setProfile(profile);
+    }
+
+    bool open() override
+    {
+        opens++;
+        return simulation.isOpen();
+    }
+
+    void close() override { }
+    AbstractSerialPort *port() override { return &simulation; }
+    QString name() const override { return QStringLiteral("simulated"); }
+
+    PurgeablePort simulation;
+    std::atomic<int> opens { 0 };
+};
+
+} // namespace
+
+class tst_PortWatchdog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void errorBurstPurges();
+    void spreadErrorsAreNoBurst();
+    void stallPurgesThenReopens();
+    void stallReopensWithoutPurge();
+    void healthScoreFollowsErrors();
+};
+
+void tst_PortWatchdog::errorBurstPurges()
+{
+    SimulatedDevice device;
+    SerialSession session(&device);
+    QVERIFY(session.open());
+
+    PortWatchdog watchdog(&session);
+    watchdog.setErrorBurst(5, 1000);
+    QSignalSpy bursts(&watchdog, &PortWatchdog::errorBurstDetected);
+
+    watchdog.reportFrames(20, 0);
+    watchdog.reportFrames(10, 3);
+    QCOMPARE(bursts.size(), 0);
+    watchdog.reportFrames(10, 2);
+    QCOMPARE(bursts.size(), 1);
+    QCOMPARE(bursts.first().first().toInt(), 5);
+    QCOMPARE(device.simulation.purges.load(), 1);
+
+    // The burst is consumed; the next one needs five new errors
+    watchdog.reportFrames(10, 4);
+    QCOMPARE(bursts.size(), 1);
+}
+
+void tst_PortWatchdog::spreadErrorsAreNoBurst()
+{
+    SimulatedDevice device;
+    SerialSession session(&device);
+    QVERIFY(session.open());
+
+    PortWatchdog watchdog(&session);
+    watchdog.setErrorBurst(3, 50);
+    QSignalSpy bursts(&watchdog, &PortWatchdog::errorBurstDetected);
+
+    for (int i = 0; i < 5; i++) {
+        watchdog.reportFrames(10, 1);
+        QTest::qWait(40);
+    }
+    QCOMPARE(bursts.size(), 0);
+    QCOMPARE(device.simulation.purges.load(), 0);
+}
+
+void tst_PortWatchdog::stallPurgesThenReopens()
+{
+    SimulatedDevice device;
+    SerialSession session(&device);
+    session.setInitialBackoff(10);
+    QVERIFY(session.open());
+
+    PortWatchdog watchdog(&session);
+    watchdog.setSampleInterval(20);
+    watchdog.setStallTimeout(100);
+    QSignalSpy stalls(&watchdog, &PortWatchdog::stallDetected);
+    QSignalSpy reconnects(&session, &SerialSession::reconnected);
+    QTRY_VERIFY(session.bytesReceived() > 0);
+    QTest::qWait(60);
+    QVERIFY(!watchdog.isStalled());
+
+    // Open, but silent: the first step is a purge ...
+    device.simulation.dropout(60 * 1000);
+    QTRY_VERIFY(watchdog.isStalled());
+    QCOMPARE(stalls.size(), 1);
+    QCOMPARE(device.simulation.purges.load(), 1);
+    QCOMPARE(reconnects.size(), 0);
+
+    // ... and if the line stays silent for another stall timeout, a reopen
+    QTRY_COMPARE(reconnects.size(), 1);
+    QCOMPARE(device.simulation.purges.load(), 1);
+    QCOMPARE(device.opens.load(), 2);
+
+    // Data again clears the stall
+    device.simulation.dropout(0);
+    QTRY_VERIFY(!watchdog.isStalled());
+}
+
+void tst_PortWatchdog::stallReopensWithoutPurge()
+{
+    SimulatedDevice device;
+    device.simulation.purgeSupported = false;
+    SerialSession session(&device);
+    session.setInitialBackoff(10);
+    QVERIFY(session.open());
+
+    PortWatchdog watchdog(&session);
+    watchdog.setSampleInterval(20);
+    watchdog.setStallTimeout(100);
+    QSignalSpy reconnects(&session, &SerialSession::reconnected);
+    QTRY_VERIFY(session.bytesReceived() > 0);
+
+    // A chip without a purge command goes straight to the reopen
+    device.simulation.dropout(60 * 1000);
+    QTRY_VERIFY(watchdog.isStalled());
+    QTRY_COMPARE(reconnects.size(), 1);
+    QCOMPARE(device.simulation.purges.load(), 1);
+}
+
+void tst_PortWatchdog::healthScoreFollowsErrors()
+{
+    SimulatedDevice device;
+    SerialSession session(&device);
+    QVERIFY(session.open());
+
+    PortWatchdog watchdog(&session);
+    watchdog.setSampleInterval(20);
+    watchdog.setErrorBurst(1000000, 1000);
+    QTRY_VERIFY(session.bytesReceived() > 0);
+    QCOMPARE(watchdog.healthScore(), 100);
+
+    // Half of the frames bad in every sample pulls the score towards 50
+    for (int i = 0; i < 100; i++) {
+        watchdog.reportFrames(10, 10);
+        QTest::qWait(5);
+    }
+    QVERIFY(watchdog.healthScore() < 70);
+    QVERIFY(watchdog.healthScore() >= 40);
+}
+
+QTEST_GUILESS_MAIN(tst_PortWatchdog)
+
+#include "tst_portwatchdog.moc"
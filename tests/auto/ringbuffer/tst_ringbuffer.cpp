@@ -0,0 +1,202 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMutex>
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QThread>
+#include <QtTest/QTest>
+
+#include <memory>
+
+#include "RingBuffer.h"
+
+namespace {
+
+// Position-dependent bytes, so that data read from the wrong place or
+// in the wrong order does not compare equal
+QByteArray stream(qsizetype offset, qsizetype length)
+{
+    QByteArray data(length, Qt::Uninitialized);
+    for (qsizetype i = 0; i < length; i++)
+        data[i] = char((offset + i) % 251);
+    return data;
+}
+
+} // namespace
+
+class tst_RingBuffer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundsCapacityUp();
+    void wrapsAround();
+    void fullBufferTakesPrefix();
+    void accountsDroppedBytes();
+    void clearResets();
+    void twoThreadStress();
+};
+
+void tst_RingBuffer::roundsCapacityUp()
+{
+    QCOMPARE(RingBuffer(1).capacity(), qsizetype(1));
+    QCOMPARE(RingBuffer(100).capacity(), qsizetype(128));
+    QCOMPARE(RingBuffer(4096).capacity(), qsizetype(4096));
+}
+
+// Reads and writes that straddle the end of the storage, many times over
+void tst_RingBuffer::wrapsAround()
+{
+    RingBuffer buffer(16);
+    qsizetype written = 0;
+    qsizetype read = 0;
+    for (int round = 0; round < 100; round++) {
+        const qsizetype length = 1 + round % 13;
+        const QByteArray in = stream(written, length);
+        QCOMPARE(buffer.write(in.constData(), in.size()), length);
+        written += length;
+
+        QByteArray out(length, Qt::Uninitialized);
+        QCOMPARE(buffer.read(out.data(), out.size()), length);
+        QCOMPARE(out, stream(read, length));
+        read += length;
+        QVERIFY(buffer.isEmpty());
+    }
+
+    // The same with data left in the buffer between the calls
+    const QByteArray in = stream(written, 10);
+    QCOMPARE(buffer.write(in.constData(), in.size()), qsizetype(10));
+    QByteArray out(7, Qt::Uninitialized);
+    QCOMPARE(buffer.read(out.data(), out.size()), qsizetype(7));
+    QCOMPARE(out, in.left(7));
+    const QByteArray more = stream(written + 10, 12);
+    QCOMPARE(buffer.write(more.constData(), more.size()), qsizetype(12));
+    QCOMPARE(buffer.size(), qsizetype(15));
+
+    out.resize(15);
+    QCOMPARE(buffer.read(out.data(), out.size()), qsizetype(15));
+    QCOMPARE(out, in.mid(7) + more);
+}
+
+void tst_RingBuffer::fullBufferTakesPrefix()
+{
+    RingBuffer buffer(8);
+    const QByteArray in = stream(0, 12);
+    QCOMPARE(buffer.write(in.constData(), in.size()), qsizetype(8));
+    QCOMPARE(buffer.freeSpace(), qsizetype(0));
+    QCOMPARE(buffer.write(in.constData(), 1), qsizetype(0));
+
+    // A read asks for more than there is
+    QByteArray out(32, Qt::Uninitialized);
+    QCOMPARE(buffer.read(out.data(), out.size()), qsizetype(8));
+    QCOMPARE(out.left(8), in.left(8));
+    QCOMPARE(buffer.read(out.data(), out.size()), qsizetype(0));
+}
+
+// The accounting PushReceiver does: whatever write() does not take is
+// counted as dropped, and written plus dropped adds up to what arrived
+void tst_RingBuffer::accountsDroppedBytes()
+{
+    RingBuffer buffer(64);
+    qsizetype arrived = 0;
+    qsizetype accepted = 0;
+    qsizetype dropped = 0;
+    qsizetype consumed = 0;
+    QByteArray expected;
+
+    for (int batch = 0; batch < 50; batch++) {
+        const QByteArray in = stream(arrived, 10 + batch % 40);
+        const qsizetype written = buffer.write(in.constData(), in.size());
+        QCOMPARE(written, qMin(in.size(), buffer.capacity() - (accepted - consumed)));
+        expected.append(in.left(written));
+        arrived += in.size();
+        accepted += written;
+        dropped += in.size() - written;
+
+        // The reader falls behind: it takes less than arrives
+        QByteArray out(20, Qt::Uninitialized);
+        const qsizetype length = buffer.read(out.data(), out.size());
+        QCOMPARE(out.left(length), expected.mid(consumed, length));
+        consumed += length;
+    }
+
+    QVERIFY(dropped > 0);
+    QCOMPARE(accepted + dropped, arrived);
+    QCOMPARE(buffer.size(), accepted - consumed);
+}
+
+void tst_RingBuffer::clearResets()
+{
+    RingBuffer buffer(8);
+    const QByteArray in = stream(0, 6);
+    buffer.write(in.constData(), in.size());
+    buffer.clear();
+    QVERIFY(buffer.isEmpty());
+    QCOMPARE(buffer.freeSpace(), qsizetype(8));
+
+    QCOMPARE(buffer.write(in.constData(), in.size()), qsizetype(6));
+    QByteArray out(6, Qt::Uninitialized);
+    QCOMPARE(buffer.read(out.data(), out.size()), qsizetype(6));
+    QCOMPARE(out, in);
+}
+
+// A writer and a reader thread with random chunk sizes, locked around
+// each call as in PushReceiver. The writer retries what did not fit, so
+// the reader must see the stream unchanged.
+void tst_RingBuffer::twoThreadStress()
+{
+    constexpr qsizetype total = 4 * 1024 * 1024;
+    RingBuffer buffer(4096);
+    QMutex mutex;
+
+    std::unique_ptr<QThread> writer(QThread::create([&]() {
+        QRandomGenerator random(1);
+        qsizetype offset = 0;
+        while (offset < total) {
+            const QByteArray chunk = stream(offset, qMin<qsizetype>(random.bounded(1, 3000), total - offset));
+            qsizetype done = 0;
+            while (done < chunk.size()) {
+                QMutexLocker locker(&mutex);
+                done += buffer.write(chunk.constData() + done, chunk.size() - done);
+                locker.unlock();
+                if (done < chunk.size())
+                    QThread::yieldCurrentThread();
+            }
+            offset += chunk.size();
+        }
+    }));
+    writer->start();
+
+    // Compared after the loop, so that a failure does not leave the
+    // writer waiting on a full buffer
+    QRandomGenerator random(2);
+    qsizetype received = 0;
+    qsizetype mismatches = 0;
+    QByteArray out(3000, Qt::Uninitialized);
+    while (received < total) {
+        qsizetype length;
+        {
+            QMutexLocker locker(&mutex);
+            length = buffer.read(out.data(), random.bounded(1, 3000));
+        }
+        if (length == 0) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        for (qsizetype i = 0; i < length; i++) {
+            if (out[i] != char((received + i) % 251))
+                mismatches++;
+        }
+        received += length;
+    }
+    QVERIFY(writer->wait(10000));
+
+    QCOMPARE(mismatches, qsizetype(0));
+    QCOMPARE(received, total);
+    QVERIFY(buffer.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(tst_RingBuffer)
+
+#include "tst_ringbuffer.moc"
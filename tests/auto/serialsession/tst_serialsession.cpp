@@ -0,0 +1,189 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <atomic>
+
+#include "SerialSession.h"
+#include "SimulatedSerialPort.h"
+
+namespace {
+
+// Opens whenever the simulated line is connected
+class SimulatedDevice : public SerialSession::Device
+{
+public:
+    SimulatedDevice()
+    {
+        SimulatedSerialPort::Profile profile;
+        profile.rateHz = 50;
+        simulation.setProfile(profile);
+        m_clock.start();
+    }
+
+    bool open() override
+    {
+        QMutexLocker locker(&m_mutex);
+        m_attempts.append(m_clock.elapsed());
+        return simulation.isOpen();
+    }
+
+    void close() override { closes++; }
+    AbstractSerialPort *port() override { return &simulation; }
+    QString name() const override { return QStringLiteral("simulated"); }
+
+    // Times of the open() calls, in milliseconds since construction
+    QList<qint64> attempts() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_attempts;
+    }
+
+    SimulatedSerialPort simulation;
+    std::atomic<int> closes { 0 };
+
+private:
+    mutable QMutex m_mutex;
+    QList<qint64> m_attempts;
+    QElapsedTimer m_clock;
+};
+
+} // namespace
+
+class tst_SerialSession : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void reconnectsAndKeepsBuffer();
+    void backoffDoublesUpToMax();
+    void retryNowSkipsBackoff();
+    void closeStopsReconnecting();
+    void failedOpen();
+};
+
+void tst_SerialSession::reconnectsAndKeepsBuffer()
+{
+    SimulatedDevice device;
+    SerialSession session(&device);
+    session.setInitialBackoff(20);
+    session.setMaxBackoff(80);
+    QSignalSpy lost(&session, &SerialSession::connectionLost);
+    QSignalSpy reconnected(&session, &SerialSession::reconnected);
+
+    QVERIFY(session.open());
+    QCOMPARE(session.state(), SerialSession::State::Connected);
+    QTRY_VERIFY(session.bytesReceived() > 0);
+
+    // Unread data stays in the buffer across the reconnect
+    device.simulation.disconnect(500);
+    QTRY_COMPARE(lost.size(), 1);
+    QCOMPARE(session.state(), SerialSession::State::Reconnecting);
+    const qint64 receivedBefore = session.bytesReceived();
+    const qsizetype bufferedBefore = session.bytesAvailable();
+    QCOMPARE(device.closes.load(), 1);
+
+    QTRY_COMPARE_WITH_TIMEOUT(reconnected.size(), 1, 5000);
+    QCOMPARE(session.state(), SerialSession::State::Connected);
+    QCOMPARE(session.reconnectCount(), 1);
+    // The gap covers the outage, plus at most one maximum backoff
+    QVERIFY(session.lastReconnectTime() >= 300);
+    QVERIFY(session.lastReconnectTime() < 500 + 80 + 400);
+    QCOMPARE(reconnected.first().first().toLongLong(), session.lastReconnectTime());
+
+    QTRY_VERIFY(session.bytesReceived() > receivedBefore);
+    QVERIFY(session.bytesAvailable() > bufferedBefore);
+    QVERIFY(session.readAll().size() > bufferedBefore);
+}
+
+void tst_SerialSession::backoffDoublesUpToMax()
+{
+    static constexpr int initialBackoffMs = 20;
+    static constexpr int maxBackoffMs = 160;
+
+    SimulatedDevice device;
+    SerialSession session(&device);
+    session.setInitialBackoff(initialBackoffMs);
+    session.setMaxBackoff(maxBackoffMs);
+    QVERIFY(session.open());
+
+    device.simulation.disconnect();
+    QTRY_COMPARE(session.state(), SerialSession::State::Reconnecting);
+    QTRY_VERIFY_WITH_TIMEOUT(device.attempts().size() >= 8, 5000);
+
+    // The first entry is open(); after that 20, 40, 80, 160, 160, ... ms
+    const QList<qint64> attempts = device.attempts();
+    int expectedMs = initialBackoffMs * 2;
+    for (qsizetype i = 2; i < attempts.size(); i++) {
+        const qint64 delayMs = attempts[i] - attempts[i - 1];
+        QVERIFY2(delayMs >= expectedMs * 9 / 10 && delayMs < expectedMs + 200,
+                 qPrintable(QStringLiteral("attempt %1 after %2 ms, expected %3 ms")
+                                    .arg(i).arg(delayMs).arg(expectedMs)));
+        expectedMs = qMin(expectedMs * 2, maxBackoffMs);
+    }
+    QCOMPARE(session.reconnectCount(), 0);
+}
+
+void tst_SerialSession::retryNowSkipsBackoff()
+{
+    SimulatedDevice device;
+    SerialSession session(&device);
+    session.setInitialBackoff(60 * 1000);
+    session.setMaxBackoff(60 * 1000);
+    QVERIFY(session.open());
+
+    device.simulation.disconnect();
+    QTRY_COMPARE(session.state(), SerialSession::State::Reconnecting);
+
+    // Like an attach broadcast for the device
+    device.simulation.reconnect();
+    QElapsedTimer elapsed;
+    elapsed.start();
+    session.retryNow();
+    QTRY_COMPARE(session.state(), SerialSession::State::Connected);
+    QVERIFY(elapsed.elapsed() < 5000);
+    QCOMPARE(session.reconnectCount(), 1);
+}
+
+void tst_SerialSession::closeStopsReconnecting()
+{
+    SimulatedDevice device;
+    SerialSession session(&device);
+    session.setInitialBackoff(10);
+    session.setMaxBackoff(10);
+    QVERIFY(session.open());
+
+    device.simulation.disconnect();
+    QTRY_VERIFY(device.attempts().size() >= 3);
+    session.close();
+    QCOMPARE(session.state(), SerialSession::State::Closed);
+
+    QTest::qWait(50);
+    const qsizetype attempts = device.attempts().size();
+    device.simulation.reconnect();
+    QTest::qWait(100);
+    QCOMPARE(device.attempts().size(), attempts);
+    QCOMPARE(session.state(), SerialSession::State::Closed);
+}
+
+void tst_SerialSession::failedOpen()
+{
+    SimulatedDevice device;
+    device.simulation.disconnect();
+    SerialSession session(&device);
+    QSignalSpy stateChanged(&session, &SerialSession::stateChanged);
+
+    QVERIFY(!session.open());
+    QCOMPARE(session.state(), SerialSession::State::Closed);
+    QCOMPARE(stateChanged.size(), 0);
+    QTest::qWait(50);
+    QCOMPARE(device.attempts().size(), 1);
+}
+
+QTEST_GUILESS_MAIN(tst_SerialSession)
+
+#include "tst_serialsession.moc"
@@ -0,0 +1,201 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtTest/QTest>
+
+#include <memory>
+
+#include "NmeaParser.h"
+#include "SerialPipeline.h"
+#include "SerialSession.h"
+#include "SimulatedSerialPort.h"
+
+namespace {
+
+// Stands in for a USB adapter that can be unplugged: open() succeeds once
+// the simulated port is connected again
+class SimulatedDevice : public SerialSession::Device
+{
+public:
+    bool open() override { return simulation.isOpen(); }
+    void close() override { }
+    AbstractSerialPort *port() override { return &simulation; }
+    QString name() const override { return QStringLiteral("simulated"); }
+
+    SimulatedSerialPort simulation;
+};
+
+} // namespace
+
+// Runs simulator scripts through the code that consumes the port, so that
+// error injection can be checked end to end
+class tst_SimulatedSerialPort : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void rejectsBadScript();
+    void disconnectUntilReconnect();
+    void timedDisconnect();
+    void pipelineRunsScript();
+    void sessionReconnectsThroughScript();
+
+private:
+    static bool readUntilClosed(SimulatedSerialPort &port);
+};
+
+// The simulation advances when the port is read
+bool tst_SimulatedSerialPort::readUntilClosed(SimulatedSerialPort &port)
+{
+    port.readData(64 * 1024, 10);
+    return !port.isOpen();
+}
+
+void tst_SimulatedSerialPort::rejectsBadScript()
+{
+    SimulatedSerialPort port;
+    QVERIFY(!port.loadScript(QStringLiteral("profile nmea\n")));
+    QVERIFY(!port.loadScript(QStringLiteral("disconnect -1\n")));
+    QVERIFY(!port.loadScript(QStringLiteral("explode 10\n")));
+    QVERIFY(port.loadScript(QStringLiteral("disconnect 0 # until reconnect\n")));
+}
+
+void tst_SimulatedSerialPort::disconnectUntilReconnect()
+{
+    SimulatedSerialPort port;
+    QVERIFY(port.loadScript(QStringLiteral("profile nmea 50\n"
+                                           "wait 100\n"
+                                           "disconnect 0\n"
+                                           "profile none\n")));
+    QVERIFY(port.isOpen());
+    QTRY_VERIFY(readUntilClosed(port));
+
+    // Stays down, as disconnect(0) does, and the script waits with it
+    QTest::qWait(300);
+    QVERIFY(port.readData(1024, 0).isEmpty());
+    QVERIFY(!port.isOpen());
+
+    port.reconnect();
+    QVERIFY(port.isOpen());
+    // The script went on to the silent profile
+    QTest::qWait(100);
+    QVERIFY(port.readData(64 * 1024, 0).isEmpty());
+    QCOMPARE(port.stats().disconnects, qint64(1));
+}
+
+void tst_SimulatedSerialPort::timedDisconnect()
+{
+    SimulatedSerialPort port;
+    QVERIFY(port.loadScript(QStringLiteral("disconnect 200\n")));
+    QVERIFY(!port.isOpen());
+    QTRY_VERIFY_WITH_TIMEOUT(port.isOpen(), 1000);
+}
+
+void tst_SimulatedSerialPort::pipelineRunsScript()
+{
+    SimulatedSerialPort port;
+    QVERIFY(port.loadScript(QStringLiteral("profile nmea 50\n"
+                                           "checksum-errors 0.5\n"
+                                           "wait 400\n"
+                                           "dropout 200\n"
+                                           "checksum-errors 0\n"
+                                           "wait 200\n"
+                                           "disconnect 0\n"
+                                           "profile nmea 50\n")));
+
+    SerialPipeline pipeline;
+    SerialPipeline::Config config;
+    config.readTimeoutMs = 20;
+    pipeline.setConfig(config);
+    pipeline.addPort(&port, std::make_unique<NmeaParser>());
+
+    qint64 frames = 0;
+    qint64 checksumErrors = 0;
+    connect(&pipeline, &SerialPipeline::framesReady, this,
+            [&](int, const QList<SerialFrame> &batch, int errors) {
+                frames += batch.size();
+                checksumErrors += errors;
+            });
+
+    pipeline.start();
+    QTRY_VERIFY_WITH_TIMEOUT(!port.isOpen(), 2000);
+    // Let the pipeline deliver what it read before the disconnect
+    QTest::qWait(200);
+    QVERIFY(frames > 0);
+    QVERIFY(checksumErrors > 0);
+
+    const qint64 framesBeforeReconnect = frames;
+    QTest::qWait(300);
+    QCOMPARE(frames, framesBeforeReconnect);
+
+    port.reconnect();
+    QTRY_VERIFY_WITH_TIMEOUT(frames > framesBeforeReconnect, 2000);
+    pipeline.stop();
+
+    const SimulatedSerialPort::Stats stats = port.stats();
+    QCOMPARE(stats.dropouts, qint64(1));
+    QCOMPARE(stats.disconnects, qint64(1));
+    QCOMPARE(pipeline.readerStats(0).bytesDropped, qint64(0));
+}
+
+// The session keeps the pipeline fed across scripted disconnects, both
+// ones that end by themselves and one that waits for the device to be
+// plugged in again
+void tst_SimulatedSerialPort::sessionReconnectsThroughScript()
+{
+    SimulatedDevice device;
+    QVERIFY(device.simulation.loadScript(QStringLiteral("profile nmea 50\n"
+                                                        "wait 300\n"
+                                                        "disconnect 300\n"
+                                                        "wait 300\n"
+                                                        "disconnect 0\n"
+                                                        "wait 300\n")));
+
+    SerialSession session(&device);
+    session.setInitialBackoff(20);
+    session.setMaxBackoff(100);
+    QVERIFY(session.open());
+
+    SerialPipeline pipeline;
+    SerialPipeline::Config config;
+    config.readTimeoutMs = 20;
+    pipeline.setConfig(config);
+    pipeline.addPort(&session, std::make_unique<NmeaParser>());
+
+    qint64 frames = 0;
+    qint64 checksumErrors = 0;
+    connect(&pipeline, &SerialPipeline::framesReady, this,
+            [&](int, const QList<SerialFrame> &batch, int errors) {
+                frames += batch.size();
+                checksumErrors += errors;
+            });
+    pipeline.start();
+
+    QTRY_COMPARE_WITH_TIMEOUT(session.reconnectCount(), 1, 3000);
+    QVERIFY(frames > 0);
+    QVERIFY(session.lastReconnectTime() >= 200);
+
+    // Data flows again until the second disconnect, which lasts
+    const qint64 framesAfterFirstReconnect = frames;
+    QTRY_VERIFY_WITH_TIMEOUT(frames > framesAfterFirstReconnect, 2000);
+    QTRY_COMPARE_WITH_TIMEOUT(session.state(), SerialSession::State::Reconnecting, 3000);
+    QTest::qWait(300);
+    QCOMPARE(session.reconnectCount(), 1);
+
+    const qint64 framesBeforeReplug = frames;
+    device.simulation.reconnect();
+    session.retryNow();
+    QTRY_COMPARE_WITH_TIMEOUT(session.reconnectCount(), 2, 2000);
+    QTRY_VERIFY_WITH_TIMEOUT(frames > framesBeforeReplug, 2000);
+    // The pipeline's port never closed
+    QVERIFY(session.isOpen());
+    pipeline.stop();
+
+    QCOMPARE(device.simulation.stats().disconnects, qint64(2));
+    QCOMPARE(checksumErrors, qint64(0));
+    QCOMPARE(pipeline.readerStats(0).bytesDropped, qint64(0));
+}
+
+QTEST_GUILESS_MAIN(tst_SimulatedSerialPort)
+
+#include "tst_simulatedserialport.moc"
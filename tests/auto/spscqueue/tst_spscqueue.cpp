@@ -0,0 +1,116 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtCore/QThread>
+#include <QtTest/QTest>
+
+#include <memory>
+
+#include "SpscQueue.h"
+
+class tst_SpscQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundsCapacityUp();
+    void emptyQueue();
+    void fullQueue();
+    void wrapsAround();
+    void wrapsAcrossThreads();
+};
+
+void tst_SpscQueue::roundsCapacityUp()
+{
+    QCOMPARE(SpscQueue<int>(1).capacity(), std::size_t(1));
+    QCOMPARE(SpscQueue<int>(5).capacity(), std::size_t(8));
+    QCOMPARE(SpscQueue<int>(64).capacity(), std::size_t(64));
+}
+
+void tst_SpscQueue::emptyQueue()
+{
+    SpscQueue<int> queue(4);
+    int value = 42;
+    QVERIFY(!queue.tryPop(value));
+    QCOMPARE(value, 42);
+    QCOMPARE(queue.size(), std::size_t(0));
+
+    QVERIFY(queue.tryPush(1));
+    QVERIFY(queue.tryPop(value));
+    QCOMPARE(value, 1);
+    QVERIFY(!queue.tryPop(value));
+}
+
+void tst_SpscQueue::fullQueue()
+{
+    SpscQueue<QByteArray> queue(4);
+    for (int i = 0; i < 4; i++)
+        QVERIFY(queue.tryPush(QByteArray::number(i)));
+    QCOMPARE(queue.size(), std::size_t(4));
+
+    // A rejected value stays with the producer
+    QByteArray rejected("rejected");
+    QVERIFY(!queue.tryPush(std::move(rejected)));
+    QCOMPARE(rejected, QByteArray("rejected"));
+
+    QByteArray value;
+    QVERIFY(queue.tryPop(value));
+    QCOMPARE(value, QByteArray("0"));
+    QVERIFY(queue.tryPush(std::move(rejected)));
+    QVERIFY(!queue.tryPush(QByteArray("5")));
+}
+
+// The indices run past the capacity many times over
+void tst_SpscQueue::wrapsAround()
+{
+    SpscQueue<int> queue(4);
+    int expected = 0;
+    for (int i = 0; i < 1000; i++) {
+        QVERIFY(queue.tryPush(int(i)));
+        if (i % 3 == 2) {
+            int value = -1;
+            while (queue.tryPop(value))
+                QCOMPARE(value, expected++);
+        }
+    }
+    int value = -1;
+    while (queue.tryPop(value))
+        QCOMPARE(value, expected++);
+    QCOMPARE(expected, 1000);
+}
+
+void tst_SpscQueue::wrapsAcrossThreads()
+{
+    constexpr int count = 1000000;
+    SpscQueue<int> queue(16);
+
+    std::unique_ptr<QThread> producer(QThread::create([&queue]() {
+        for (int i = 0; i < count; i++) {
+            while (!queue.tryPush(int(i)))
+                QThread::yieldCurrentThread();
+        }
+    }));
+    producer->start();
+
+    // Compared after the loop, so that a failure does not leave the
+    // producer spinning on a full queue
+    int received = 0;
+    int outOfOrder = 0;
+    while (received < count) {
+        int value = -1;
+        if (!queue.tryPop(value)) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        if (value != received)
+            outOfOrder++;
+        received++;
+    }
+    QVERIFY(producer->wait(10000));
+
+    QCOMPARE(outOfOrder, 0);
+    QCOMPARE(queue.size(), std::size_t(0));
+}
+
+QTEST_GUILESS_MAIN(tst_SpscQueue)
+#include "tst_spscqueue.moc"
@@ -0,0 +1,361 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+#include <QtTest/QTest>
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+
+#include "UsbFsTransport.h"
+
+namespace {
+
+// usbfs without a kernel: submitted URBs wait until the test completes
+// them, and bulk writes are answered from a list of scripted results
+class FakeUsbFs : public UsbFs
+{
+public:
+    int submitUrb(int, usbdevfs_urb *urb) override
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_gone)
+            return -ENODEV;
+        m_submitted.append(urb);
+        return 0;
+    }
+
+    int discardUrb(int, usbdevfs_urb *urb) override
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_submitted.removeOne(urb))
+            return -EINVAL;
+        urb->status = -ENOENT;
+        urb->actual_length = 0;
+        completeLocked(urb);
+        return 0;
+    }
+
+    int reapUrb(int, usbdevfs_urb **urb, int timeoutMs) override
+    {
+        const QDeadlineTimer deadline = timeoutMs < 0 ? QDeadlineTimer(QDeadlineTimer::Forever)
+                                                      : QDeadlineTimer(timeoutMs);
+        QMutexLocker locker(&m_mutex);
+        while (m_completed.isEmpty()) {
+            if (m_gone)
+                return -ENODEV;
+            if (!m_changed.wait(&m_mutex, deadline))
+                return -ETIMEDOUT;
+        }
+        *urb = m_completed.takeFirst();
+        return 0;
+    }
+
+    int bulkTransfer(int, unsigned, void *data, unsigned length, unsigned) override
+    {
+        QMutexLocker locker(&m_mutex);
+        const int result = m_writeResults.isEmpty() ? int(length) : m_writeResults.takeFirst();
+        if (result > 0)
+            m_written.append(static_cast<const char *>(data), qMin(result, int(length)));
+        return qMin(result, int(length));
+    }
+
+    int clearHalt(int, unsigned endpoint) override
+    {
+        QMutexLocker locker(&m_mutex);
+        m_clearedHalts.append(endpoint);
+        return m_gone ? -ENODEV : clearHaltResult;
+    }
+
+    // Completes the oldest submitted URB with data from the device
+    bool receive(const QByteArray &data, int status = 0)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_submitted.isEmpty())
+            return false;
+        usbdevfs_urb *urb = m_submitted.takeFirst();
+        const int length = qMin(int(data.size()), urb->buffer_length);
+        memcpy(urb->buffer, data.constData(), size_t(length));
+        urb->actual_length = length;
+        urb->status = status;
+        completeLocked(urb);
+        return true;
+    }
+
+    // As the kernel does when the adapter is unplugged
+    void unplug()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_gone = true;
+        while (!m_submitted.isEmpty()) {
+            usbdevfs_urb *urb = m_submitted.takeFirst();
+            urb->status = -ESHUTDOWN;
+            urb->actual_length = 0;
+            m_completed.append(urb);
+        }
+        m_changed.wakeAll();
+    }
+
+    void setWriteResults(const QList<int> &results)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_writeResults = results;
+    }
+
+    qsizetype submittedCount() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_submitted.size();
+    }
+
+    QByteArray written() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_written;
+    }
+
+    QList<unsigned> clearedHalts() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_clearedHalts;
+    }
+
+    int clearHaltResult = 0;
+
+private:
+    void completeLocked(usbdevfs_urb *urb)
+    {
+        m_completed.append(urb);
+        m_changed.wakeAll();
+    }
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_changed;
+    QList<usbdevfs_urb *> m_submitted;
+    QList<usbdevfs_urb *> m_completed;
+    QList<int> m_writeResults;
+    QByteArray m_written;
+    QList<unsigned> m_clearedHalts;
+    bool m_gone = false;
+};
+
+constexpr int fd = 42;
+constexpr unsigned inEndpoint = 0x81;
+constexpr unsigned outEndpoint = 0x02;
+
+UsbFsTransport::Endpoints endpoints()
+{
+    UsbFsTransport::Endpoints endpoints;
+    endpoints.in = inEndpoint;
+    endpoints.out = outEndpoint;
+    return endpoints;
+}
+
+} // namespace
+
+class tst_UsbFsTransport : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void keepsUrbsQueued();
+    void partialReads();
+    void partialWrites();
+    void closeDuringRead();
+    void deviceGoneWhileReading();
+    void deviceGoneWhileWriting();
+    void readStallClearsHalt();
+    void writeStallClearsHalt();
+    void writeStallIsBounded();
+    void failedClearHaltFailsWrite();
+};
+
+void tst_UsbFsTransport::keepsUrbsQueued()
+{
+    FakeUsbFs usbFs;
+    UsbFsTransport transport(fd, endpoints(), UsbFsTransport::PacketFormat::Raw, &usbFs);
+    QVERIFY(transport.start());
+    const qsizetype queued = usbFs.submittedCount();
+    QVERIFY(queued > 1);
+
+    QVERIFY(usbFs.receive("abc"));
+    QCOMPARE(transport.read(1024, 100), QByteArray("abc"));
+    // The URB went back to the endpoint before the data was handed out
+    QCOMPARE(usbFs.submittedCount(), queued);
+
+    // Zero-length transfers are resubmitted without ending the read
+    QVERIFY(usbFs.receive(QByteArray()));
+    QVERIFY(transport.read(1024, 50).isEmpty());
+    QCOMPARE(usbFs.submittedCount(), queued);
+    QVERIFY(transport.isRunning());
+}
+
+void tst_UsbFsTransport::partialReads()
+{
+    FakeUsbFs usbFs;
+    UsbFsTransport transport(fd, endpoints(), UsbFsTransport::PacketFormat::Raw, &usbFs);
+    QVERIFY(transport.start());
+
+    QByteArray sent;
+    for (int i = 0; i < 100; i++)
+        sent.append(char(i));
+    QVERIFY(usbFs.receive(sent.left(60)));
+    QVERIFY(usbFs.receive(sent.mid(60)));
+
+    // Every read hands out at most maxLength, the rest stays pending
+    QByteArray received;
+    while (received.size() < sent.size()) {
+        const QByteArray data = transport.read(25, 100);
+        QVERIFY(!data.isEmpty());
+        QVERIFY(data.size() <= 25);
+        received.append(data);
+    }
+    QCOMPARE(received, sent);
+    QCOMPARE(transport.stats().bytesRead, qint64(sent.size()));
+    QVERIFY(transport.read(25, 20).isEmpty());
+}
+
+void tst_UsbFsTransport::partialWrites()
+{
+    FakeUsbFs usbFs;
+    UsbFsTransport transport(fd, endpoints(), UsbFsTransport::PacketFormat::Raw, &usbFs);
+    QVERIFY(transport.start());
+
+    // The device takes a few bytes at a time
+    usbFs.setWriteResults({ 3, 1, 5, 64 });
+    const QByteArray data("0123456789abcdefghijklmnopqrstuvwxyz");
+    QVERIFY(transport.write(data, 1000));
+    QCOMPARE(usbFs.written(), data);
+    QCOMPARE(transport.stats().bytesWritten, qint64(data.size()));
+}
+
+void tst_UsbFsTransport::closeDuringRead()
+{
+    FakeUsbFs usbFs;
+    UsbFsTransport transport(fd, endpoints(), UsbFsTransport::PacketFormat::Raw, &usbFs);
+    QVERIFY(transport.start());
+
+    QByteArray data("not empty");
+    std::unique_ptr<QThread> reader(QThread::create([&]() {
+        // A timeout of 0 waits forever
+        data = transport.read(1024, 0);
+    }));
+    reader->start();
+    QTest::qWait(50);
+    QVERIFY(reader->isRunning());
+
+    transport.close();
+    QVERIFY(reader->wait(2000));
+    QVERIFY(data.isEmpty());
+    QVERIFY(!transport.isRunning());
+    // All URBs were discarded and reaped, so the fd may be closed now
+    QCOMPARE(usbFs.submittedCount(), 0);
+    QVERIFY(!transport.write("late", 100));
+}
+
+void tst_UsbFsTransport::deviceGoneWhileReading()
+{
+    FakeUsbFs usbFs;
+    UsbFsTransport transport(fd, endpoints(), UsbFsTransport::PacketFormat::Raw, &usbFs);
+    QVERIFY(transport.start());
+
+    QVERIFY(usbFs.receive("last"));
+    usbFs.unplug();
+
+    // What arrived before is still handed out
+    QCOMPARE(transport.read(1024, 100), QByteArray("last"));
+    QVERIFY(transport.read(1024, 100).isEmpty());
+    QVERIFY(!transport.isRunning());
+    QVERIFY(!transport.write("x", 100));
+    transport.close();
+}
+
+void tst_UsbFsTransport::deviceGoneWhileWriting()
+{
+    FakeUsbFs usbFs;
+    UsbFsTransport transport(fd, endpoints(), UsbFsTransport::PacketFormat::Raw, &usbFs);
+    QVERIFY(transport.start());
+
+    usbFs.setWriteResults({ 4, -ENODEV });
+    QVERIFY(!transport.write("0123456789", 1000));
+    QVERIFY(!transport.isRunning());
+    QCOMPARE(transport.stats().errors, qint64(1));
+    QCOMPARE(transport.stats().bytesWritten, qint64(4));
+}
+
+void tst_UsbFsTransport::readStallClearsHalt()
+{
+    FakeUsbFs usbFs;
+    UsbFsTransport transport(fd, endpoints(), UsbFsTransport::PacketFormat::Raw, &usbFs);
+    QVERIFY(transport.start());
+    const qsizetype queued = usbFs.submittedCount();
+
+    QVERIFY(usbFs.receive(QByteArray(), -EPIPE));
+    QVERIFY(usbFs.receive("after"));
+    QCOMPARE(transport.read(1024, 100), QByteArray("after"));
+    QCOMPARE(usbFs.clearedHalts(), QList<unsigned>({ inEndpoint }));
+    QCOMPARE(transport.stats().stalls, qint64(1));
+    QCOMPARE(usbFs.submittedCount(), queued);
+
+    // An endpoint that cannot be cleared would only stall again
+    usbFs.clearHaltResult = -EIO;
+    QVERIFY(usbFs.receive(QByteArray(), -EPIPE));
+    QVERIFY(transport.read(1024, 100).isEmpty());
+    QVERIFY(!transport.isRunning());
+}
+
+void tst_UsbFsTransport::writeStallClearsHalt()
+{
+    FakeUsbFs usbFs;
+    UsbFsTransport transport(fd, endpoints(), UsbFsTransport::PacketFormat::Raw, &usbFs);
+    QVERIFY(transport.start());
+
+    // Each chunk that makes progress may stall once more
+    usbFs.setWriteResults({ -EPIPE, 2, -EPIPE, -EPIPE, 2, -EPIPE });
+    QVERIFY(transport.write("abcdef", 1000));
+    QCOMPARE(usbFs.written(), QByteArray("abcdef"));
+    QCOMPARE(usbFs.clearedHalts(),
+             QList<unsigned>({ outEndpoint, outEndpoint, outEndpoint, outEndpoint }));
+    QCOMPARE(transport.stats().stalls, qint64(4));
+    QVERIFY(transport.isRunning());
+}
+
+void tst_UsbFsTransport::writeStallIsBounded()
+{
+    FakeUsbFs usbFs;
+    UsbFsTransport transport(fd, endpoints(), UsbFsTransport::PacketFormat::Raw, &usbFs);
+    QVERIFY(transport.start());
+
+    QList<int> results;
+    for (int i = 0; i < 100; i++)
+        results.append(-EPIPE);
+    usbFs.setWriteResults(results);
+
+    QVERIFY(!transport.write("abc", 0));
+    QVERIFY(usbFs.clearedHalts().size() < 10);
+    QVERIFY(usbFs.written().isEmpty());
+    QCOMPARE(transport.stats().errors, qint64(1));
+}
+
+void tst_UsbFsTransport::failedClearHaltFailsWrite()
+{
+    FakeUsbFs usbFs;
+    UsbFsTransport transport(fd, endpoints(), UsbFsTransport::PacketFormat::Raw, &usbFs);
+    QVERIFY(transport.start());
+
+    usbFs.clearHaltResult = -EIO;
+    usbFs.setWriteResults({ -EPIPE, 3 });
+    QVERIFY(!transport.write("abc", 1000));
+    QCOMPARE(usbFs.clearedHalts().size(), 1);
+    QVERIFY(usbFs.written().isEmpty());
+    QCOMPARE(transport.stats().errors, qint64(1));
+}
+
+QTEST_GUILESS_MAIN(tst_UsbFsTransport)
+
+#include "tst_usbfstransport.moc"
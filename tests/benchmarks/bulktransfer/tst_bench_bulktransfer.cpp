@@ -0,0 +1,170 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtCore/QBuffer>
+#include <QtCore/QtEndian>
+#include <QtTest/QTest>
+
+#include "BulkTransfer.h"
+#include "SimulatedSerialPort.h"
+
+namespace {
+
+// A logger protocol in the style of the IGC download commands:
+//   request  'G' index:u32
+//   reply    STX index:u32 length:u16 payload xor-checksum
+constexpr char requestTag = 'G';
+constexpr char replyTag = 0x02;
+constexpr qsizetype requestSize = 5;
+constexpr qsizetype replyHeaderSize = 7;
+
+QByteArray blockPayload(quint32 index, int blockSize)
+{
+    QByteArray payload(blockSize, Qt::Uninitialized);
+    for (int i = 0; i < blockSize; i++)
+        payload[i] = char((index * 31 + i) & 0xff);
+    return payload;
+}
+
+class LoggerProtocol : public BlockProtocol
+{
+public:
+    QByteArray blockRequest(quint32 index) const override
+    {
+        QByteArray request(requestSize, Qt::Uninitialized);
+        request[0] = requestTag;
+        qToBigEndian(index, request.data() + 1);
+        return request;
+    }
+
+    ParseStatus parse(QByteArray &buffer, Block &block) const override
+    {
+        if (buffer.isEmpty())
+            return ParseStatus::NeedMoreData;
+        if (buffer[0] != replyTag) {
+            buffer.remove(0, 1);
+            return ParseStatus::Corrupt;
+        }
+        if (buffer.size() < replyHeaderSize)
+            return ParseStatus::NeedMoreData;
+
+        const quint16 length = qFromBigEndian<quint16>(buffer.constData() + 5);
+        if (buffer.size() < replyHeaderSize + length + 1)
+            return ParseStatus::NeedMoreData;
+
+        char checksum = 0;
+        for (qsizetype i = replyHeaderSize; i < replyHeaderSize + length; i++)
+            checksum ^= buffer[i];
+        if (checksum != buffer[replyHeaderSize + length]) {
+            buffer.remove(0, 1);
+            return ParseStatus::Corrupt;
+        }
+
+        block.index = qFromBigEndian<quint32>(buffer.constData() + 1);
+        block.payload = buffer.mid(replyHeaderSize, length);
+        buffer.remove(0, replyHeaderSize + length + 1);
+        return ParseStatus::Block;
+    }
+};
+
+// The device side: answers every complete request in a write
+QByteArray loggerReply(const QByteArray &written, int blockSize)
+{
+    QByteArray reply;
+    for (qsizetype at = 0; at + requestSize <= written.size(); at += requestSize) {
+        if (written[at] != requestTag)
+            continue;
+        const quint32 index = qFromBigEndian<quint32>(written.constData() + at + 1);
+        const QByteArray payload = blockPayload(index, blockSize);
+
+        char header[replyHeaderSize];
+        header[0] = replyTag;
+        qToBigEndian(index, header + 1);
+        qToBigEndian(quint16(blockSize), header + 5);
+        char checksum = 0;
+        for (const char c : payload)
+            checksum ^= c;
+
+        reply.append(header, replyHeaderSize);
+        reply.append(payload);
+        reply.append(checksum);
+    }
+    return reply;
+}
+
+} // namespace
+
+// Transfer rate of BulkTransfer against a simulated logger, by window size.
+// With a window of one the transfer is stop-and-wait and pays the device's
+// response latency for every block; larger windows hide it until the line
+// rate is the limit.
+class tst_BenchBulkTransfer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void windowSize_data();
+    void windowSize();
+};
+
+void tst_BenchBulkTransfer::windowSize_data()
+{
+    QTest::addColumn<int>("windowSize");
+    QTest::addColumn<int>("latencyMs");
+
+    for (const int latencyMs : { 5, 20 }) {
+        for (const int windowSize : { 1, 2, 4, 8, 16, 32 })
+            QTest::addRow("window %d, latency %d ms", windowSize, latencyMs)
+                << windowSize << latencyMs;
+    }
+}
+
+void tst_BenchBulkTransfer::windowSize()
+{
+    QFETCH(int, windowSize);
+    QFETCH(int, latencyMs);
+
+    static constexpr int baudRate = 921600;
+    static constexpr int blockSize = 512;
+    static constexpr quint32 blockCount = 64;
+
+    SimulatedSerialPort port;
+    SimulatedSerialPort::Profile silent;
+    silent.traffic = SimulatedSerialPort::Traffic::None;
+    port.setProfile(silent);
+    // Drop what the default profile sent before it was replaced
+    port.readData(64 * 1024, 0);
+    port.setBaudRate(baudRate);
+    port.setResponder([](const QByteArray &written) { return loggerReply(written, blockSize); },
+                      latencyMs);
+
+    LoggerProtocol protocol;
+    BulkTransfer transfer(&protocol);
+    transfer.setWindowSize(windowSize);
+
+    QByteArray downloaded;
+    QBuffer output(&downloaded);
+    QVERIFY(output.open(QIODevice::WriteOnly));
+
+    BulkTransfer::Result result = BulkTransfer::Result::Failed;
+    QBENCHMARK_ONCE {
+        result = transfer.run(&port, &output, blockCount);
+    }
+    QCOMPARE(result, BulkTransfer::Result::Completed);
+
+    QByteArray expected;
+    for (quint32 index = 0; index < blockCount; index++)
+        expected.append(blockPayload(index, blockSize));
+    QCOMPARE(downloaded, expected);
+
+    const BulkTransfer::Stats stats = transfer.stats();
+    const double bytesPerSecond = stats.elapsedMs > 0
+            ? double(stats.bytesWritten) * 1000 / double(stats.elapsedMs)
+            : 0;
+    qInfo("window %2d, latency %2d ms: %.1f KiB/s, %d requests, %d retransmits",
+          windowSize, latencyMs, bytesPerSecond / 1024, stats.requests, stats.retransmits);
+}
+
+QTEST_GUILESS_MAIN(tst_BenchBulkTransfer)
+
+#include "tst_bench_bulktransfer.moc"
@@ -0,0 +1,100 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtTest/QTest>
+
+#include <cstring>
+
+#include "FtdiPackets.h"
+
+namespace {
+
+enum class Method {
+    CopyOnly,
+    MemmovePerPacket,
+    StripStatus
+};
+
+constexpr int urbSize = 16 * 1024;
+
+// The straightforward loop stripStatus() is measured against
+qsizetype memmovePerPacket(char *data, qsizetype length, int packetSize)
+{
+    qsizetype payloadLength = 0;
+    for (qsizetype packet = 0; packet < length; packet += packetSize) {
+        const qsizetype packetLength = qMin<qsizetype>(packetSize, length - packet);
+        if (packetLength < FtdiPackets::statusSize)
+            break;
+        const qsizetype payload = packetLength - FtdiPackets::statusSize;
+        std::memmove(data + payloadLength, data + packet + FtdiPackets::statusSize, size_t(payload));
+        payloadLength += payload;
+    }
+    return payloadLength;
+}
+
+} // namespace
+
+Q_DECLARE_METATYPE(Method)
+
+// Time to strip the status bytes from one full 16 KiB URB. Every
+// iteration first restores the URB from a pristine copy; the CopyOnly rows
+// measure that copy, to be subtracted from the others.
+class tst_BenchFtdiPackets : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void stripUrb_data();
+    void stripUrb();
+};
+
+void tst_BenchFtdiPackets::stripUrb_data()
+{
+    QTest::addColumn<int>("packetSize");
+    QTest::addColumn<Method>("method");
+
+    for (const int packetSize : { 64, 512 }) {
+        QTest::addRow("%d bytes, copy only", packetSize) << packetSize << Method::CopyOnly;
+        QTest::addRow("%d bytes, memmove per packet", packetSize)
+            << packetSize << Method::MemmovePerPacket;
+        QTest::addRow("%d bytes, stripStatus", packetSize) << packetSize << Method::StripStatus;
+    }
+}
+
+void tst_BenchFtdiPackets::stripUrb()
+{
+    QFETCH(int, packetSize);
+    QFETCH(Method, method);
+
+    QByteArray pristine(urbSize, Qt::Uninitialized);
+    for (int i = 0; i < urbSize; i++)
+        pristine[i] = char(i % 251);
+    QByteArray urb(urbSize, Qt::Uninitialized);
+
+    FtdiPackets::LineStatus status;
+    qsizetype length = 0;
+    QBENCHMARK {
+        std::memcpy(urb.data(), pristine.constData(), urbSize);
+        switch (method) {
+        case Method::CopyOnly:
+            length = urbSize;
+            break;
+        case Method::MemmovePerPacket:
+            length = memmovePerPacket(urb.data(), urbSize, packetSize);
+            break;
+        case Method::StripStatus:
+            length = FtdiPackets::stripStatus(urb.data(), urbSize, packetSize, status);
+            break;
+        }
+    }
+
+    // Keeps the compiler from dropping the work, and checks it
+    if (method != Method::CopyOnly) {
+        QCOMPARE(length, qsizetype(urbSize / packetSize * (packetSize - FtdiPackets::statusSize)));
+        QCOMPARE(urb.at(length - 1), pristine.at(urbSize - 1));
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_BenchFtdiPackets)
+
+#include "tst_bench_ftdipackets.moc"
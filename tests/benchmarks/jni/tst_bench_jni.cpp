@@ -0,0 +1,225 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtTest/QTest>
+
+#include <jni.h>
+
+#include "JavaPortIo.h"
+
+namespace {
+
+// The ways of moving serial data through JNI on the raw JNIEnv. The ones
+// going through QJniObject and the generated proxies need Qt's Android
+// plugin and stay in JniBenchmark.cpp, which runs on a device.
+enum class Variant {
+    // A cached jmethodID and a new byte[] per call
+    CachedId,
+    // A cached jmethodID and one byte[] kept across calls
+    ReusedArray,
+    // Reads into a direct ByteBuffer over native memory
+    DirectBuffer,
+    // What UsbSerialHelper::readData() and writeData() call
+    JavaPortIo
+};
+
+const QList<int> payloadSizes = { 64, 512, 4096, 16384 };
+
+} // namespace
+
+Q_DECLARE_METATYPE(Variant)
+
+// Time per call of JniBenchmarkPort.java, which mimics UsbSerialPort
+// without doing I/O, on a JVM the benchmark starts itself. HotSpot is not
+// ART, so the numbers compare the variants rather than predict a device.
+// Every call is checked for a pending exception, as the app does; a
+// timing of calls that threw would be meaningless.
+class tst_BenchJni : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void read_data();
+    void read();
+    void write_data();
+    void write();
+
+private:
+    bool threw();
+
+    JavaVM *m_vm = nullptr;
+    JNIEnv *m_env = nullptr;
+    jobject m_port = nullptr;
+    jmethodID m_read = nullptr;
+    jmethodID m_write = nullptr;
+    jmethodID m_readDirect = nullptr;
+};
+
+void tst_BenchJni::initTestCase()
+{
+    char classPath[] = "-Djava.class.path=" QTJENNY_BENCHMARK_CLASSPATH;
+    JavaVMOption option;
+    option.optionString = classPath;
+    option.extraInfo = nullptr;
+
+    JavaVMInitArgs args;
+    args.version = JNI_VERSION_1_8;
+    args.nOptions = 1;
+    args.options = &option;
+    args.ignoreUnrecognized = JNI_FALSE;
+    void *env = nullptr;
+    QCOMPARE(JNI_CreateJavaVM(&m_vm, &env, &args), JNI_OK);
+    m_env = static_cast<JNIEnv *>(env);
+
+    jclass portClass = m_env->FindClass("org/qtproject/example/appqtjenny_consumer/JniBenchmarkPort");
+    QVERIFY2(portClass, "JniBenchmarkPort.class is not on the class path");
+    m_read = m_env->GetMethodID(portClass, "read", "([BI)I");
+    m_write = m_env->GetMethodID(portClass, "write", "([BI)V");
+    m_readDirect = m_env->GetMethodID(portClass, "readDirect", "(Ljava/nio/ByteBuffer;I)I");
+    const jmethodID constructor = m_env->GetMethodID(portClass, "<init>", "()V");
+    QVERIFY(m_read && m_write && m_readDirect && constructor);
+
+    jobject port = m_env->NewObject(portClass, constructor);
+    QVERIFY(!threw());
+    m_port = m_env->NewGlobalRef(port);
+    m_env->DeleteLocalRef(port);
+    m_env->DeleteLocalRef(portClass);
+}
+
+void tst_BenchJni::cleanupTestCase()
+{
+    if (!m_vm)
+        return;
+    if (m_port)
+        m_env->DeleteGlobalRef(m_port);
+    m_vm->DestroyJavaVM();
+}
+
+void tst_BenchJni::read_data()
+{
+    QTest::addColumn<int>("payloadBytes");
+    QTest::addColumn<Variant>("variant");
+
+    for (const int size : payloadSizes) {
+        QTest::addRow("%d bytes, cached id", size) << size << Variant::CachedId;
+        QTest::addRow("%d bytes, reused array", size) << size << Variant::ReusedArray;
+        QTest::addRow("%d bytes, direct buffer", size) << size << Variant::DirectBuffer;
+        QTest::addRow("%d bytes, JavaPortIo", size) << size << Variant::JavaPortIo;
+    }
+}
+
+void tst_BenchJni::read()
+{
+    QFETCH(int, payloadBytes);
+    QFETCH(Variant, variant);
+
+    QByteArray data(payloadBytes, Qt::Uninitialized);
+    jbyteArray reused = m_env->NewByteArray(payloadBytes);
+    jobject direct = m_env->NewDirectByteBuffer(data.data(), payloadBytes);
+    qsizetype length = 0;
+
+    QBENCHMARK {
+        switch (variant) {
+        case Variant::CachedId: {
+            jbyteArray buffer = m_env->NewByteArray(payloadBytes);
+            length = m_env->CallIntMethod(m_port, m_read, buffer, 0);
+            if (threw()) {
+                m_env->DeleteLocalRef(buffer);
+                QFAIL("read() threw");
+            }
+            m_env->GetByteArrayRegion(buffer, 0, jsize(length), reinterpret_cast<jbyte *>(data.data()));
+            m_env->DeleteLocalRef(buffer);
+            break;
+        }
+        case Variant::ReusedArray:
+            length = m_env->CallIntMethod(m_port, m_read, reused, 0);
+            if (threw())
+                QFAIL("read() threw");
+            m_env->GetByteArrayRegion(reused, 0, jsize(length), reinterpret_cast<jbyte *>(data.data()));
+            break;
+        case Variant::DirectBuffer:
+            length = m_env->CallIntMethod(m_port, m_readDirect, direct, payloadBytes);
+            if (threw())
+                QFAIL("readDirect() threw");
+            break;
+        case Variant::JavaPortIo: {
+            bool failed = false;
+            length = JavaPortIo::read(m_env, m_port, m_read, payloadBytes, 0, failed).size();
+            if (failed)
+                QFAIL("read() threw");
+            break;
+        }
+        }
+    }
+
+    m_env->DeleteLocalRef(direct);
+    m_env->DeleteLocalRef(reused);
+    QCOMPARE(length, qsizetype(payloadBytes));
+}
+
+void tst_BenchJni::write_data()
+{
+    QTest::addColumn<int>("payloadBytes");
+    QTest::addColumn<Variant>("variant");
+
+    for (const int size : payloadSizes) {
+        QTest::addRow("%d bytes, cached id", size) << size << Variant::CachedId;
+        QTest::addRow("%d bytes, reused array", size) << size << Variant::ReusedArray;
+        QTest::addRow("%d bytes, JavaPortIo", size) << size << Variant::JavaPortIo;
+    }
+}
+
+void tst_BenchJni::write()
+{
+    QFETCH(int, payloadBytes);
+    QFETCH(Variant, variant);
+
+    const QByteArray data(payloadBytes, 'x');
+    const jbyte *bytes = reinterpret_cast<const jbyte *>(data.constData());
+    jbyteArray reused = m_env->NewByteArray(payloadBytes);
+
+    QBENCHMARK {
+        switch (variant) {
+        case Variant::CachedId: {
+            jbyteArray buffer = m_env->NewByteArray(payloadBytes);
+            m_env->SetByteArrayRegion(buffer, 0, payloadBytes, bytes);
+            m_env->CallVoidMethod(m_port, m_write, buffer, 0);
+            m_env->DeleteLocalRef(buffer);
+            if (threw())
+                QFAIL("write() threw");
+            break;
+        }
+        case Variant::ReusedArray:
+            m_env->SetByteArrayRegion(reused, 0, payloadBytes, bytes);
+            m_env->CallVoidMethod(m_port, m_write, reused, 0);
+            if (threw())
+                QFAIL("write() threw");
+            break;
+        case Variant::DirectBuffer:
+            // JniBenchmarkPort has no direct-buffer write
+            break;
+        case Variant::JavaPortIo:
+            if (!JavaPortIo::write(m_env, m_port, m_write, data, 0))
+                QFAIL("write() threw");
+            break;
+        }
+    }
+
+    m_env->DeleteLocalRef(reused);
+}
+
+// Describes and clears a pending exception
+bool tst_BenchJni::threw()
+{
+    if (!m_env->ExceptionCheck())
+        return false;
+    m_env->ExceptionDescribe();
+    m_env->ExceptionClear();
+    return true;
+}
+
+QTEST_GUILESS_MAIN(tst_BenchJni)
+
+#include "tst_bench_jni.moc"
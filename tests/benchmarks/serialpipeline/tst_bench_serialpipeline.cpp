@@ -0,0 +1,237 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtTest/QTest>
+
+#include <memory>
+#include <time.h>
+#include <vector>
+
+#include "NmeaParser.h"
+#include "SerialPipeline.h"
+#include "SimulatedSerialPort.h"
+
+namespace {
+
+qint64 processCpuUs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return qint64(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+QByteArray nmeaSentence(const QByteArray &body)
+{
+    quint8 checksum = 0;
+    for (const char c : body)
+        checksum ^= quint8(c);
+    return '$' + body + '*' + QByteArray::number(checksum, 16).rightJustified(2, '0').toUpper()
+            + "\r\n";
+}
+
+// A port that always has data: every read returns a full chunk of valid
+// NMEA at once, so the pipeline runs as fast as its threads allow
+class SaturatingPort : public AbstractSerialPort
+{
+public:
+    SaturatingPort()
+    {
+        const QByteArray sentences =
+                nmeaSentence("GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W")
+                + nmeaSentence("GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,")
+                + nmeaSentence("PFLAA,0,-1234,1234,220,2,DD8F12,180,,30,-1.4,1");
+        while (m_data.size() < 64 * 1024)
+            m_data.append(sentences);
+    }
+
+    bool isOpen() const override { return true; }
+
+    QByteArray readData(int maxLength = 1024, int = 1000) override
+    {
+        // Continues where the last read stopped, so that sentences split
+        // across reads are completed by the next one
+        const qsizetype length = qMin<qsizetype>(maxLength, m_data.size() - m_offset);
+        QByteArray data = m_data.mid(m_offset, length);
+        m_offset = (m_offset + length) % m_data.size();
+        return data;
+    }
+
+    bool writeData(const QByteArray &, int = 1000) override { return false; }
+    int baudRate() const override { return 0; }
+    bool setBaudRate(int) override { return false; }
+
+private:
+    QByteArray m_data;
+    qsizetype m_offset = 0;
+};
+
+void addPortRows()
+{
+    QTest::addColumn<int>("portCount");
+    QTest::addColumn<int>("parserThreads");
+
+    for (const int parserThreads : { 0, 4 }) {
+        for (const int portCount : { 1, 2, 4, 8, 16, 32 }) {
+            if (parserThreads == 0)
+                QTest::addRow("%d ports, thread per port", portCount) << portCount << 0;
+            else
+                QTest::addRow("%d ports, pool of %d", portCount, parserThreads)
+                    << portCount << parserThreads;
+        }
+    }
+}
+
+} // namespace
+
+// Throughput, latency and CPU of SerialPipeline by number of ports, with one
+// parser thread per port and with a shared parser pool. Every port is a
+// simulated receiver sending NMEA at a high rate.
+//
+// saturated() replaces the receivers with ports that always have data, so
+// the reader and parser threads never wait on the line. It reports the
+// bytes that made it through the parse stage per second of wall time and
+// per second of CPU time, i.e. per busy core.
+class tst_BenchSerialPipeline : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void ports_data();
+    void ports();
+    void saturated_data();
+    void saturated();
+};
+
+void tst_BenchSerialPipeline::ports_data()
+{
+    addPortRows();
+}
+
+void tst_BenchSerialPipeline::ports()
+{
+    QFETCH(int, portCount);
+    QFETCH(int, parserThreads);
+
+    static constexpr int runMs = 2000;
+    static constexpr int baudRate = 921600;
+    static constexpr double sentencesPerSecond = 500;
+
+    SimulatedSerialPort::Profile profile;
+    profile.traffic = SimulatedSerialPort::Traffic::Nmea;
+    profile.rateHz = sentencesPerSecond;
+
+    std::vector<std::unique_ptr<SimulatedSerialPort>> ports;
+    SerialPipeline pipeline;
+    SerialPipeline::Config config;
+    config.parserThreads = parserThreads;
+    pipeline.setConfig(config);
+
+    for (int i = 0; i < portCount; i++) {
+        auto port = std::make_unique<SimulatedSerialPort>(quint32(i + 1));
+        port->setBaudRate(baudRate);
+        port->setProfile(profile);
+        pipeline.addPort(port.get(), std::make_unique<NmeaParser>());
+        ports.push_back(std::move(port));
+    }
+
+    qint64 frames = 0;
+    qint64 checksumErrors = 0;
+    connect(&pipeline, &SerialPipeline::framesReady, this,
+            [&](int, const QList<SerialFrame> &batch, int errors) {
+                frames += batch.size();
+                checksumErrors += errors;
+            });
+
+    const qint64 cpuStartUs = processCpuUs();
+    QBENCHMARK_ONCE {
+        pipeline.start();
+        QTest::qWait(runMs);
+        pipeline.stop();
+    }
+    const qint64 cpuUs = processCpuUs() - cpuStartUs;
+
+    qint64 maxLatencyUs = 0;
+    qint64 bytesRead = 0;
+    qint64 bytesDropped = 0;
+    for (int i = 0; i < portCount; i++) {
+        const SerialPipeline::StageStats deliver =
+                pipeline.stageStats(i, SerialPipeline::Stage::Deliver);
+        const SerialPipeline::ReaderStats reader = pipeline.readerStats(i);
+        maxLatencyUs = qMax(maxLatencyUs, deliver.maxLatencyUs);
+        bytesRead += reader.bytesRead;
+        bytesDropped += reader.bytesDropped;
+    }
+    QVERIFY(frames > 0);
+
+    qInfo("%2d ports, %s: %.0f frames/s, max latency %.1f ms, %lld bytes dropped, "
+          "%lld checksum errors, CPU %.1f%%, %.1f ms CPU/MB",
+          portCount, parserThreads ? "pool" : "threads",
+          double(frames) * 1000 / runMs, double(maxLatencyUs) / 1000, bytesDropped,
+          checksumErrors,
+          double(cpuUs) * 100 / (runMs * 1000),
+          bytesRead > 0 ? double(cpuUs) / 1000 / (double(bytesRead) / (1024 * 1024)) : 0.0);
+}
+
+void tst_BenchSerialPipeline::saturated_data()
+{
+    addPortRows();
+}
+
+void tst_BenchSerialPipeline::saturated()
+{
+    QFETCH(int, portCount);
+    QFETCH(int, parserThreads);
+
+    static constexpr int runMs = 2000;
+
+    std::vector<std::unique_ptr<SaturatingPort>> ports;
+    SerialPipeline pipeline;
+    SerialPipeline::Config config;
+    config.parserThreads = parserThreads;
+    pipeline.setConfig(config);
+
+    for (int i = 0; i < portCount; i++) {
+        ports.push_back(std::make_unique<SaturatingPort>());
+        pipeline.addPort(ports.back().get(), std::make_unique<NmeaParser>());
+    }
+
+    qint64 frames = 0;
+    qint64 checksumErrors = 0;
+    connect(&pipeline, &SerialPipeline::framesReady, this,
+            [&](int, const QList<SerialFrame> &batch, int errors) {
+                frames += batch.size();
+                checksumErrors += errors;
+            });
+
+    const qint64 cpuStartUs = processCpuUs();
+    QBENCHMARK_ONCE {
+        pipeline.start();
+        QTest::qWait(runMs);
+        pipeline.stop();
+    }
+    const qint64 cpuUs = processCpuUs() - cpuStartUs;
+
+    // Dropped bytes never reached a parser
+    qint64 bytesParsed = 0;
+    qint64 bytesDropped = 0;
+    for (int i = 0; i < portCount; i++) {
+        const SerialPipeline::ReaderStats reader = pipeline.readerStats(i);
+        bytesParsed += reader.bytesRead - reader.bytesDropped;
+        bytesDropped += reader.bytesDropped;
+    }
+    QVERIFY(frames > 0);
+    // Only sentences cut off by a drop fail
+    QVERIFY(bytesDropped > 0 || checksumErrors == 0);
+
+    const double mib = double(bytesParsed) / (1024 * 1024);
+    const double busyCores = double(cpuUs) / (runMs * 1000);
+    qInfo("%2d ports, %s: %.1f MiB/s parsed, %.1f busy cores, %.1f MiB/s per busy core, "
+          "%.0f frames/s delivered, %.1f MiB dropped",
+          portCount, parserThreads ? "pool" : "threads",
+          mib * 1000 / runMs, busyCores, busyCores > 0 ? mib * 1000 / runMs / busyCores : 0.0,
+          double(frames) * 1000 / runMs, double(bytesDropped) / (1024 * 1024));
+}
+
+QTEST_GUILESS_MAIN(tst_BenchSerialPipeline)
+
+#include "tst_bench_serialpipeline.moc"
@@ -0,0 +1,158 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtCore/QElapsedTimer>
+#include <QtTest/QTest>
+
+#include <memory>
+#include <vector>
+
+#include "NmeaParser.h"
+#include "PortWatchdog.h"
+#include "SerialPipeline.h"
+#include "SerialSession.h"
+#include "SimulatedSerialPort.h"
+
+namespace {
+
+class SimulatedDevice : public SerialSession::Device
+{
+public:
+    explicit SimulatedDevice(quint32 seed) : simulation(seed) { }
+
+    bool open() override { return simulation.isOpen(); }
+    void close() override { }
+    AbstractSerialPort *port() override { return &simulation; }
+    QString name() const override { return QStringLiteral("simulated"); }
+
+    SimulatedSerialPort simulation;
+};
+
+// A receiver that changes traffic, corrupts sentences, goes silent and is
+// unplugged, over and over. The first wait differs per port, so that the
+// ports do not disconnect in lockstep.
+QString soakScript(int port)
+{
+    return QStringLiteral("wait %1\n"
+                          "profile nmea 20\n"
+                          "checksum-errors 0.01\n"
+                          "wait 5000\n"
+                          "profile flarm 10\n"
+                          "dropout 1000\n"
+                          "wait 4000\n"
+                          "disconnect 2000\n"
+                          "profile gdl90 5\n"
+                          "checksum-errors 0\n"
+                          "wait 3000\n"
+                          "profile nmea 20\n"
+                          "repeat\n")
+            .arg(port * 397);
+}
+
+int environmentInt(const char *name, int defaultValue)
+{
+    bool ok = false;
+    const int value = qEnvironmentVariableIntValue(name, &ok);
+    return ok && value > 0 ? value : defaultValue;
+}
+
+} // namespace
+
+// Runs SerialSession, SerialPipeline and PortWatchdog against scripted
+// receivers for a long time, and prints their state every ten seconds.
+// Not run by ctest; set QTJENNY_SOAK_SECONDS (default 60) to soak for
+// hours and QTJENNY_SOAK_PORTS (default 8) for the number of receivers.
+class tst_BenchSoak : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sessions();
+};
+
+void tst_BenchSoak::sessions()
+{
+    const int runSeconds = environmentInt("QTJENNY_SOAK_SECONDS", 60);
+    const int portCount = environmentInt("QTJENNY_SOAK_PORTS", 8);
+    static constexpr int reportIntervalMs = 10000;
+
+    std::vector<std::unique_ptr<SimulatedDevice>> devices;
+    std::vector<std::unique_ptr<SerialSession>> sessions;
+    std::vector<std::unique_ptr<PortWatchdog>> watchdogs;
+    SerialPipeline pipeline;
+    SerialPipeline::Config config;
+    config.parserThreads = 4;
+    pipeline.setConfig(config);
+
+    qint64 stalls = 0;
+    qint64 errorBursts = 0;
+    for (int i = 0; i < portCount; i++) {
+        auto device = std::make_unique<SimulatedDevice>(quint32(i + 1));
+        QVERIFY(device->simulation.loadScript(soakScript(i)));
+
+        auto session = std::make_unique<SerialSession>(device.get());
+        session->setMaxBackoff(1000);
+        QVERIFY(session->open());
+
+        // The scripted dropouts are shorter than the stall timeout
+        auto watchdog = std::make_unique<PortWatchdog>(session.get());
+        connect(watchdog.get(), &PortWatchdog::stallDetected, this, [&stalls]() { stalls++; });
+        connect(watchdog.get(), &PortWatchdog::errorBurstDetected, this,
+                [&errorBursts]() { errorBursts++; });
+
+        pipeline.addPort(session.get(), std::make_unique<NmeaParser>());
+        devices.push_back(std::move(device));
+        sessions.push_back(std::move(session));
+        watchdogs.push_back(std::move(watchdog));
+    }
+
+    qint64 frames = 0;
+    qint64 checksumErrors = 0;
+    connect(&pipeline, &SerialPipeline::framesReady, this,
+            [&](int port, const QList<SerialFrame> &batch, int errors) {
+                frames += batch.size();
+                checksumErrors += errors;
+                watchdogs[port]->reportFrames(batch.size(), errors);
+            });
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    pipeline.start();
+    while (elapsed.elapsed() < qint64(runSeconds) * 1000) {
+        QTest::qWait(int(qMin<qint64>(reportIntervalMs, qint64(runSeconds) * 1000 - elapsed.elapsed())));
+
+        int reconnects = 0;
+        int connected = 0;
+        qint64 maxLatencyUs = 0;
+        qint64 bytesDropped = 0;
+        for (int i = 0; i < portCount; i++) {
+            reconnects += sessions[i]->reconnectCount();
+            if (sessions[i]->state() == SerialSession::State::Connected)
+                connected++;
+            maxLatencyUs = qMax(maxLatencyUs,
+                                pipeline.stageStats(i, SerialPipeline::Stage::Deliver).maxLatencyUs);
+            bytesDropped += pipeline.readerStats(i).bytesDropped;
+        }
+        qInfo("%5llds: %lld frames, %lld checksum errors, %d/%d connected, %d reconnects, "
+              "%lld stalls, %lld error bursts, max latency %.1f ms, %lld bytes dropped",
+              elapsed.elapsed() / 1000, frames, checksumErrors, connected, portCount, reconnects,
+              stalls, errorBursts, double(maxLatencyUs) / 1000, bytesDropped);
+    }
+    pipeline.stop();
+
+    QVERIFY(frames > 0);
+    for (int i = 0; i < portCount; i++) {
+        // Every disconnect but one still running was recovered from
+        const qint64 disconnects = devices[i]->simulation.stats().disconnects;
+        QVERIFY2(sessions[i]->reconnectCount() >= disconnects - 1,
+                 qPrintable(QStringLiteral("port %1: %2 reconnects after %3 disconnects")
+                                    .arg(i)
+                                    .arg(sessions[i]->reconnectCount())
+                                    .arg(disconnects)));
+        QCOMPARE(pipeline.readerStats(i).bytesDropped, qint64(0));
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_BenchSoak)
+
+#include "tst_bench_soak.moc"
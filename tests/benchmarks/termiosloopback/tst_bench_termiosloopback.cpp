@@ -0,0 +1,234 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <QtTest/QTest>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "EpollReactor.h"
+#include "IoReactor.h"
+#include "TermiosSerialPort.h"
+#include "UringReactor.h"
+
+namespace {
+
+enum class Mode {
+    Polling,
+    Epoll,
+    Uring
+};
+
+const char *modeName(Mode mode)
+{
+    switch (mode) {
+    case Mode::Polling: return "polling";
+    case Mode::Epoll: return "epoll";
+    case Mode::Uring: return "io_uring";
+    }
+    return "";
+}
+
+char patternByte(qint64 offset)
+{
+    return char((offset * 7 + offset / 251) & 0xff);
+}
+
+qint64 processCpuUs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return qint64(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+// The master side of a pty stands in for the device
+struct Pty {
+    int master = -1;
+    QString slavePath;
+
+    ~Pty()
+    {
+        if (master >= 0)
+            ::close(master);
+    }
+
+    bool open()
+    {
+        master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+            return false;
+        char name[128];
+        if (ptsname_r(master, name, sizeof(name)) != 0)
+            return false;
+        slavePath = QString::fromLocal8Bit(name);
+        return true;
+    }
+};
+
+// Writes bytesPerPort of the pattern to every master, as fast as the ptys
+// take it
+void writeAll(const std::vector<std::unique_ptr<Pty>> &ptys, qint64 bytesPerPort)
+{
+    static constexpr qsizetype blockSize = 1024;
+    std::vector<qint64> written(ptys.size(), 0);
+    std::vector<pollfd> pfds(ptys.size());
+    char block[blockSize];
+
+    for (;;) {
+        bool done = true;
+        bool progress = false;
+        for (std::size_t i = 0; i < ptys.size(); i++) {
+            pfds[i] = { -1, POLLOUT, 0 };
+            if (written[i] == bytesPerPort)
+                continue;
+            done = false;
+
+            const qsizetype size = qsizetype(qMin<qint64>(blockSize, bytesPerPort - written[i]));
+            for (qsizetype j = 0; j < size; j++)
+                block[j] = patternByte(written[i] + j);
+            const ssize_t bytes = ::write(ptys[i]->master, block, size_t(size));
+            if (bytes > 0) {
+                written[i] += bytes;
+                progress = true;
+            } else if (bytes < 0 && errno != EAGAIN && errno != EINTR) {
+                return;
+            } else {
+                pfds[i].fd = ptys[i]->master;
+            }
+        }
+        if (done)
+            return;
+        if (!progress)
+            poll(pfds.data(), nfds_t(pfds.size()), 100);
+    }
+}
+
+} // namespace
+
+Q_DECLARE_METATYPE(Mode)
+
+// Receive throughput and CPU cost of TermiosSerialPort over pty pairs, by
+// number of ports: each port polling its own fd on its reader thread, and
+// all ports served by one epoll or io_uring reactor thread. For the
+// reactors, the syscalls and the CPU time of the reactor thread per MiB
+// are reported as well.
+class tst_BenchTermiosLoopback : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void ports_data();
+    void ports();
+};
+
+void tst_BenchTermiosLoopback::ports_data()
+{
+    QTest::addColumn<Mode>("mode");
+    QTest::addColumn<int>("portCount");
+
+    for (const int portCount : { 1, 4, 16, 32 }) {
+        for (const Mode mode : { Mode::Polling, Mode::Epoll, Mode::Uring })
+            QTest::addRow("%d ports, %s", portCount, modeName(mode)) << mode << portCount;
+    }
+}
+
+void tst_BenchTermiosLoopback::ports()
+{
+    QFETCH(Mode, mode);
+    QFETCH(int, portCount);
+
+    static constexpr qint64 bytesPerPort = 1024 * 1024;
+    static constexpr int timeoutMs = 30000;
+
+    std::unique_ptr<IoReactor> reactor;
+    if (mode == Mode::Epoll)
+        reactor = std::make_unique<EpollReactor>();
+    else if (mode == Mode::Uring)
+        reactor = std::make_unique<UringReactor>();
+    if (reactor) {
+        if (mode == Mode::Uring && !reactor->isValid())
+            QSKIP("io_uring is not available");
+        QVERIFY(reactor->isValid());
+        reactor->start();
+    }
+
+    std::vector<std::unique_ptr<Pty>> ptys;
+    std::vector<std::unique_ptr<TermiosSerialPort>> ports;
+    for (int i = 0; i < portCount; i++) {
+        auto pty = std::make_unique<Pty>();
+        if (!pty->open())
+            QSKIP("No ptys available");
+        auto port = std::make_unique<TermiosSerialPort>(reactor.get());
+        QVERIFY(port->open(pty->slavePath, 921600));
+        ptys.push_back(std::move(pty));
+        ports.push_back(std::move(port));
+    }
+
+    std::atomic<qint64> received { 0 };
+    std::atomic<qint64> corrupt { 0 };
+    std::vector<std::unique_ptr<QThread>> readers;
+    QElapsedTimer timer;
+
+    const qint64 cpuStartUs = processCpuUs();
+    QBENCHMARK_ONCE {
+        timer.start();
+        for (const auto &port : ports) {
+            readers.emplace_back(QThread::create([&received, &corrupt, &timer, port = port.get()]() {
+                qint64 offset = 0;
+                while (offset < bytesPerPort && !timer.hasExpired(timeoutMs)) {
+                    const QByteArray data = port->readData(4096, 100);
+                    for (const char c : data) {
+                        if (c != patternByte(offset))
+                            corrupt.fetch_add(1, std::memory_order_relaxed);
+                        offset++;
+                    }
+                }
+                received.fetch_add(offset, std::memory_order_relaxed);
+            }));
+            readers.back()->start();
+        }
+        writeAll(ptys, bytesPerPort);
+        for (const auto &reader : readers)
+            reader->wait();
+    }
+    const qint64 elapsedMs = timer.elapsed();
+    const qint64 cpuUs = processCpuUs() - cpuStartUs;
+
+    for (const auto &port : ports)
+        port->close();
+    if (reactor)
+        reactor->stop();
+
+    QCOMPARE(received.load(), bytesPerPort * portCount);
+    QCOMPARE(corrupt.load(), qint64(0));
+
+    const double megabytes = double(bytesPerPort) * portCount / (1024 * 1024);
+    const double mibPerSecond = elapsedMs > 0 ? megabytes * 1000 / double(elapsedMs) : 0.0;
+    if (!reactor) {
+        qInfo("%2d ports, %s: %.1f MiB/s, %.1f ms CPU/MiB", portCount, modeName(mode),
+              mibPerSecond, double(cpuUs) / 1000 / megabytes);
+        return;
+    }
+
+    const IoReactor::Stats stats = reactor->stats();
+    QCOMPARE(stats.bytesDropped, qint64(0));
+    qInfo("%2d ports, %s: %.1f MiB/s, %.1f ms CPU/MiB; reactor: %.0f syscalls/MiB, "
+          "%.0f wakeups/MiB, %.2f ms CPU/MiB",
+          portCount, modeName(mode), mibPerSecond, double(cpuUs) / 1000 / megabytes,
+          double(stats.syscalls) / megabytes, double(stats.wakeups) / megabytes,
+          double(stats.cpuTimeNs) / 1000000 / megabytes);
+}
+
+QTEST_GUILESS_MAIN(tst_BenchTermiosLoopback)
+
+#include "tst_bench_termiosloopback.moc"